@@ -0,0 +1,136 @@
+#!/bin/bash
+# Boot-Zeitaufschlüsselung für den Schnellstart (start_qemu_rt.sh --fast-boot)
+# Wertet das Konsolen-Log aus (jede Zeile mit Host-Zeitstempel) und die darin ausgegebenen
+# Kernel-Meldungen (initcall_debug, Zeitmarken des Init-Skripts, erste RT-Aufweckung).
+# Die Kennzahlen werden an eine CSV-Historie angehängt und mit dem letzten Lauf desselben
+# Kernels verglichen, um Regressionen der Zeit bis zur ersten RT-Aufgabe zu erkennen.
+#
+# Verwendung: ./boot_time_report.sh <boot.log> [historie.csv]
+#   TOP_INITCALLS=10    Anzahl der langsamsten Initcalls in der Ausgabe
+#   REGRESSION_PCT=10   Warnschwelle in Prozent
+
+LOG="$1"
+HISTORY="$2"
+TOP_INITCALLS="${TOP_INITCALLS:-10}"
+REGRESSION_PCT="${REGRESSION_PCT:-10}"
+
+if [ ! -f "$LOG" ]; then
+    echo "Verwendung: $0 <boot.log> [historie.csv]"
+    exit 1
+fi
+
+INITCALLS=$(mktemp)
+trap 'rm -f "$INITCALLS"' EXIT
+
+# Kennzahlen als key=value, Initcalls (usecs name) in eine eigene Datei
+eval "$(tr -d '\r' < "$LOG" | awk -v initcalls="$INITCALLS" '
+    {
+        host = $1
+        sub(/^[^ ]+ /, "")
+    }
+    /^fastboot host qemu_start/ { host_start = host; next }
+    host_start != "" && host_first == "" && NF > 0 { host_first = host }
+    /^fastboot marker init/ { host_init = host }
+    /^fastboot marker rt_done/ { host_rt_done = host }
+    /^fastboot dmesg begin/ { in_dmesg = 1; next }
+    /^fastboot dmesg end/ { in_dmesg = 0; next }
+    in_dmesg && match($0, /^\[ *[0-9]+\.[0-9]+\]/) {
+        t = substr($0, 2, RLENGTH - 2) + 0
+        msg = substr($0, RLENGTH + 2)
+        if (msg ~ /^Linux version /) { split(msg, v, " "); kernel = v[3] }
+        if (msg ~ /^Run \/init as init process/) run_init = t
+        if (msg ~ /^Freeing unused kernel memory/ && free_mem == "") free_mem = t
+        if (msg ~ /^initcall .* returned .* after [0-9]+ usecs/) {
+            n = split(msg, f, " ")
+            usecs = f[n - 1]
+            name = f[2]
+            sub(/\+0x.*/, "", name)
+            initcall_sum += usecs
+            initcall_count++
+            print usecs, name > initcalls
+        }
+        if (msg ~ /^fastboot: stage /) { split(msg, s, " "); stage[s[3]] = t }
+        if (msg ~ /^rt_latency: first RT wakeup/) first_rt = t
+    }
+    END {
+        printf "KERNEL=%s\n", kernel != "" ? kernel : "unbekannt"
+        printf "RUN_INIT=%s\nFREE_MEM=%s\nFIRST_RT=%s\n", run_init, free_mem, first_rt
+        printf "STAGE_INIT=%s\nSTAGE_MOUNTS=%s\nSTAGE_RT_START=%s\nSTAGE_RT_DONE=%s\n", \
+            stage["init"], stage["mounts"], stage["rt_start"], stage["rt_done"]
+        printf "INITCALL_SUM=%.6f\nINITCALL_COUNT=%d\n", initcall_sum / 1e6, initcall_count
+        if (host_start != "") {
+            if (host_first != "") printf "HOST_FIRST=%.3f\n", host_first - host_start
+            if (host_init != "") printf "HOST_INIT=%.3f\n", host_init - host_start
+            if (host_rt_done != "") printf "HOST_RT_DONE=%.3f\n", host_rt_done - host_start
+        }
+    }')"
+
+if [ -z "$RUN_INIT" ]; then
+    echo "✗ Keine Kernel-Meldungen im Log gefunden (Boot fehlgeschlagen?): $LOG"
+    exit 1
+fi
+
+# Zeile "Bezeichnung  Zeitpunkt  (+Abstand zur vorherigen Phase)"
+PREV=0
+phase() {
+    local label="$1"
+    local t="$2"
+    if [ -z "$t" ]; then
+        printf "  %-38s %10s\n" "$label" "-"
+        return
+    fi
+    awk -v l="$label" -v t="$t" -v p="$PREV" 'BEGIN { printf "  %-38s %8.3f s  (+%7.1f ms)\n", l, t, (t - p) * 1000 }'
+    PREV="$t"
+}
+
+echo ""
+echo "=== Boot-Zeitaufschlüsselung ==="
+echo "Kernel: $KERNEL"
+echo "Log: $LOG"
+echo ""
+echo "Gast (Kernel-Zeitstempel seit Kernel-Start):"
+phase "Initcalls fertig, Init-Speicher frei" "$FREE_MEM"
+phase "/init gestartet" "$RUN_INIT"
+phase "Init-Skript gestartet" "$STAGE_INIT"
+phase "Dateisysteme gemountet" "$STAGE_MOUNTS"
+phase "RT-Aufgabe gestartet" "$STAGE_RT_START"
+phase "Erste RT-Aufweckung" "$FIRST_RT"
+awk -v s="$INITCALL_SUM" -v n="$INITCALL_COUNT" 'BEGIN { printf "  %-38s %8.3f s  (%d Aufrufe)\n", "davon Initcalls gesamt", s, n }'
+
+if [ -s "$INITCALLS" ]; then
+    echo ""
+    echo "Langsamste Initcalls:"
+    sort -rn "$INITCALLS" | head -n "$TOP_INITCALLS" | awk '{ printf "  %8.1f ms  %s\n", $1 / 1000, $2 }'
+fi
+
+if [ -n "$HOST_INIT" ]; then
+    echo ""
+    echo "Host (Wanduhr ab QEMU-Start, inkl. Emulation):"
+    printf "  %-38s %8s s\n" "Erste Konsolenausgabe" "${HOST_FIRST:--}"
+    printf "  %-38s %8s s\n" "Init-Skript gestartet" "$HOST_INIT"
+    printf "  %-38s %8s s\n" "RT-Messung beendet" "${HOST_RT_DONE:--}"
+fi
+
+# Historie fortschreiben und mit dem letzten Lauf desselben Kernels vergleichen
+if [ -n "$HISTORY" ]; then
+    if [ ! -f "$HISTORY" ]; then
+        echo "datum,kernel,run_init_s,first_rt_s,initcalls_s,host_init_s" > "$HISTORY"
+    fi
+    PREVIOUS=$(awk -F, -v k="$KERNEL" '$2 == k { line = $0 } END { print line }' "$HISTORY")
+    echo "$(date +%Y-%m-%dT%H:%M:%S),$KERNEL,$RUN_INIT,$FIRST_RT,$INITCALL_SUM,$HOST_INIT" >> "$HISTORY"
+
+    if [ -n "$PREVIOUS" ] && [ -n "$FIRST_RT" ]; then
+        echo ""
+        echo "Vergleich mit vorherigem Lauf ($(echo "$PREVIOUS" | cut -d, -f1)):"
+        echo "$PREVIOUS" | awk -F, -v cur="$FIRST_RT" -v init="$RUN_INIT" -v pct="$REGRESSION_PCT" '{
+            printf "  /init gestartet:      %8.3f s → %8.3f s\n", $3, init
+            printf "  Erste RT-Aufweckung:  %8.3f s → %8.3f s\n", $4, cur
+            if ($4 > 0 && cur > $4 * (1 + pct / 100))
+                printf "  ⚠ Regression: Zeit bis zur ersten RT-Aufgabe +%.1f %%\n", (cur / $4 - 1) * 100
+            else
+                print "  ✓ Keine Regression"
+        }'
+    fi
+    echo ""
+    echo "Historie: $HISTORY"
+fi
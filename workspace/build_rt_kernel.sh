@@ -17,6 +17,11 @@ INSTALL_DIR="$WORK_DIR/install"
 CROSS_COMPILE="aarch64-linux-gnu-"
 ARCH="arm64"
 JOBS=$(nproc)
+# Gespeicherte Konfiguration; gebaut wird out-of-tree über den Build-Cache (kernel_build_cache.sh)
+BASE_DEFCONFIG="defconfig"
+RT_CONFIG="$WORK_DIR/rt.config"
+CONFIG_STAGE="$WORK_DIR/config_stage"
+SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
 
 # Verzeichnisse erstellen
 mkdir -p "$WORK_DIR"
@@ -45,147 +50,155 @@ cd "$KERNEL_DIR"
 export ARCH="$ARCH"
 export CROSS_COMPILE="$CROSS_COMPILE"
 
+# Ältere Builds haben in-tree konfiguriert; O=-Builds verlangen einen sauberen Quellbaum
+if [ -f ".config" ]; then
+    if [ ! -f "$RT_CONFIG" ]; then
+        echo "Übernehme vorhandene In-Tree-Konfiguration nach $RT_CONFIG..."
+        cp .config "$RT_CONFIG"
+    fi
+    make mrproper
+fi
+
+kconfig() {
+    scripts/config --file "$CONFIG_STAGE/.config" "$@"
+}
+
 # Basis-Konfiguration für Raspberry Pi 5
-if [ ! -f ".config" ]; then
+if [ ! -f "$RT_CONFIG" ]; then
     echo "Erstelle Basis-Konfiguration für Raspberry Pi 5..."
-    make defconfig
+    rm -rf "$CONFIG_STAGE"
+    make O="$CONFIG_STAGE" $BASE_DEFCONFIG
     
     # Raspberry Pi 5 spezifische Konfiguration
     echo "Aktiviere Raspberry Pi 5 spezifische Optionen..."
     
     # BCM2712 (Raspberry Pi 5) Support
-    scripts/config --enable CONFIG_ARCH_BCM2835
-    scripts/config --enable CONFIG_ARCH_BCM
-    scripts/config --enable CONFIG_ARCH_BCM2835
-    scripts/config --enable CONFIG_BCM2835_MBOX
-    scripts/config --enable CONFIG_BCM2835_WDT
-    scripts/config --enable CONFIG_BCM2835_POWER
-    scripts/config --enable CONFIG_BCM2835_THERMAL
+    kconfig --enable CONFIG_ARCH_BCM2835
+    kconfig --enable CONFIG_ARCH_BCM
+    kconfig --enable CONFIG_ARCH_BCM2835
+    kconfig --enable CONFIG_BCM2835_MBOX
+    kconfig --enable CONFIG_BCM2835_WDT
+    kconfig --enable CONFIG_BCM2835_POWER
+    kconfig --enable CONFIG_BCM2835_THERMAL
     
     # PREEMPT_RT Konfiguration (seit Linux 6.12 im Mainline-Kernel)
     echo "Aktiviere PREEMPT_RT Optionen (Mainline seit 6.12)..."
     
     # Prüfe zunächst, ob CONFIG_PREEMPT_RT verfügbar ist
-    if scripts/config --enable CONFIG_PREEMPT_RT 2>/dev/null; then
+    if kconfig --enable CONFIG_PREEMPT_RT 2>/dev/null; then
         echo "  ✓ CONFIG_PREEMPT_RT verfügbar - aktiviere RT-Modus"
         
         # Setze Preemption Model auf RT
-        scripts/config --disable CONFIG_PREEMPT_NONE
-        scripts/config --disable CONFIG_PREEMPT_VOLUNTARY
-        scripts/config --disable CONFIG_PREEMPT
-        scripts/config --enable CONFIG_PREEMPT_RT
+        kconfig --disable CONFIG_PREEMPT_NONE
+        kconfig --disable CONFIG_PREEMPT_VOLUNTARY
+        kconfig --disable CONFIG_PREEMPT
+        kconfig --enable CONFIG_PREEMPT_RT
     else
         echo "  ⚠ CONFIG_PREEMPT_RT nicht verfügbar - verwende besten verfügbaren Preemption-Modus"
         
         # Fallback: Verwende PREEMPT für bessere Responsivität
-        scripts/config --disable CONFIG_PREEMPT_NONE
-        scripts/config --disable CONFIG_PREEMPT_VOLUNTARY
-        scripts/config --enable CONFIG_PREEMPT
+        kconfig --disable CONFIG_PREEMPT_NONE
+        kconfig --disable CONFIG_PREEMPT_VOLUNTARY
+        kconfig --enable CONFIG_PREEMPT
     fi
     
     # RT-Subsystem-Konfiguration (diese sind meist verfügbar)
-    scripts/config --enable CONFIG_PREEMPT_RCU
-    scripts/config --enable CONFIG_RCU_BOOST
-    scripts/config --enable CONFIG_HIGH_RES_TIMERS
-    scripts/config --enable CONFIG_NO_HZ_FULL
-    scripts/config --enable CONFIG_NO_HZ_IDLE
-    scripts/config --enable CONFIG_HRTIMER_STACKTRACE
+    kconfig --enable CONFIG_PREEMPT_RCU
+    kconfig --enable CONFIG_RCU_BOOST
+    kconfig --enable CONFIG_HIGH_RES_TIMERS
+    kconfig --enable CONFIG_NO_HZ_FULL
+    kconfig --enable CONFIG_NO_HZ_IDLE
+    kconfig --enable CONFIG_HRTIMER_STACKTRACE
     
     # Weitere Real-Time relevante Optionen
-    scripts/config --enable CONFIG_RT_MUTEXES
-    scripts/config --enable CONFIG_GENERIC_LOCKBREAK
+    kconfig --enable CONFIG_RT_MUTEXES
+    kconfig --enable CONFIG_GENERIC_LOCKBREAK
     
     # RT-Debugging (optional, aber hilfreich)
-    scripts/config --enable CONFIG_DEBUG_PREEMPT
-    scripts/config --enable CONFIG_DEBUG_RT_MUTEXES
-    scripts/config --enable CONFIG_DEBUG_ATOMIC_SLEEP
-    scripts/config --enable CONFIG_PROVE_LOCKING
-    scripts/config --enable CONFIG_LOCK_STAT
+    kconfig --enable CONFIG_DEBUG_PREEMPT
+    kconfig --enable CONFIG_DEBUG_RT_MUTEXES
+    kconfig --enable CONFIG_DEBUG_ATOMIC_SLEEP
+    kconfig --enable CONFIG_PROVE_LOCKING
+    kconfig --enable CONFIG_LOCK_STAT
     
     # GPIO und Hardware-Support
-    scripts/config --enable CONFIG_GPIOLIB
-    scripts/config --enable CONFIG_GPIO_SYSFS
-    scripts/config --enable CONFIG_GPIO_BCM_VIRT
-    scripts/config --enable CONFIG_I2C
-    scripts/config --enable CONFIG_SPI
-    scripts/config --enable CONFIG_PWM
+    kconfig --enable CONFIG_GPIOLIB
+    kconfig --enable CONFIG_GPIO_SYSFS
+    kconfig --enable CONFIG_GPIO_BCM_VIRT
+    kconfig --enable CONFIG_I2C
+    kconfig --enable CONFIG_SPI
+    kconfig --enable CONFIG_PWM
     
     # Netzwerk und USB
-    scripts/config --enable CONFIG_USB
-    scripts/config --enable CONFIG_USB_XHCI_HCD
-    scripts/config --enable CONFIG_USB_EHCI_HCD
-    scripts/config --enable CONFIG_USB_OHCI_HCD
+    kconfig --enable CONFIG_USB
+    kconfig --enable CONFIG_USB_XHCI_HCD
+    kconfig --enable CONFIG_USB_EHCI_HCD
+    kconfig --enable CONFIG_USB_OHCI_HCD
     
     # Dateisystem-Support
-    scripts/config --enable CONFIG_EXT4_FS
-    scripts/config --enable CONFIG_VFAT_FS
-    scripts/config --enable CONFIG_TMPFS
-    scripts/config --enable CONFIG_DEVTMPFS
-    scripts/config --enable CONFIG_DEVTMPFS_MOUNT
+    kconfig --enable CONFIG_EXT4_FS
+    kconfig --enable CONFIG_VFAT_FS
+    kconfig --enable CONFIG_TMPFS
+    kconfig --enable CONFIG_DEVTMPFS
+    kconfig --enable CONFIG_DEVTMPFS_MOUNT
     
     # Debugging und Profiling
-    scripts/config --enable CONFIG_DEBUG_INFO
-    scripts/config --enable CONFIG_DEBUG_KERNEL
-    scripts/config --enable CONFIG_FTRACE
-    scripts/config --enable CONFIG_FUNCTION_TRACER
-    scripts/config --enable CONFIG_IRQSOFF_TRACER
-    scripts/config --enable CONFIG_PREEMPT_TRACER
-    scripts/config --enable CONFIG_SCHED_TRACER
+    kconfig --enable CONFIG_DEBUG_INFO
+    kconfig --enable CONFIG_DEBUG_KERNEL
+    kconfig --enable CONFIG_FTRACE
+    kconfig --enable CONFIG_FUNCTION_TRACER
+    kconfig --enable CONFIG_IRQSOFF_TRACER
+    kconfig --enable CONFIG_PREEMPT_TRACER
+    kconfig --enable CONFIG_SCHED_TRACER
     
     # Aktualisiere Konfiguration
-    make olddefconfig
+    make O="$CONFIG_STAGE" olddefconfig
+    cp "$CONFIG_STAGE/.config" "$RT_CONFIG"
     
-    echo "Konfiguration abgeschlossen."
+    echo "Konfiguration abgeschlossen: $RT_CONFIG"
     
     # Überprüfe RT-Konfiguration
     echo "Überprüfe RT-Konfiguration..."
-    if grep -q "CONFIG_PREEMPT_RT=y" .config; then
+    if grep -q "CONFIG_PREEMPT_RT=y" "$RT_CONFIG"; then
         echo "✓ CONFIG_PREEMPT_RT ist aktiviert"
     else
         echo "⚠ CONFIG_PREEMPT_RT ist nicht aktiviert - prüfe verfügbare Optionen"
         echo "Verfügbare Preemption-Optionen:"
-        grep "CONFIG_PREEMPT" .config | head -10
+        grep "CONFIG_PREEMPT" "$RT_CONFIG" | head -10
     fi
 else
-    echo "Konfiguration bereits vorhanden."
+    echo "Konfiguration bereits vorhanden: $RT_CONFIG"
 fi
 
-echo "=== Schritt 4: Kernel kompilieren ==="
-echo "Kompiliere Kernel mit $JOBS parallelen Jobs..."
-make -j$JOBS Image modules dtbs
-
-echo "=== Schritt 5: Module installieren ==="
-echo "Installiere Module nach $INSTALL_DIR..."
-make INSTALL_MOD_PATH="$INSTALL_DIR" modules_install
-
-echo "=== Schritt 6: Kernel und Device Tree kopieren ==="
-mkdir -p "$INSTALL_DIR/boot"
-cp arch/arm64/boot/Image "$INSTALL_DIR/boot/"
-cp arch/arm64/boot/dts/broadcom/bcm2712-rpi-5-b.dtb "$INSTALL_DIR/boot/" 2>/dev/null || echo "Warnung: bcm2712-rpi-5-b.dtb nicht gefunden"
-
-# Kopiere alle verfügbaren BCM2712 DTBs
-find arch/arm64/boot/dts/broadcom/ -name "bcm2712*.dtb" -exec cp {} "$INSTALL_DIR/boot/" \; 2>/dev/null || true
+echo "=== Schritt 4-6: Kernel, Module und Device Trees bauen (Build-Cache) ==="
+# Gleiche Konfiguration wie ein früherer Build: Artefakte werden sofort wiederhergestellt,
+# sonst wird in einem eigenen O=-Verzeichnis mit ccache gebaut
+JOBS="$JOBS" "$SCRIPT_DIR/kernel_build_cache.sh" build "$RT_CONFIG" "$INSTALL_DIR" rt
+if [ ! -f "$INSTALL_DIR/boot/bcm2712-rpi-5-b.dtb" ]; then
+    echo "Warnung: bcm2712-rpi-5-b.dtb nicht gefunden"
+fi
 
 echo "=== Schritt 7: Kernel-Informationen ==="
 echo "Kernel-Version: $(make kernelversion)"
 echo "Kompiliert für: $ARCH mit $CROSS_COMPILE"
+BUILT_CONFIG="$INSTALL_DIR/boot/config"
 
 # Erweiterte RT-Konfigurationsprüfung
 echo "RT-Konfiguration:"
-if grep -q "CONFIG_PREEMPT_RT=y" .config; then
+if grep -q "CONFIG_PREEMPT_RT=y" "$BUILT_CONFIG"; then
     echo "  ✓ CONFIG_PREEMPT_RT=y (aktiviert)"
 else
     echo "  ✗ CONFIG_PREEMPT_RT nicht aktiviert"
     echo "  Verfügbare Preemption-Modi:"
-    grep "CONFIG_PREEMPT.*=y" .config | sed 's/^/    /'
+    grep "CONFIG_PREEMPT.*=y" "$BUILT_CONFIG" | sed 's/^/    /'
 fi
 
 # Weitere wichtige RT-Optionen prüfen
 echo "Weitere RT-Features:"
-grep -q "CONFIG_HIGH_RES_TIMERS=y" .config && echo "  ✓ High-Resolution Timers" || echo "  ✗ High-Resolution Timers fehlt"
-grep -q "CONFIG_NO_HZ_FULL=y" .config && echo "  ✓ NO_HZ_FULL (Tickless)" || echo "  ✗ NO_HZ_FULL fehlt"
-grep -q "CONFIG_RT_MUTEXES=y" .config && echo "  ✓ RT-Mutexes" || echo "  ✗ RT-Mutexes fehlt"
-grep -q "CONFIG_RCU_BOOST=y" .config && echo "  ✓ RCU Boost" || echo "  ✗ RCU Boost fehlt"
+grep -q "CONFIG_HIGH_RES_TIMERS=y" "$BUILT_CONFIG" && echo "  ✓ High-Resolution Timers" || echo "  ✗ High-Resolution Timers fehlt"
+grep -q "CONFIG_NO_HZ_FULL=y" "$BUILT_CONFIG" && echo "  ✓ NO_HZ_FULL (Tickless)" || echo "  ✗ NO_HZ_FULL fehlt"
+grep -q "CONFIG_RT_MUTEXES=y" "$BUILT_CONFIG" && echo "  ✓ RT-Mutexes" || echo "  ✗ RT-Mutexes fehlt"
+grep -q "CONFIG_RCU_BOOST=y" "$BUILT_CONFIG" && echo "  ✓ RCU Boost" || echo "  ✗ RCU Boost fehlt"
 
 echo "Installationsverzeichnis: $INSTALL_DIR"
 
@@ -1,12 +1,16 @@
 #!/bin/bash
 # Überprüft RT-Verfügbarkeit im Linux Kernel 6.15.6
 # Testet welche RT-Optionen in der defconfig verfügbar sind
+# Die Test-Konfiguration entsteht out-of-tree in $WORK_DIR/config_stage; rt.config bleibt unberührt.
 
 set -e
 
 KERNEL_VERSION="6.15.6"
 WORK_DIR="/home/developer/workspace/kernel_build"
 KERNEL_DIR="$WORK_DIR/linux-$KERNEL_VERSION"
+RT_CONFIG="$WORK_DIR/rt.config"
+CONFIG_STAGE="$WORK_DIR/config_stage"
+STAGE_CONFIG="$CONFIG_STAGE/.config"
 
 echo "=== RT-Verfügbarkeitscheck für Linux Kernel $KERNEL_VERSION ==="
 
@@ -22,15 +26,22 @@ cd "$KERNEL_DIR"
 export ARCH=arm64
 export CROSS_COMPILE=aarch64-linux-gnu-
 
+# O= verlangt einen sauberen Quellbaum; eine alte In-Tree-Konfiguration wird übernommen
+if [ -f ".config" ]; then
+    [ -f "$RT_CONFIG" ] || cp .config "$RT_CONFIG"
+    make mrproper > /dev/null 2>&1
+fi
+
 echo "Erstelle temporäre defconfig..."
-make defconfig > /dev/null 2>&1
+rm -rf "$CONFIG_STAGE"
+make O="$CONFIG_STAGE" defconfig > /dev/null 2>&1
 
 echo ""
 echo "=== Verfügbare RT-Optionen in defconfig ==="
 
 # Prüfe welche RT-Optionen verfügbar sind
 echo "Verfügbare PREEMPT-Optionen:"
-grep "CONFIG_PREEMPT" .config | while read line; do
+grep "CONFIG_PREEMPT" "$STAGE_CONFIG" | while read line; do
     echo "  $line"
 done
 
@@ -39,7 +50,7 @@ echo "=== Teste RT-Konfiguration ==="
 
 # Teste verschiedene RT-Einstellungen
 echo "Teste CONFIG_PREEMPT_RT..."
-if scripts/config --enable CONFIG_PREEMPT_RT 2>/dev/null; then
+if scripts/config --file "$STAGE_CONFIG" --enable CONFIG_PREEMPT_RT 2>/dev/null; then
     echo "  ✓ CONFIG_PREEMPT_RT kann aktiviert werden"
 else
     echo "  ✗ CONFIG_PREEMPT_RT ist nicht verfügbar"
@@ -51,7 +62,7 @@ test_config() {
     local config_name="$1"
     local description="$2"
     
-    if scripts/config --enable "CONFIG_${config_name}" 2>/dev/null; then
+    if scripts/config --file "$STAGE_CONFIG" --enable "CONFIG_${config_name}" 2>/dev/null; then
         echo "  ✓ CONFIG_$config_name verfügbar - $description"
     else
         echo "  ✗ CONFIG_$config_name nicht verfügbar - $description"
@@ -72,18 +83,18 @@ echo "Erwartete RT-Unterstützung: Ja (seit 6.12)"
 # Aktualisiere Konfiguration
 echo ""
 echo "Aktualisiere Konfiguration..."
-make olddefconfig > /dev/null 2>&1
+make O="$CONFIG_STAGE" olddefconfig > /dev/null 2>&1
 
 echo ""
 echo "=== Finale Konfiguration ==="
 echo "Nach olddefconfig verfügbare RT-Optionen:"
-grep "CONFIG_PREEMPT.*=y" .config | while read line; do
+grep "CONFIG_PREEMPT.*=y" "$STAGE_CONFIG" | while read line; do
     echo "  ✓ $line"
 done
 
 echo ""
 echo "=== Empfehlung ==="
-if grep -q "CONFIG_PREEMPT_RT=y" .config; then
+if grep -q "CONFIG_PREEMPT_RT=y" "$STAGE_CONFIG"; then
     echo "✅ CONFIG_PREEMPT_RT ist verfügbar und aktiviert!"
     echo "Der Kernel sollte RT-Funktionalität unterstützen."
 else
@@ -95,7 +106,7 @@ else
     echo "3. Architektur-spezifische Einschränkungen"
     echo ""
     echo "Lösungsansätze:"
-    echo "1. Verwende 'make menuconfig' für manuelle Konfiguration"
+    echo "1. Verwende ./configure_rt_kernel.sh für manuelle Konfiguration"
     echo "2. Prüfe Kernel-Dokumentation für RT-Unterstützung"
     echo "3. Verwende einen anderen Kernel-Build (z.B. bcm2711_defconfig)"
 fi
@@ -103,10 +114,9 @@ fi
 echo ""
 echo "=== Manuelle Konfiguration ==="
 echo "Für interaktive Konfiguration verwende:"
-echo "  cd $KERNEL_DIR"
-echo "  make menuconfig"
+echo "  ./configure_rt_kernel.sh   (oder make menuconfig)"
 echo "  # Navigiere zu: General setup → Preemption Model"
 echo "  # Wähle: Fully Preemptible Kernel (Real-Time)"
 
 # Cleanup
-rm -f .config.old
+rm -f "$STAGE_CONFIG.old"
@@ -2,6 +2,9 @@
 # Erweiterte Kernel-Konfiguration für PREEMPT_RT auf Raspberry Pi 5
 # Dieses Skript konfiguriert den Kernel mit menuconfig für manuelle Anpassungen
 # Hinweis: Seit Linux 6.12 ist PREEMPT_RT im Mainline-Kernel integriert
+#
+# Bearbeitet wird die gespeicherte Konfiguration $WORK_DIR/rt.config in einem O=-Verzeichnis;
+# build_rt_kernel.sh baut daraus out-of-tree, eine In-Tree-.config würde dort verworfen.
 
 set -e
 
@@ -10,6 +13,8 @@ WORK_DIR="/home/developer/workspace/kernel_build"
 KERNEL_DIR="$WORK_DIR/linux-$KERNEL_VERSION"
 CROSS_COMPILE="aarch64-linux-gnu-"
 ARCH="arm64"
+RT_CONFIG="$WORK_DIR/rt.config"
+CONFIG_STAGE="$WORK_DIR/config_stage"
 
 if [ ! -d "$KERNEL_DIR" ]; then
     echo "Fehler: Kernel-Quellcode nicht gefunden. Führe zuerst build_rt_kernel.sh aus."
@@ -21,6 +26,20 @@ cd "$KERNEL_DIR"
 export ARCH="$ARCH"
 export CROSS_COMPILE="$CROSS_COMPILE"
 
+# Ältere Läufe haben in-tree konfiguriert; O= verlangt einen sauberen Quellbaum
+if [ -f ".config" ]; then
+    if [ ! -f "$RT_CONFIG" ]; then
+        echo "Übernehme vorhandene In-Tree-Konfiguration nach $RT_CONFIG..."
+        cp .config "$RT_CONFIG"
+    fi
+    make mrproper
+fi
+
+if [ ! -f "$RT_CONFIG" ]; then
+    echo "Fehler: $RT_CONFIG nicht gefunden. Führe zuerst build_rt_kernel.sh (oder make configure) aus."
+    exit 1
+fi
+
 echo "=== Kernel-Konfiguration mit menuconfig ==="
 echo "Wichtige Bereiche für PREEMPT_RT (Mainline seit 6.12):"
 echo "- General setup → Preemption Model → Fully Preemptible Kernel (Real-Time)"
@@ -31,7 +50,11 @@ echo ""
 echo "Drücke Enter zum Fortfahren..."
 read
 
-make menuconfig
+rm -rf "$CONFIG_STAGE"
+mkdir -p "$CONFIG_STAGE"
+cp "$RT_CONFIG" "$CONFIG_STAGE/.config"
+make O="$CONFIG_STAGE" menuconfig
+cp "$CONFIG_STAGE/.config" "$RT_CONFIG"
 
-echo "=== Konfiguration gespeichert ==="
-echo "Zum Kompilieren führe aus: cd $KERNEL_DIR && make -j$(nproc) Image modules dtbs"
+echo "=== Konfiguration gespeichert: $RT_CONFIG ==="
+echo "Zum Kompilieren führe aus: ./build_rt_kernel.sh (oder make compile)"
@@ -1,35 +1,30 @@
 #!/bin/bash
 # Diagnoseskript für PREEMPT_RT-Konfiguration
 # Überprüft die RT-Konfiguration im Linux Kernel 6.15.6
+# Usage: ./diagnose_rt_config.sh [config]   (Standard: $WORK_DIR/rt.config aus build_rt_kernel.sh)
 
 set -e
 
 KERNEL_VERSION="6.15.6"
 WORK_DIR="/home/developer/workspace/kernel_build"
-KERNEL_DIR="$WORK_DIR/linux-$KERNEL_VERSION"
+# Gebaut wird out-of-tree; die Konfiguration liegt außerhalb des Quellbaums
+CONFIG="${1:-$WORK_DIR/rt.config}"
 
 echo "=== PREEMPT_RT Konfigurationsdiagnose ==="
 echo "Kernel-Version: $KERNEL_VERSION"
+echo "Konfiguration: $CONFIG"
 echo "Datum: $(date)"
 
-if [ ! -d "$KERNEL_DIR" ]; then
-    echo "Fehler: Kernel-Verzeichnis nicht gefunden: $KERNEL_DIR"
-    echo "Führe zuerst build_rt_kernel.sh aus."
-    exit 1
-fi
-
-cd "$KERNEL_DIR"
-
-if [ ! -f ".config" ]; then
+if [ ! -f "$CONFIG" ]; then
     echo "Fehler: Keine Kernel-Konfiguration gefunden."
-    echo "Führe zuerst die Kernel-Konfiguration aus."
+    echo "Führe zuerst build_rt_kernel.sh (oder make configure) aus."
     exit 1
 fi
 
 echo ""
 echo "=== Preemption-Modell ==="
 echo "Aktuelle Preemption-Konfiguration:"
-grep "CONFIG_PREEMPT" .config | grep "=y" | while read line; do
+grep "CONFIG_PREEMPT" "$CONFIG" | grep "=y" | while read line; do
     echo "  ✓ $line"
 done
 
@@ -41,7 +36,7 @@ check_config() {
     local config_name="$1"
     local description="$2"
     
-    if grep -q "CONFIG_${config_name}=y" .config; then
+    if grep -q "CONFIG_${config_name}=y" "$CONFIG"; then
         echo "  ✓ CONFIG_$config_name - $description"
     else
         echo "  ✗ CONFIG_$config_name - $description (nicht aktiviert)"
@@ -82,8 +77,7 @@ check_config "SPI" "SPI Bus Support"
 echo ""
 echo "=== Kernel-Optionen verfügbar in menuconfig ==="
 echo "Für interaktive Konfiguration:"
-echo "  cd $KERNEL_DIR"
-echo "  make menuconfig"
+echo "  ./configure_rt_kernel.sh   (oder make menuconfig)"
 echo ""
 echo "Wichtige Menüpunkte:"
 echo "  General setup → Preemption Model"
@@ -94,7 +88,7 @@ echo "  Kernel hacking → Tracers"
 
 echo ""
 echo "=== RT-Kernel-Informationen ==="
-if grep -q "CONFIG_PREEMPT_RT=y" .config; then
+if grep -q "CONFIG_PREEMPT_RT=y" "$CONFIG"; then
     echo "✓ Dieser Kernel ist für Real-Time konfiguriert!"
     echo ""
     echo "Nach dem Kompilieren können Sie RT-Features testen mit:"
@@ -106,11 +100,11 @@ else
     echo ""
     echo "Mögliche Lösungen:"
     echo "1. Prüfe ob CONFIG_PREEMPT_RT in der Kernel-Version verfügbar ist"
-    echo "2. Verwende 'make menuconfig' für manuelle Konfiguration"
+    echo "2. Verwende ./configure_rt_kernel.sh für manuelle Konfiguration"
     echo "3. Prüfe Kernel-Dokumentation für RT-Unterstützung"
 fi
 
 echo ""
 echo "=== Konfigurationsdatei-Auszug ==="
 echo "Alle PREEMPT-bezogenen Optionen:"
-grep "CONFIG_PREEMPT" .config | head -20
+grep "CONFIG_PREEMPT" "$CONFIG" | head -20
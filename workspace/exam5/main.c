@@ -1,25 +1,68 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <pthread.h>
 #include <unistd.h>
 
-// Beispiel-Thread-Funktion
-void *simple_task(void *arg) {
-    while (1) {
-        printf("Einfacher Task wird ausgeführt\n");
-        sleep(1); // 1 Sekunde warten
+#include "taskpool.h"
+
+// Statt eines einzelnen schlafenden Threads: viele kurze Aufgaben über den Task-Scheduler
+// Usage: ./main [worker] [pin]
+
+#define NUM_SENSORS 64
+#define SAMPLES_PER_SENSOR 1000
+
+struct sensor_job {
+    int channel;
+    unsigned int seed;
+    double mean_celsius;
+};
+
+// Kurze Aufgabe: Rohwerte eines ADC-Kanals (12 Bit) in Temperaturen umrechnen und mitteln
+static void convert_sensor(void *arg) {
+    struct sensor_job *job = arg;
+    double sum = 0.0;
+    for (int i = 0; i < SAMPLES_PER_SENSOR; ++i) {
+        int raw = rand_r(&job->seed) % 4096;
+        sum += raw * (150.0 / 4095.0) - 50.0; // Messbereich -50 ... 100 °C
     }
-    return NULL;
+    job->mean_celsius = sum / SAMPLES_PER_SENSOR;
 }
 
-int main() {
-    pthread_t
-thread;
-    if (pthread_create(&thread, NULL, simple_task, NULL) != 0) {
-        perror("pthread_create");
+int main(int argc, char *argv[]) {
+    int workers = argc > 1 ? atoi(argv[1]) : 0;
+    int pin = argc > 2 && strcmp(argv[2], "pin") == 0;
+
+    struct task_pool *pool = task_pool_create(workers, pin);
+    if (pool == NULL) {
+        perror("task_pool_create");
         return EXIT_FAILURE;
     }
+    printf("Task-Scheduler mit %d Workern gestartet%s\n", task_pool_workers(pool), pin ? " (gepinnt)" : "");
 
-    pthread_join(thread, NULL);
+    struct sensor_job jobs[NUM_SENSORS];
+    struct task tasks[NUM_SENSORS];
+    for (unsigned int cycle = 0;; ++cycle) {
+        struct task_group group;
+        task_group_init(&group);
+        for (int i = 0; i < NUM_SENSORS; ++i) {
+            jobs[i].channel = i;
+            jobs[i].seed = cycle * NUM_SENSORS + (unsigned int)i;
+            task_spawn(pool, &group, &tasks[i], convert_sensor, &jobs[i]);
+        }
+        task_group_wait(pool, &group);
+
+        double min = jobs[0].mean_celsius;
+        double max = jobs[0].mean_celsius;
+        for (int i = 1; i < NUM_SENSORS; ++i) {
+            min = jobs[i].mean_celsius < min ? jobs[i].mean_celsius : min;
+            max = jobs[i].mean_celsius > max ? jobs[i].mean_celsius : max;
+        }
+        printf("Zyklus %u: %d Sensoren umgerechnet, Mittelwerte %.2f ... %.2f °C\n", cycle, NUM_SENSORS, min, max);
+        fflush(stdout);
+        sleep(1); // 1 Sekunde warten
+    }
+
+    task_pool_destroy(pool);
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
@@ -0,0 +1,389 @@
+// Work-Stealing-Scheduler (siehe taskpool.h)
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <linux/futex.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "taskpool.h"
+
+#define MAX_WORKERS 256
+#define DEQUE_INITIAL_SIZE 256        // Zweierpotenz
+#define SPIN_ROUNDS 64                // erfolglose Stehlrunden vor dem Parken
+
+// Ringpuffer der Deque; beim Vergrößern bleibt der alte für laufende Diebe gültig
+struct deque_array {
+    int64_t size;
+    struct deque_array *retired;      // ältere Puffer, freigegeben in task_pool_destroy
+    _Atomic(struct task *) buffer[];
+};
+
+// Chase-Lev-Deque (C11-Fassung nach Lê, Pop, Cohen, Zappa Nardelli, PPoPP 2013)
+struct deque {
+    _Atomic int64_t top;
+    char pad1[56];
+    _Atomic int64_t bottom;
+    _Atomic(struct deque_array *) array;
+    char pad2[48];
+};
+
+struct worker {
+    struct task_pool *pool;
+    pthread_t thread;
+    int index;
+    uint64_t rng;
+    struct deque deque;
+};
+
+struct task_pool {
+    int num_workers;
+    struct worker *workers;
+    _Atomic int stop;
+    // Parken: Worker warten auf eine Änderung von epoch, solange sleepers > 0 wird geweckt
+    _Atomic uint32_t epoch;
+    _Atomic int sleepers;
+    // Eingangsschlange für Tasks von außerhalb des Pools
+    pthread_mutex_t inject_lock;
+    struct task *inject_head;
+    struct task *inject_tail;
+    _Atomic int inject_count;
+};
+
+static __thread struct worker *current_worker;
+
+static long futex(_Atomic uint32_t *addr, int op, uint32_t val) {
+    return syscall(SYS_futex, (uint32_t *)addr, op, val, NULL, NULL, 0);
+}
+
+static struct deque_array *deque_array_new(int64_t size) {
+    struct deque_array *a = malloc(sizeof(*a) + (size_t)size * sizeof(a->buffer[0]));
+    if (a == NULL) {
+        perror("Deque-Puffer");
+        abort();
+    }
+    a->size = size;
+    a->retired = NULL;
+    return a;
+}
+
+static void deque_init(struct deque *q) {
+    atomic_init(&q->top, 0);
+    atomic_init(&q->bottom, 0);
+    atomic_init(&q->array, deque_array_new(DEQUE_INITIAL_SIZE));
+}
+
+static void deque_destroy(struct deque *q) {
+    struct deque_array *a = atomic_load_explicit(&q->array, memory_order_relaxed);
+    while (a != NULL) {
+        struct deque_array *retired = a->retired;
+        free(a);
+        a = retired;
+    }
+}
+
+// Nur der Besitzer
+static void deque_push(struct deque *q, struct task *task) {
+    int64_t b = atomic_load_explicit(&q->bottom, memory_order_relaxed);
+    int64_t t = atomic_load_explicit(&q->top, memory_order_acquire);
+    struct deque_array *a = atomic_load_explicit(&q->array, memory_order_relaxed);
+    if (b - t > a->size - 1) {
+        struct deque_array *bigger = deque_array_new(a->size * 2);
+        for (int64_t i = t; i < b; ++i) {
+            atomic_store_explicit(&bigger->buffer[i & (bigger->size - 1)],
+                                  atomic_load_explicit(&a->buffer[i & (a->size - 1)], memory_order_relaxed),
+                                  memory_order_relaxed);
+        }
+        bigger->retired = a;
+        atomic_store_explicit(&q->array, bigger, memory_order_release);
+        a = bigger;
+    }
+    atomic_store_explicit(&a->buffer[b & (a->size - 1)], task, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&q->bottom, b + 1, memory_order_relaxed);
+}
+
+// Nur der Besitzer; NULL wenn leer
+static struct task *deque_take(struct deque *q) {
+    int64_t b = atomic_load_explicit(&q->bottom, memory_order_relaxed) - 1;
+    struct deque_array *a = atomic_load_explicit(&q->array, memory_order_relaxed);
+    atomic_store_explicit(&q->bottom, b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t t = atomic_load_explicit(&q->top, memory_order_relaxed);
+    if (t > b) {
+        atomic_store_explicit(&q->bottom, b + 1, memory_order_relaxed);
+        return NULL;
+    }
+    struct task *task = atomic_load_explicit(&a->buffer[b & (a->size - 1)], memory_order_relaxed);
+    if (t == b) {
+        // Letztes Element: gegen Diebe um top konkurrieren
+        if (!atomic_compare_exchange_strong_explicit(&q->top, &t, t + 1, memory_order_seq_cst, memory_order_relaxed)) {
+            task = NULL;
+        }
+        atomic_store_explicit(&q->bottom, b + 1, memory_order_relaxed);
+    }
+    return task;
+}
+
+// Beliebiger Thread; NULL wenn leer oder gegen einen anderen Dieb verloren
+static struct task *deque_steal(struct deque *q) {
+    int64_t t = atomic_load_explicit(&q->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t b = atomic_load_explicit(&q->bottom, memory_order_acquire);
+    if (t >= b) {
+        return NULL;
+    }
+    struct deque_array *a = atomic_load_explicit(&q->array, memory_order_acquire);
+    struct task *task = atomic_load_explicit(&a->buffer[t & (a->size - 1)], memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&q->top, &t, t + 1, memory_order_seq_cst, memory_order_relaxed)) {
+        return NULL;
+    }
+    return task;
+}
+
+static int deque_maybe_nonempty(struct deque *q) {
+    return atomic_load_explicit(&q->bottom, memory_order_relaxed) > atomic_load_explicit(&q->top, memory_order_relaxed);
+}
+
+// Einen parkenden Worker wecken, falls es einen gibt
+static void notify_one(struct task_pool *pool) {
+    atomic_thread_fence(memory_order_seq_cst); // Gegenstück zur Prüfung in park()
+    if (atomic_load_explicit(&pool->sleepers, memory_order_relaxed) > 0) {
+        atomic_fetch_add_explicit(&pool->epoch, 1, memory_order_release);
+        futex(&pool->epoch, FUTEX_WAKE_PRIVATE, 1);
+    }
+}
+
+static struct task *inject_pop(struct task_pool *pool) {
+    if (atomic_load_explicit(&pool->inject_count, memory_order_relaxed) == 0) {
+        return NULL;
+    }
+    pthread_mutex_lock(&pool->inject_lock);
+    struct task *task = pool->inject_head;
+    if (task != NULL) {
+        pool->inject_head = task->next;
+        if (pool->inject_head == NULL) {
+            pool->inject_tail = NULL;
+        }
+        atomic_fetch_sub_explicit(&pool->inject_count, 1, memory_order_relaxed);
+    }
+    pthread_mutex_unlock(&pool->inject_lock);
+    return task;
+}
+
+static uint64_t next_random(uint64_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+// Eigene Deque, dann Eingangsschlange, dann zufällige Opfer
+static struct task *find_task(struct worker *self) {
+    struct task_pool *pool = self->pool;
+    struct task *task = deque_take(&self->deque);
+    if (task != NULL) {
+        return task;
+    }
+    task = inject_pop(pool);
+    if (task != NULL) {
+        return task;
+    }
+    int n = pool->num_workers;
+    int start = (int)(next_random(&self->rng) % (uint64_t)n);
+    for (int i = 0; i < n; ++i) {
+        struct worker *victim = &pool->workers[(start + i) % n];
+        if (victim == self) {
+            continue;
+        }
+        task = deque_steal(&victim->deque);
+        if (task != NULL) {
+            return task;
+        }
+    }
+    return NULL;
+}
+
+static void run_task(struct task *task) {
+    struct task_group *group = task->group;
+    task->fn(task->arg);
+    // Nach dem Dekrement darf der Wartende task und group freigeben: danach nur noch der Weckruf
+    uint32_t old = atomic_fetch_sub_explicit(&group->pending, 1, memory_order_acq_rel);
+    if (old == (TASK_GROUP_WAITING | 1)) {
+        futex(&group->pending, FUTEX_WAKE_PRIVATE, INT32_MAX);
+    }
+}
+
+static int work_available(struct task_pool *pool) {
+    if (atomic_load_explicit(&pool->inject_count, memory_order_relaxed) > 0) {
+        return 1;
+    }
+    for (int i = 0; i < pool->num_workers; ++i) {
+        if (deque_maybe_nonempty(&pool->workers[i].deque)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void park(struct task_pool *pool) {
+    uint32_t epoch = atomic_load_explicit(&pool->epoch, memory_order_acquire);
+    atomic_fetch_add_explicit(&pool->sleepers, 1, memory_order_seq_cst);
+    atomic_thread_fence(memory_order_seq_cst);
+    // Nach der Anmeldung erneut prüfen: ein Task, der vorher kam, hat uns nicht gesehen
+    if (!work_available(pool) && !atomic_load_explicit(&pool->stop, memory_order_acquire)) {
+        futex(&pool->epoch, FUTEX_WAIT_PRIVATE, epoch);
+    }
+    atomic_fetch_sub_explicit(&pool->sleepers, 1, memory_order_relaxed);
+}
+
+static void *worker_main(void *arg) {
+    struct worker *self = arg;
+    struct task_pool *pool = self->pool;
+    int idle = 0;
+    current_worker = self;
+    while (!atomic_load_explicit(&pool->stop, memory_order_acquire)) {
+        struct task *task = find_task(self);
+        if (task != NULL) {
+            idle = 0;
+            run_task(task);
+        } else if (++idle < SPIN_ROUNDS) {
+            sched_yield();
+        } else {
+            park(pool);
+            idle = 0;
+        }
+    }
+    return NULL;
+}
+
+struct task_pool *task_pool_create(int num_workers, int pin) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus < 1) {
+        cpus = 1;
+    }
+    if (num_workers <= 0) {
+        num_workers = (int)cpus;
+    }
+    if (num_workers > MAX_WORKERS) {
+        num_workers = MAX_WORKERS;
+    }
+    struct task_pool *pool = calloc(1, sizeof(*pool));
+    if (pool == NULL) {
+        return NULL;
+    }
+    pool->workers = aligned_alloc(64, ((size_t)num_workers * sizeof(struct worker) + 63) & ~(size_t)63);
+    if (pool->workers == NULL) {
+        free(pool);
+        return NULL;
+    }
+    pool->num_workers = num_workers;
+    pthread_mutex_init(&pool->inject_lock, NULL);
+    for (int i = 0; i < num_workers; ++i) {
+        struct worker *w = &pool->workers[i];
+        w->pool = pool;
+        w->index = i;
+        w->rng = 0x9e3779b97f4a7c15ULL * (uint64_t)(i + 1);
+        deque_init(&w->deque);
+    }
+    for (int i = 0; i < num_workers; ++i) {
+        struct worker *w = &pool->workers[i];
+        if (pthread_create(&w->thread, NULL, worker_main, w) != 0) {
+            perror("pthread_create");
+            pool->num_workers = i;
+            task_pool_destroy(pool);
+            return NULL;
+        }
+        if (pin) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(i % cpus, &set);
+            if (pthread_setaffinity_np(w->thread, sizeof(set), &set) != 0) {
+                fprintf(stderr, "Hinweis: Worker %d konnte nicht auf CPU %ld gepinnt werden\n", i, i % cpus);
+            }
+        }
+    }
+    return pool;
+}
+
+void task_pool_destroy(struct task_pool *pool) {
+    atomic_store_explicit(&pool->stop, 1, memory_order_release);
+    atomic_fetch_add_explicit(&pool->epoch, 1, memory_order_release);
+    futex(&pool->epoch, FUTEX_WAKE_PRIVATE, INT32_MAX);
+    for (int i = 0; i < pool->num_workers; ++i) {
+        pthread_join(pool->workers[i].thread, NULL);
+    }
+    for (int i = 0; i < pool->num_workers; ++i) {
+        deque_destroy(&pool->workers[i].deque);
+    }
+    pthread_mutex_destroy(&pool->inject_lock);
+    free(pool->workers);
+    free(pool);
+}
+
+int task_pool_workers(const struct task_pool *pool) {
+    return pool->num_workers;
+}
+
+void task_group_init(struct task_group *group) {
+    atomic_init(&group->pending, 0);
+}
+
+void task_spawn(struct task_pool *pool, struct task_group *group, struct task *task, task_fn fn, void *arg) {
+    task->fn = fn;
+    task->arg = arg;
+    task->group = group;
+    task->next = NULL;
+    atomic_fetch_add_explicit(&group->pending, 1, memory_order_relaxed);
+
+    struct worker *self = current_worker;
+    if (self != NULL && self->pool == pool) {
+        deque_push(&self->deque, task);
+    } else {
+        pthread_mutex_lock(&pool->inject_lock);
+        if (pool->inject_tail != NULL) {
+            pool->inject_tail->next = task;
+        } else {
+            pool->inject_head = task;
+        }
+        pool->inject_tail = task;
+        atomic_fetch_add_explicit(&pool->inject_count, 1, memory_order_relaxed);
+        pthread_mutex_unlock(&pool->inject_lock);
+    }
+    notify_one(pool);
+}
+
+void task_group_wait(struct task_pool *pool, struct task_group *group) {
+    struct worker *self = current_worker;
+    if (self != NULL && self->pool == pool) {
+        // Im Worker: mithelfen statt blockieren
+        while ((atomic_load_explicit(&group->pending, memory_order_acquire) & ~TASK_GROUP_WAITING) != 0) {
+            struct task *task = find_task(self);
+            if (task != NULL) {
+                run_task(task);
+            } else {
+                sched_yield();
+            }
+        }
+        return;
+    }
+    // Außerhalb: Warte-Bit setzen und schlafen, bis der letzte Task es beim Dekrement sieht
+    uint32_t pending = atomic_load_explicit(&group->pending, memory_order_acquire);
+    while ((pending & ~TASK_GROUP_WAITING) != 0) {
+        if (!(pending & TASK_GROUP_WAITING)) {
+            if (!atomic_compare_exchange_weak_explicit(&group->pending, &pending, pending | TASK_GROUP_WAITING,
+                                                       memory_order_acq_rel, memory_order_acquire)) {
+                continue;
+            }
+            pending |= TASK_GROUP_WAITING;
+        }
+        futex(&group->pending, FUTEX_WAIT_PRIVATE, pending);
+        pending = atomic_load_explicit(&group->pending, memory_order_acquire);
+    }
+    atomic_fetch_and_explicit(&group->pending, ~TASK_GROUP_WAITING, memory_order_relaxed);
+}
@@ -0,0 +1,53 @@
+#ifndef TASKPOOL_H
+#define TASKPOOL_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+/*
+Task-Scheduler mit Work-Stealing für viele kurze Aufgaben.
+
+- Jeder Worker hat eine Chase-Lev-Deque: er legt neue Tasks unten ab und nimmt sie unten
+  wieder heraus (LIFO, cache-freundlich); leerlaufende Worker stehlen oben (FIFO, große
+  Teilaufgaben zuerst).
+- Tasks von Threads außerhalb des Pools landen in einer gemeinsamen Eingangsschlange.
+- Worker ohne Arbeit drehen kurz und parken dann per futex; neue Tasks wecken einen Worker.
+- Optional wird Worker i auf CPU i (modulo CPU-Anzahl) gepinnt.
+- Task-Gruppen: task_group_wait wartet, bis alle Tasks der Gruppe fertig sind. Im Worker
+  arbeitet der Wartende währenddessen andere Tasks ab (kein blockierter Worker bei
+  verschachtelten Gruppen, z.B. rekursivem fib); außerhalb des Pools wird per futex gewartet.
+
+Der Speicher für struct task gehört dem Aufrufer und muss bis zum Ende von task_group_wait
+gültig bleiben; der Scheduler selbst allokiert pro Task nichts.
+*/
+
+struct task_pool;
+struct task;
+
+typedef void (*task_fn)(void *arg);
+
+// Bit 31 von pending: jemand außerhalb des Pools wartet per futex auf diese Gruppe
+#define TASK_GROUP_WAITING 0x80000000U
+
+struct task_group {
+    _Atomic uint32_t pending;     // noch nicht beendete Tasks (futex-Wort)
+};
+
+struct task {
+    task_fn fn;
+    void *arg;
+    struct task_group *group;
+    struct task *next;            // Eingangsschlange
+};
+
+// num_workers <= 0: eine pro Online-CPU. pin != 0: Worker auf CPUs festlegen. NULL bei Fehler
+struct task_pool *task_pool_create(int num_workers, int pin);
+// Wartet nicht auf offene Tasks; vorher task_group_wait aufrufen
+void task_pool_destroy(struct task_pool *pool);
+int task_pool_workers(const struct task_pool *pool);
+
+void task_group_init(struct task_group *group);
+void task_spawn(struct task_pool *pool, struct task_group *group, struct task *task, task_fn fn, void *arg);
+void task_group_wait(struct task_pool *pool, struct task_group *group);
+
+#endif
@@ -0,0 +1,299 @@
+/*
+Benchmark für den Task-Scheduler: Skalierung von 1 bis N Workern und Vergleich mit einem
+Thread pro Task.
+
+fib  rekursives fib(n), Tasks bis zur Grenze cutoff, darunter seriell (verschachtelte Gruppen)
+map  Feld von elements Werten in chunks Stücke geteilt, jedes Stück eine unabhängige Task
+
+"thread/task" erzeugt für jede Task einen eigenen pthread (fib: pro rekursivem Aufruf oberhalb
+der Grenze, map: pro Stück) und wartet per pthread_join.
+
+Verwendung: ./taskpool_bench [-n fib_n] [-c fib_cutoff] [-e elemente] [-k stücke] [-w max_worker]
+                             [-r wiederholungen] [-p (pinnen)]
+*/
+
+#define _GNU_SOURCE
+
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "taskpool.h"
+
+#define THREAD_STACK_SIZE (256 * 1024)
+
+struct bench_config {
+    int fib_n;
+    int fib_cutoff;
+    long elements;
+    int chunks;
+    int max_workers;
+    int repeats;
+    int pin;
+};
+
+static struct task_pool *current_pool;
+static int fib_cutoff;
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static long fib_serial(int n) {
+    return n < 2 ? n : fib_serial(n - 1) + fib_serial(n - 2);
+}
+
+// ---- fib ----
+
+struct fib_args {
+    int n;
+    long result;
+};
+
+static void fib_task(void *arg) {
+    struct fib_args *a = arg;
+    if (a->n < fib_cutoff) {
+        a->result = fib_serial(a->n);
+        return;
+    }
+    struct fib_args left = { a->n - 1, 0 };
+    struct fib_args right = { a->n - 2, 0 };
+    struct task task;
+    struct task_group group;
+    task_group_init(&group);
+    task_spawn(current_pool, &group, &task, fib_task, &left);
+    fib_task(&right); // eine Hälfte selbst rechnen
+    task_group_wait(current_pool, &group);
+    a->result = left.result + right.result;
+}
+
+static void *fib_thread(void *arg) {
+    struct fib_args *a = arg;
+    if (a->n < fib_cutoff) {
+        a->result = fib_serial(a->n);
+        return NULL;
+    }
+    struct fib_args left = { a->n - 1, 0 };
+    struct fib_args right = { a->n - 2, 0 };
+    pthread_attr_t attr;
+    pthread_t thread;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, THREAD_STACK_SIZE);
+    if (pthread_create(&thread, &attr, fib_thread, &left) != 0) {
+        fib_thread(&left); // Thread-Limit erreicht: seriell weiter
+        fib_thread(&right);
+    } else {
+        fib_thread(&right);
+        pthread_join(thread, NULL);
+    }
+    pthread_attr_destroy(&attr);
+    a->result = left.result + right.result;
+    return NULL;
+}
+
+// ---- map ----
+
+struct map_chunk {
+    const double *in;
+    double *out;
+    long begin;
+    long end;
+};
+
+static void map_task(void *arg) {
+    struct map_chunk *c = arg;
+    for (long i = c->begin; i < c->end; ++i) {
+        c->out[i] = sqrt(c->in[i]) * sin(c->in[i]) + log1p(c->in[i]);
+    }
+}
+
+static void *map_thread(void *arg) {
+    map_task(arg);
+    return NULL;
+}
+
+static void map_split(struct map_chunk *chunks, int count, const double *in, double *out, long elements) {
+    for (int i = 0; i < count; ++i) {
+        chunks[i].in = in;
+        chunks[i].out = out;
+        chunks[i].begin = elements * i / count;
+        chunks[i].end = elements * (i + 1) / count;
+    }
+}
+
+// ---- Messung ----
+
+static double time_fib_pool(struct task_pool *pool, int n, long *result) {
+    struct fib_args root = { n, 0 };
+    struct task task;
+    struct task_group group;
+    current_pool = pool;
+    double t0 = now_s();
+    task_group_init(&group);
+    task_spawn(pool, &group, &task, fib_task, &root);
+    task_group_wait(pool, &group);
+    *result = root.result;
+    return now_s() - t0;
+}
+
+static double time_fib_threads(int n, long *result) {
+    struct fib_args root = { n, 0 };
+    double t0 = now_s();
+    fib_thread(&root);
+    *result = root.result;
+    return now_s() - t0;
+}
+
+static double time_map_pool(struct task_pool *pool, struct map_chunk *chunks, struct task *tasks, int count) {
+    struct task_group group;
+    double t0 = now_s();
+    task_group_init(&group);
+    for (int i = 0; i < count; ++i) {
+        task_spawn(pool, &group, &tasks[i], map_task, &chunks[i]);
+    }
+    task_group_wait(pool, &group);
+    return now_s() - t0;
+}
+
+static double time_map_threads(struct map_chunk *chunks, pthread_t *threads, int count) {
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, THREAD_STACK_SIZE);
+    double t0 = now_s();
+    for (int i = 0; i < count; ++i) {
+        if (pthread_create(&threads[i], &attr, map_thread, &chunks[i]) != 0) {
+            map_task(&chunks[i]);
+            threads[i] = 0;
+        }
+    }
+    for (int i = 0; i < count; ++i) {
+        if (threads[i] != 0) {
+            pthread_join(threads[i], NULL);
+        }
+    }
+    pthread_attr_destroy(&attr);
+    return now_s() - t0;
+}
+
+static double best_of(double *times, int count) {
+    double best = times[0];
+    for (int i = 1; i < count; ++i) {
+        best = times[i] < best ? times[i] : best;
+    }
+    return best;
+}
+
+int main(int argc, char *argv[]) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    struct bench_config config = {
+        .fib_n = 38, .fib_cutoff = 20, .elements = 8000000, .chunks = 512,
+        .max_workers = cpus > 0 ? (int)cpus : 1, .repeats = 3, .pin = 0,
+    };
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:c:e:k:w:r:ph")) != -1) {
+        switch (opt) {
+        case 'n': config.fib_n = atoi(optarg); break;
+        case 'c': config.fib_cutoff = atoi(optarg); break;
+        case 'e': config.elements = atol(optarg); break;
+        case 'k': config.chunks = atoi(optarg); break;
+        case 'w': config.max_workers = atoi(optarg); break;
+        case 'r': config.repeats = atoi(optarg); break;
+        case 'p': config.pin = 1; break;
+        default:
+            fprintf(stderr, "Verwendung: %s [-n fib_n] [-c fib_cutoff] [-e elemente] [-k stücke] [-w max_worker] [-r wiederholungen] [-p]\n", argv[0]);
+            return opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if (config.fib_n < 0 || config.fib_cutoff < 2 || config.elements < 1 || config.chunks < 1 ||
+        config.max_workers < 1 || config.repeats < 1 || config.repeats > 32) {
+        fprintf(stderr, "Ungültige Parameter\n");
+        return EXIT_FAILURE;
+    }
+    fib_cutoff = config.fib_cutoff;
+
+    double *in = malloc((size_t)config.elements * sizeof(double));
+    double *out = malloc((size_t)config.elements * sizeof(double));
+    struct map_chunk *chunks = malloc((size_t)config.chunks * sizeof(*chunks));
+    struct task *tasks = malloc((size_t)config.chunks * sizeof(*tasks));
+    pthread_t *threads = malloc((size_t)config.chunks * sizeof(*threads));
+    if (in == NULL || out == NULL || chunks == NULL || tasks == NULL || threads == NULL) {
+        perror("malloc");
+        return EXIT_FAILURE;
+    }
+    for (long i = 0; i < config.elements; ++i) {
+        in[i] = (double)(i % 1000) + 0.5;
+    }
+    map_split(chunks, config.chunks, in, out, config.elements);
+
+    long expected = fib_serial(config.fib_n);
+    double times[32];
+    printf("CPUs: %ld, fib(%d) mit Grenze %d, map über %ld Elemente in %d Stücken\n\n",
+           cpus, config.fib_n, config.fib_cutoff, config.elements, config.chunks);
+    printf("%-14s %12s %10s %12s %10s\n", "Aufbau", "fib [s]", "Speedup", "map [s]", "Speedup");
+
+    double fib_base = 0.0;
+    double map_base = 0.0;
+    for (int workers = 1; workers <= config.max_workers; workers *= 2) {
+        struct task_pool *pool = task_pool_create(workers, config.pin);
+        if (pool == NULL) {
+            perror("task_pool_create");
+            return EXIT_FAILURE;
+        }
+        long result = 0;
+        for (int r = 0; r < config.repeats; ++r) {
+            times[r] = time_fib_pool(pool, config.fib_n, &result);
+            if (result != expected) {
+                fprintf(stderr, "fib falsch: %ld statt %ld\n", result, expected);
+                return EXIT_FAILURE;
+            }
+        }
+        double fib_time = best_of(times, config.repeats);
+        for (int r = 0; r < config.repeats; ++r) {
+            times[r] = time_map_pool(pool, chunks, tasks, config.chunks);
+        }
+        double map_time = best_of(times, config.repeats);
+        task_pool_destroy(pool);
+
+        if (workers == 1) {
+            fib_base = fib_time;
+            map_base = map_time;
+        }
+        char name[32];
+        snprintf(name, sizeof(name), "pool %d", workers);
+        printf("%-14s %12.4f %9.2fx %12.4f %9.2fx\n", name, fib_time, fib_base / fib_time, map_time, map_base / map_time);
+        fflush(stdout);
+        // Bis zur CPU-Anzahl verdoppeln, die Obergrenze selbst immer messen
+        if (workers < config.max_workers && workers * 2 > config.max_workers) {
+            workers = config.max_workers / 2;
+        }
+    }
+
+    long result = 0;
+    for (int r = 0; r < config.repeats; ++r) {
+        times[r] = time_fib_threads(config.fib_n, &result);
+    }
+    double fib_time = best_of(times, config.repeats);
+    for (int r = 0; r < config.repeats; ++r) {
+        times[r] = time_map_threads(chunks, threads, config.chunks);
+    }
+    double map_time = best_of(times, config.repeats);
+    printf("%-14s %12.4f %9.2fx %12.4f %9.2fx\n", "thread/task", fib_time, fib_base / fib_time, map_time, map_base / map_time);
+    if (result != expected) {
+        fprintf(stderr, "fib (Threads) falsch: %ld statt %ld\n", result, expected);
+        return EXIT_FAILURE;
+    }
+
+    free(in);
+    free(out);
+    free(chunks);
+    free(tasks);
+    free(threads);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,239 @@
+// Zugriff auf die cpufreq-Policies (siehe cpufreq.h)
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "cpufreq.h"
+
+static int compare_ulong(const void *a, const void *b) {
+    unsigned long x = *(const unsigned long *)a;
+    unsigned long y = *(const unsigned long *)b;
+    return (x > y) - (x < y);
+}
+
+static int compare_policy(const void *a, const void *b) {
+    return ((const struct cpufreq_policy *)a)->id - ((const struct cpufreq_policy *)b)->id;
+}
+
+int cpufreq_read_attr(const struct cpufreq_policy *policy, const char *attr, char *buf, int len) {
+    char path[PATH_MAX + 64];
+    snprintf(path, sizeof(path), "%s/%s", policy->path, attr);
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) {
+        return -1;
+    }
+    ssize_t bytes_read = read(fd, buf, (size_t)len - 1);
+    close(fd);
+    if (bytes_read < 0) {
+        return -1;
+    }
+    buf[bytes_read] = '\0';
+    buf[strcspn(buf, "\n")] = '\0'; // Newline entfernen
+    return 0;
+}
+
+static int open_attr(const struct cpufreq_policy *policy, const char *attr, int flags) {
+    char path[PATH_MAX + 64];
+    snprintf(path, sizeof(path), "%s/%s", policy->path, attr);
+    return open(path, flags | O_CLOEXEC);
+}
+
+// Liest eine Liste von Zahlen (z.B. affected_cpus, scaling_available_frequencies)
+static int read_list(const struct cpufreq_policy *policy, const char *attr, unsigned long *out, int max) {
+    char buf[2048];
+    if (cpufreq_read_attr(policy, attr, buf, sizeof(buf)) != 0) {
+        return -1;
+    }
+    int count = 0;
+    char *p = buf;
+    while (count < max) {
+        char *end;
+        unsigned long value = strtoul(p, &end, 10);
+        if (end == p) {
+            break;
+        }
+        out[count++] = value;
+        p = end;
+    }
+    return count;
+}
+
+static int load_policy(struct cpufreq_policy *policy) {
+    unsigned long values[CPUFREQ_MAX_CPUS];
+    int count = read_list(policy, "affected_cpus", values, CPUFREQ_MAX_CPUS);
+    if (count <= 0) {
+        fprintf(stderr, "%s: affected_cpus nicht lesbar\n", policy->path);
+        return -1;
+    }
+    policy->num_cpus = count;
+    for (int i = 0; i < count; ++i) {
+        policy->cpus[i] = (int)values[i];
+    }
+
+    count = read_list(policy, "scaling_available_frequencies", policy->freqs, CPUFREQ_MAX_FREQS);
+    if (count <= 0) {
+        // Treiber ohne Frequenztabelle (z.B. intel_pstate): nur Minimum und Maximum verwenden
+        unsigned long min = 0;
+        unsigned long max = 0;
+        if (read_list(policy, "cpuinfo_min_freq", &min, 1) != 1 ||
+            read_list(policy, "cpuinfo_max_freq", &max, 1) != 1) {
+            fprintf(stderr, "%s: keine verfügbaren Frequenzen gefunden\n", policy->path);
+            return -1;
+        }
+        policy->freqs[0] = min;
+        policy->freqs[1] = max;
+        count = min == max ? 1 : 2;
+    }
+    policy->num_freqs = count;
+    qsort(policy->freqs, (size_t)count, sizeof(policy->freqs[0]), compare_ulong);
+
+    policy->setspeed_fd = open_attr(policy, "scaling_setspeed", O_WRONLY);
+    policy->cur_freq_fd = open_attr(policy, "scaling_cur_freq", O_RDONLY);
+    policy->saved_governor[0] = '\0';
+    policy->cur_freq = cpufreq_read_frequency(policy);
+    if (policy->cur_freq == 0) {
+        policy->cur_freq = policy->freqs[policy->num_freqs - 1];
+    }
+    return 0;
+}
+
+int cpufreq_open(struct cpufreq_system *sys, const char *sysfs_root) {
+    char dirpath[PATH_MAX];
+    memset(sys, 0, sizeof(*sys));
+    snprintf(sys->root, sizeof(sys->root), "%s", sysfs_root);
+    snprintf(dirpath, sizeof(dirpath), "%s/devices/system/cpu/cpufreq", sysfs_root);
+
+    DIR *dir = opendir(dirpath);
+    if (dir == NULL) {
+        perror(dirpath);
+        return -1;
+    }
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL && sys->num_policies < CPUFREQ_MAX_POLICIES) {
+        int id;
+        char rest;
+        if (sscanf(entry->d_name, "policy%d%c", &id, &rest) != 1) {
+            continue;
+        }
+        struct cpufreq_policy *policy = &sys->policies[sys->num_policies];
+        policy->id = id;
+        if (snprintf(policy->path, sizeof(policy->path), "%s/%s", dirpath, entry->d_name) >= (int)sizeof(policy->path)) {
+            continue;
+        }
+        if (load_policy(policy) == 0) {
+            sys->num_policies++;
+        }
+    }
+    closedir(dir);
+    if (sys->num_policies == 0) {
+        fprintf(stderr, "Keine cpufreq-Policies unter %s gefunden\n", dirpath);
+        return -1;
+    }
+    qsort(sys->policies, (size_t)sys->num_policies, sizeof(sys->policies[0]), compare_policy);
+    return 0;
+}
+
+void cpufreq_close(struct cpufreq_system *sys) {
+    for (int i = 0; i < sys->num_policies; ++i) {
+        struct cpufreq_policy *policy = &sys->policies[i];
+        if (policy->setspeed_fd != -1) {
+            close(policy->setspeed_fd);
+            policy->setspeed_fd = -1;
+        }
+        if (policy->cur_freq_fd != -1) {
+            close(policy->cur_freq_fd);
+            policy->cur_freq_fd = -1;
+        }
+    }
+}
+
+static int write_attr(const struct cpufreq_policy *policy, const char *attr, const char *value) {
+    int fd = open_attr(policy, attr, O_WRONLY);
+    if (fd == -1) {
+        return -1;
+    }
+    ssize_t len = (ssize_t)strlen(value);
+    ssize_t written = write(fd, value, (size_t)len);
+    close(fd);
+    return written == len ? 0 : -1;
+}
+
+int cpufreq_set_governor(struct cpufreq_policy *policy, const char *governor) {
+    char current[CPUFREQ_GOVERNOR_LEN];
+    if (cpufreq_read_attr(policy, "scaling_governor", current, sizeof(current)) != 0) {
+        perror("Failed to read scaling_governor");
+        return -1;
+    }
+    if (strcmp(current, governor) == 0) {
+        return 0;
+    }
+    char value[CPUFREQ_GOVERNOR_LEN + 1];
+    snprintf(value, sizeof(value), "%s\n", governor);
+    if (write_attr(policy, "scaling_governor", value) != 0) {
+        perror("Failed to write scaling_governor");
+        return -1;
+    }
+    // Nur den ursprünglichen Governor merken, nicht einen Zwischenstand
+    if (policy->saved_governor[0] == '\0') {
+        snprintf(policy->saved_governor, sizeof(policy->saved_governor), "%s", current);
+    }
+    return 0;
+}
+
+void cpufreq_restore_governors(struct cpufreq_system *sys) {
+    for (int i = 0; i < sys->num_policies; ++i) {
+        struct cpufreq_policy *policy = &sys->policies[i];
+        if (policy->saved_governor[0] == '\0') {
+            continue;
+        }
+        char value[CPUFREQ_GOVERNOR_LEN + 1];
+        snprintf(value, sizeof(value), "%s\n", policy->saved_governor);
+        if (write_attr(policy, "scaling_governor", value) != 0) {
+            fprintf(stderr, "policy%d: Governor %s konnte nicht wiederhergestellt werden\n",
+                    policy->id, policy->saved_governor);
+        }
+        policy->saved_governor[0] = '\0';
+    }
+}
+
+int cpufreq_set_frequency(struct cpufreq_policy *policy, unsigned long khz) {
+    if (policy->setspeed_fd == -1) {
+        errno = ENOENT;
+        return -1;
+    }
+    // Mit Newline schreiben: sysfs ignoriert sie, ein nachgebauter Baum bleibt zeilenweise lesbar
+    char value[32];
+    int len = snprintf(value, sizeof(value), "%lu\n", khz);
+    if (pwrite(policy->setspeed_fd, value, (size_t)len, 0) != len) {
+        return -1;
+    }
+    policy->cur_freq = khz;
+    return 0;
+}
+
+unsigned long cpufreq_read_frequency(struct cpufreq_policy *policy) {
+    char buf[32];
+    if (policy->cur_freq_fd == -1) {
+        return 0;
+    }
+    ssize_t bytes_read = pread(policy->cur_freq_fd, buf, sizeof(buf) - 1, 0);
+    if (bytes_read <= 0) {
+        return 0;
+    }
+    buf[bytes_read] = '\0';
+    return strtoul(buf, NULL, 10);
+}
+
+unsigned long cpufreq_ceil_frequency(const struct cpufreq_policy *policy, unsigned long khz) {
+    for (int i = 0; i < policy->num_freqs; ++i) {
+        if (policy->freqs[i] >= khz) {
+            return policy->freqs[i];
+        }
+    }
+    return policy->freqs[policy->num_freqs - 1];
+}
@@ -0,0 +1,65 @@
+#ifndef CPUFREQ_H
+#define CPUFREQ_H
+
+#include <limits.h>
+
+/*
+Zugriff auf die cpufreq-Policies unter <sysfs>/devices/system/cpu/cpufreq/policyN.
+
+Jede Policy ist eine Takt-Domäne (z.B. ein Cluster), deren CPUs sich eine Frequenz teilen.
+Die Dateideskriptoren für scaling_setspeed und scaling_cur_freq bleiben während der gesamten
+Laufzeit offen; Frequenzwechsel sind damit ein einzelnes pwrite() ohne open/close.
+
+Das sysfs-Wurzelverzeichnis ist frei wählbar, damit sich alles gegen einen nachgebauten
+Verzeichnisbaum (z.B. in einem tmpdir) testen lässt.
+*/
+
+#define CPUFREQ_MAX_POLICIES 16
+#define CPUFREQ_MAX_CPUS 64
+#define CPUFREQ_MAX_FREQS 64
+#define CPUFREQ_GOVERNOR_LEN 32
+
+struct cpufreq_policy {
+    int id;                                   // N aus policyN
+    char path[PATH_MAX];                      // .../cpufreq/policyN
+    int cpus[CPUFREQ_MAX_CPUS];               // affected_cpus
+    int num_cpus;
+    unsigned long freqs[CPUFREQ_MAX_FREQS];   // verfügbare Frequenzen in kHz, aufsteigend
+    int num_freqs;
+    int setspeed_fd;                          // scaling_setspeed (O_WRONLY), -1 wenn nicht verfügbar
+    int cur_freq_fd;                          // scaling_cur_freq (O_RDONLY), -1 wenn nicht verfügbar
+    unsigned long cur_freq;                   // zuletzt gesetzte bzw. gelesene Frequenz in kHz
+    char saved_governor[CPUFREQ_GOVERNOR_LEN];// Governor vor dem Umschalten, leer wenn unverändert
+};
+
+struct cpufreq_system {
+    char root[PATH_MAX];
+    struct cpufreq_policy policies[CPUFREQ_MAX_POLICIES];
+    int num_policies;
+};
+
+// Findet alle Policies unter sysfs_root und öffnet deren Dateien; 0 bei Erfolg
+int cpufreq_open(struct cpufreq_system *sys, const char *sysfs_root);
+
+// Schließt alle Dateideskriptoren (ohne den Governor zurückzusetzen)
+void cpufreq_close(struct cpufreq_system *sys);
+
+// Schaltet auf einen Governor um und merkt sich den vorherigen; 0 bei Erfolg
+int cpufreq_set_governor(struct cpufreq_policy *policy, const char *governor);
+
+// Stellt die gemerkten Governor aller Policies wieder her
+void cpufreq_restore_governors(struct cpufreq_system *sys);
+
+// Setzt die Frequenz (kHz) per pwrite auf den offenen scaling_setspeed-Deskriptor; 0 bei Erfolg
+int cpufreq_set_frequency(struct cpufreq_policy *policy, unsigned long khz);
+
+// Liest scaling_cur_freq über den offenen Deskriptor; 0 wenn nicht lesbar
+unsigned long cpufreq_read_frequency(struct cpufreq_policy *policy);
+
+// Liest eine Attributdatei der Policy als Text (ohne Newline); 0 bei Erfolg
+int cpufreq_read_attr(const struct cpufreq_policy *policy, const char *attr, char *buf, int len);
+
+// Kleinste verfügbare Frequenz >= khz (bzw. die höchste, wenn keine größer ist)
+unsigned long cpufreq_ceil_frequency(const struct cpufreq_policy *policy, unsigned long khz);
+
+#endif
@@ -16,183 +16,376 @@ Anforderung:
     Auswirkungen deiner Änderungen zu bewerten.
 ----------------------------------------------------------------------------------------------*/
 // Code:
+//
+// Umsetzung als Governor-Daemon:
+// - tastet die Last jeder CPU aus /proc/stat mit einstellbarer Rate ab (governor.c)
+// - behandelt jede cpufreq-Policy (Takt-Domäne/Cluster) getrennt
+// - hält die sysfs-Deskriptoren aller Policies offen und schreibt per pwrite (cpufreq.c)
+// - wählt die Frequenz mit Hysterese aus scaling_available_frequencies
+// - Deadline-Hook (-b): RT-Tasks veröffentlichen ihren Schlupf im Shared Memory (rt_slack.h);
+//   die Frequenz bleibt über der Untergrenze, die den Schlupf über der Marge hält, und
+//   springt nach einem Überlauf sofort auf das Maximum (slack_boost.c); der Überlauf weckt
+//   den Governor per Futex, ohne auf die nächste Abtastung zu warten
+// - Sweep-Modus (-S): misst je Frequenz Laufzeit, Instruktionen/Zyklen und RAPL-Energie
+//   eines CPU- und eines speichergebundenen Kernels und gibt CSV aus (sweep.c)
+// Die Spannung folgt der Frequenz über die OPP-Tabelle des Kernels; ein eigenes
+// scaling_setvoltage gibt es im Mainline-Kernel nicht.
+//
+// Verwendung: ./dvfs [-r sysfs_root] [-s stat_datei] [-i intervall_ms] [-n abtastungen]
+//                    [-u up_schwelle] [-d down_schwelle] [-D down_verzoegerung] [-k] [-I] [-v]
+//                    [-b] [-m marge] [-H boost_abtastungen]
+//        ./dvfs -S [-r sysfs_root] [-p policy] [-c cpu_mio] [-M mem_mio] [-B puffer_mib]
+//                  [-R wiederholungen] [-o datei.csv] [-k]
+//   -k  Governor nicht auf "userspace" umschalten (z.B. wenn bereits gesetzt)
+//   -I  nur Policy-Informationen anzeigen und beenden
+//   -v  jede Abtastung ausgeben
+//   -b  Schlupf der RT-Tasks aus /dev/shm/rt_slack berücksichtigen; -m = Sicherheitsmarge als
+//       Anteil der Periode (Standard 0.2), -H = Abtastungen auf Maximum nach einem Überlauf
+//   -S  Frequenz-Sweep der Policy -p (Standard: erste Policy); -c/-M = Mio. Iterationen des
+//       CPU-/Speicher-Kernels (0 = auslassen), -B = Puffergröße, -R = Wiederholungen (Median)
 
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE // syscall (Futex in rt_slack.h)
+
+#include <errno.h>
+#include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
-#include <unistd.h>
-#include <fcntl.h>
-#include <errno.h>
 #include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "cpufreq.h"
+#include "governor.h"
+#include "slack_boost.h"
+#include "sweep.h"
+#include "metrics.h"
 
-// Funktion zur Anpassung der CPU-Frequenz und -Spannung
-void set_cpu_dvfs(const char *freq, const char *voltage) {
-    int fd;
-    
-    // Setzen der CPU-Frequenz
-    fd = open("/sys/devices/system/cpu/cpu0/cpufreq/scaling_setspeed", O_WRONLY);
-    if (fd == -1) {
-        perror("Failed to open scaling_setspeed");
-        exit(EXIT_FAILURE);
-    }
-    
-    if (write(fd, freq, strlen(freq)) == -1) {
-        perror("Failed to write to scaling_setspeed");
-        close(fd);
-        exit(EXIT_FAILURE);
-    }
-    
-    close(fd);
-    
-    // Setzen der CPU-Spannung (Beispielpfad, je nach Plattform anpassen)
-    fd = open("/sys/devices/system/cpu/cpu0/cpufreq/scaling_setvoltage", O_WRONLY);
-    if (fd == -1) {
-        perror("Failed to open scaling_setvoltage");
-        exit(EXIT_FAILURE);
-    }
-    
-    if (write(fd, voltage, strlen(voltage)) == -1) {
-        perror("Failed to write to scaling_setvoltage");
-        close(fd);
-        exit(EXIT_FAILURE);
-    }
-    
-    close(fd);
+static volatile sig_atomic_t running = 1;
+
+static void handle_signal(int sig) {
+    (void)sig;
+    running = 0;
 }
 
-// Funktion zum Lesen der aktuellen CPU-Frequenz
-void get_cpu_frequency() {
-    int fd;
-    char buffer[256];
-    ssize_t bytes_read;
-    
-    // Lesen der aktuellen CPU-Frequenz
-    fd = open("/sys/devices/system/cpu/cpu0/cpufreq/scaling_cur_freq", O_RDONLY);
-    if (fd == -1) {
-        perror("Failed to open scaling_cur_freq");
+// Funktion zur Anzeige von Frequenzen, Governor und CPUs jeder Policy
+static void print_policy_info(struct cpufreq_system *sys) {
+    for (int i = 0; i < sys->num_policies; ++i) {
+        struct cpufreq_policy *policy = &sys->policies[i];
+        char governor[CPUFREQ_GOVERNOR_LEN] = "?";
+        cpufreq_read_attr(policy, "scaling_governor", governor, sizeof(governor));
+        printf("policy%d: CPUs", policy->id);
+        for (int c = 0; c < policy->num_cpus; ++c) {
+            printf(" %d", policy->cpus[c]);
+        }
+        printf(", Governor %s, aktuell %lu kHz\n  Verfügbare Frequenzen:", governor,
+               cpufreq_read_frequency(policy));
+        for (int f = 0; f < policy->num_freqs; ++f) {
+            printf(" %lu", policy->freqs[f]);
+        }
+        printf("\n");
+        if (policy->setspeed_fd == -1) {
+            printf("  Hinweis: scaling_setspeed nicht beschreibbar (Root-Rechte / userspace-Governor?)\n");
+        }
+    }
+}
+
+// Kennzahlen für metrics_collector (../metrics); je Policy Last und Frequenz als Gauge
+struct dvfs_metrics {
+    struct metric *samples;
+    struct metric *transitions;
+    struct metric *write_errors;
+    struct metric *overrun_wakeups;
+    struct metric *load[CPUFREQ_MAX_POLICIES];
+    struct metric *frequency[CPUFREQ_MAX_POLICIES];
+};
+
+static void setup_metrics(struct dvfs_metrics *m, const struct cpufreq_system *sys) {
+    memset(m, 0, sizeof(*m));
+    if (metrics_init("dvfs") != 0) {
+        perror("Hinweis: Kennzahlen nicht verfügbar");
         return;
     }
-    
-    bytes_read = read(fd, buffer, sizeof(buffer) - 1);
-    if (bytes_read == -1) {
-        perror("Failed to read scaling_cur_freq");
-        close(fd);
+    m->samples = metrics_counter("dvfs_samples_total", "Abtastungen des Governors");
+    m->transitions = metrics_counter("dvfs_frequency_transitions_total", "Frequenzwechsel aller Policies");
+    m->write_errors = metrics_counter("dvfs_write_errors_total", "Fehlgeschlagene Schreibzugriffe auf scaling_setspeed");
+    m->overrun_wakeups = metrics_counter("dvfs_overrun_wakeups_total", "Sofortige Anhebungen nach einem RT-Überlauf");
+    // Eine Familie pro Größe, die Policy als Label: Prometheus kann über Policies zusammenfassen
+    for (int i = 0; i < sys->num_policies; ++i) {
+        char labels[METRICS_LABELS_LEN];
+        snprintf(labels, sizeof(labels), "policy=\"%d\"", sys->policies[i].id);
+        m->load[i] = metrics_gauge_labeled("dvfs_load_ratio", labels, "Last der Policy (0..1)");
+        m->frequency[i] = metrics_gauge_labeled("dvfs_frequency_hertz", labels, "Gesetzte Frequenz der Policy");
+    }
+}
+
+// Fehler melden, aber weiterregeln: die nächste Abtastung versucht es erneut
+static void apply_frequency(struct cpufreq_policy *policy, unsigned long freq, struct dvfs_metrics *metrics,
+                            long *transitions) {
+    if (freq == policy->cur_freq) {
         return;
     }
-    
-    buffer[bytes_read] = '\0'; // Null-Terminierung des Strings
-    printf("Aktuelle CPU-Frequenz: %s Hz\n", buffer);
-    close(fd);
+    if (cpufreq_set_frequency(policy, freq) != 0) {
+        perror("Failed to write scaling_setspeed");
+        metrics_inc(metrics->write_errors);
+    } else {
+        (*transitions)++;
+        metrics_inc(metrics->transitions);
+    }
 }
 
-// Funktion zum Lesen der aktuellen CPU-Spannung
-void get_cpu_voltage() {
-    int fd;
-    char buffer[256];
-    ssize_t bytes_read;
-    
-    // Versuch, die aktuelle CPU-Spannung zu lesen (Pfad kann je nach Plattform variieren)
-    fd = open("/sys/devices/system/cpu/cpu0/cpufreq/scaling_cur_voltage", O_RDONLY);
-    if (fd == -1) {
-        // Alternativer Pfad für einige Systeme
-        fd = open("/sys/class/regulator/regulator.0/microvolts", O_RDONLY);
-        if (fd == -1) {
-            printf("CPU-Spannungsinformationen sind auf diesem System nicht verfügbar\n");
+// Wartet bis zur nächsten Abtastung. Mit Deadline-Hook weckt ein Überlauf den Governor sofort:
+// betroffene Policies gehen dann auf die Untergrenze (nach Überlauf das Maximum), die
+// Lastabtastung selbst bleibt im Takt
+static void wait_for_sample(const struct timespec *next, struct rt_slack_segment *slack_seg,
+                            struct slack_monitor *monitor, struct cpufreq_system *sys,
+                            struct dvfs_metrics *metrics, long *transitions, int verbose) {
+    uint32_t seen = slack_seg != NULL ? rt_slack_overrun_seq(slack_seg) : 0;
+    while (running && slack_seg != NULL) {
+        int err = rt_slack_wait_overrun(slack_seg, seen, next);
+        if (err == ETIMEDOUT) {
             return;
         }
+        if (err != 0 && err != EINTR) {
+            break; // Futex nicht verfügbar: wie ohne Hook bis zur Abtastung schlafen
+        }
+        uint32_t seq = rt_slack_overrun_seq(slack_seg);
+        if (seq == seen || !slack_monitor_check_overruns(monitor)) {
+            seen = seq;
+            continue;
+        }
+        seen = seq;
+        metrics_inc(metrics->overrun_wakeups);
+        for (int i = 0; i < sys->num_policies; ++i) {
+            struct cpufreq_policy *policy = &sys->policies[i];
+            unsigned long cur = policy->cur_freq;
+            unsigned long floor = slack_monitor_floor(monitor, policy, cur);
+            if (floor > cur) {
+                apply_frequency(policy, floor, metrics, transitions);
+                if (verbose) {
+                    printf("policy%d: Überlauf, %lu -> %lu kHz\n", policy->id, cur, floor);
+                    fflush(stdout);
+                }
+            }
+        }
     }
-    
-    bytes_read = read(fd, buffer, sizeof(buffer) - 1);
-    if (bytes_read == -1) {
-        perror("Failed to read voltage");
-        close(fd);
-        return;
+    while (running && clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, next, NULL) == EINTR) {
     }
-    
-    buffer[bytes_read] = '\0'; // Null-Terminierung des Strings
-    printf("Aktuelle CPU-Spannung: %s mV\n", buffer);
-    close(fd);
 }
 
-// Funktion zur Anzeige der verfügbaren CPU-Frequenzen
-void get_available_frequencies() {
-    int fd;
-    char buffer[1024];
-    ssize_t bytes_read;
-    
-    fd = open("/sys/devices/system/cpu/cpu0/cpufreq/scaling_available_frequencies", O_RDONLY);
-    if (fd == -1) {
-        perror("Failed to open scaling_available_frequencies");
-        return;
+static void timespec_add_ms(struct timespec *ts, long ms) {
+    ts->tv_sec += ms / 1000;
+    ts->tv_nsec += (ms % 1000) * 1000000L;
+    if (ts->tv_nsec >= 1000000000L) {
+        ts->tv_sec += 1;
+        ts->tv_nsec -= 1000000000L;
     }
-    
-    bytes_read = read(fd, buffer, sizeof(buffer) - 1);
-    if (bytes_read == -1) {
-        perror("Failed to read scaling_available_frequencies");
-        close(fd);
-        return;
-    }
-    
-    buffer[bytes_read] = '\0';
-    printf("Verfügbare CPU-Frequenzen: %s", buffer);
-    close(fd);
 }
 
-// Funktion zur Anzeige des aktuellen CPU-Governors
-void get_cpu_governor() {
-    int fd;
-    char buffer[256];
-    ssize_t bytes_read;
-    
-    fd = open("/sys/devices/system/cpu/cpu0/cpufreq/scaling_governor", O_RDONLY);
-    if (fd == -1) {
-        perror("Failed to open scaling_governor");
-        return;
+// Sweep-Modus: eine Policy über alle Frequenzen messen, danach Governor wiederherstellen
+static int run_sweep(struct cpufreq_system *sys, int policy_id, const struct sweep_params *params,
+                     const char *csv_path, int keep_governor) {
+    struct cpufreq_policy *policy = &sys->policies[0];
+    if (policy_id >= 0) {
+        policy = NULL;
+        for (int i = 0; i < sys->num_policies; ++i) {
+            if (sys->policies[i].id == policy_id) {
+                policy = &sys->policies[i];
+            }
+        }
+        if (policy == NULL) {
+            fprintf(stderr, "policy%d nicht gefunden\n", policy_id);
+            cpufreq_close(sys);
+            return EXIT_FAILURE;
+        }
     }
-    
-    bytes_read = read(fd, buffer, sizeof(buffer) - 1);
-    if (bytes_read == -1) {
-        perror("Failed to read scaling_governor");
-        close(fd);
-        return;
+    FILE *out = stdout;
+    if (csv_path != NULL && (out = fopen(csv_path, "w")) == NULL) {
+        perror(csv_path);
+        cpufreq_close(sys);
+        return EXIT_FAILURE;
+    }
+    if (!keep_governor && cpufreq_set_governor(policy, "userspace") != 0) {
+        fprintf(stderr, "policy%d: userspace-Governor nicht verfügbar\n", policy->id);
     }
-    
-    buffer[bytes_read] = '\0';
-    printf("Aktueller CPU-Governor: %s", buffer);
-    close(fd);
+    int status = sweep_run(sys, policy, params, out);
+    if (out != stdout) {
+        fclose(out);
+    }
+    cpufreq_restore_governors(sys);
+    cpufreq_close(sys);
+    return status == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Verwendung: %s [-r sysfs_root] [-s stat_datei] [-i intervall_ms] [-n abtastungen]\n"
+            "            [-u up_schwelle] [-d down_schwelle] [-D down_verzoegerung] [-k] [-I] [-v]\n"
+            "            [-b] [-m marge] [-H boost_abtastungen]\n"
+            "       %s -S [-r sysfs_root] [-p policy] [-c cpu_mio] [-M mem_mio] [-B puffer_mib]\n"
+            "            [-R wiederholungen] [-o datei.csv] [-k]\n", prog, prog);
 }
 
-int main() {
+int main(int argc, char *argv[]) {
+    const char *sysfs_root = "/sys";
+    const char *stat_path = "/proc/stat";
+    long interval_ms = 100;
+    long samples = 0; // 0 = bis SIGINT/SIGTERM
+    int keep_governor = 0;
+    int info_only = 0;
+    int verbose = 0;
+    int sweep = 0;
+    int slack_hook = 0;
+    double slack_margin = 0.2;
+    int boost_hold = 10;
+    int sweep_policy = -1;
+    const char *csv_path = NULL;
+    struct sweep_params sweep_params = {
+        .cpu_iterations = 200000000L,
+        .mem_accesses = 20000000L,
+        .mem_buffer_bytes = 64L << 20,
+        .repeats = 3,
+        .settle_ms = 50,
+    };
+    struct governor_params params = {
+        .up_threshold = 0.80,
+        .down_threshold = 0.30,
+        .down_delay = 5,
+        .headroom = 1.25,
+    };
+    int opt;
+
+    while ((opt = getopt(argc, argv, "r:s:i:n:u:d:D:kIvbm:H:Sp:c:M:B:R:o:h")) != -1) {
+        switch (opt) {
+        case 'r': sysfs_root = optarg; break;
+        case 's': stat_path = optarg; break;
+        case 'i': interval_ms = atol(optarg); break;
+        case 'n': samples = atol(optarg); break;
+        case 'u': params.up_threshold = atof(optarg); break;
+        case 'd': params.down_threshold = atof(optarg); break;
+        case 'D': params.down_delay = atoi(optarg); break;
+        case 'k': keep_governor = 1; break;
+        case 'I': info_only = 1; break;
+        case 'v': verbose = 1; break;
+        case 'b': slack_hook = 1; break;
+        case 'm': slack_margin = atof(optarg); break;
+        case 'H': boost_hold = atoi(optarg); break;
+        case 'S': sweep = 1; break;
+        case 'p': sweep_policy = atoi(optarg); break;
+        case 'c': sweep_params.cpu_iterations = (long)(atof(optarg) * 1e6); break;
+        case 'M': sweep_params.mem_accesses = (long)(atof(optarg) * 1e6); break;
+        case 'B': sweep_params.mem_buffer_bytes = atol(optarg) << 20; break;
+        case 'R': sweep_params.repeats = atoi(optarg); break;
+        case 'o': csv_path = optarg; break;
+        default: usage(argv[0]); return opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if (interval_ms <= 0 || params.down_threshold >= params.up_threshold) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    struct cpufreq_system sys;
+    if (cpufreq_open(&sys, sysfs_root) != 0) {
+        return EXIT_FAILURE;
+    }
+    if (sweep) {
+        return run_sweep(&sys, sweep_policy, &sweep_params, csv_path, keep_governor);
+    }
     printf("=== DVFS System Information ===\n");
-    
-    // Display current system state before any changes
-    printf("\n--- Initial System State ---\n");
-    get_cpu_frequency();
-    get_cpu_voltage();
-    get_cpu_governor();
-    
-    printf("\n--- Available Options ---\n");
-    get_available_frequencies();
-    
-    printf("\n=== Starting DVFS Optimization ===\n");
-
-    // Example: Set low frequency and voltage
-    printf("\nSetting low power mode (800MHz)...\n");
-    set_cpu_dvfs("800000", "800000");
-    
-    // Check current state after change
-    printf("After setting low power mode:\n");
-    get_cpu_frequency();
-    get_cpu_voltage();
-
-    // Example: Set high frequency and voltage
-    printf("\nSetting high performance mode (1.6GHz)...\n");
-    set_cpu_dvfs("1600000", "1200000");
-    
-    // Check current state after change
-    printf("After setting high performance mode:\n");
-    get_cpu_frequency();
-    get_cpu_voltage();
-
-    printf("\nDVFS optimization complete.\n");
-    return 0;
+    print_policy_info(&sys);
+    if (info_only) {
+        cpufreq_close(&sys);
+        return EXIT_SUCCESS;
+    }
+
+    struct load_sampler sampler;
+    if (load_sampler_open(&sampler, stat_path) != 0) {
+        cpufreq_close(&sys);
+        return EXIT_FAILURE;
+    }
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = handle_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    // scaling_setspeed wirkt nur mit dem userspace-Governor
+    if (!keep_governor) {
+        for (int i = 0; i < sys.num_policies; ++i) {
+            if (cpufreq_set_governor(&sys.policies[i], "userspace") != 0) {
+                fprintf(stderr, "policy%d: userspace-Governor nicht verfügbar\n", sys.policies[i].id);
+            }
+        }
+    }
+
+    struct slack_monitor monitor;
+    struct rt_slack_segment *slack_seg = NULL;
+    if (slack_hook) {
+        slack_seg = rt_slack_attach(RT_SLACK_SHM_NAME, 1);
+        if (slack_seg == NULL) {
+            perror("Failed to attach " RT_SLACK_SHM_NAME);
+        } else {
+            slack_monitor_init(&monitor, slack_seg, slack_margin, boost_hold);
+            rt_slack_set_waiting(slack_seg, 1);
+        }
+    }
+
+    struct governor_state states[CPUFREQ_MAX_POLICIES];
+    memset(states, 0, sizeof(states));
+    long transitions = 0;
+    struct dvfs_metrics metrics;
+    setup_metrics(&metrics, &sys);
+
+    printf("\n=== Starte DVFS-Governor (Intervall %ld ms) ===\n", interval_ms);
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    for (long n = 0; running && (samples == 0 || n < samples); ++n) {
+        timespec_add_ms(&next, interval_ms);
+        wait_for_sample(&next, slack_seg, &monitor, &sys, &metrics, &transitions, verbose);
+        if (!running || load_sampler_update(&sampler) != 0) {
+            continue;
+        }
+        metrics_inc(metrics.samples);
+        if (slack_seg != NULL) {
+            struct timespec now;
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            slack_monitor_sample(&monitor, (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec);
+        }
+        for (int i = 0; i < sys.num_policies; ++i) {
+            struct cpufreq_policy *policy = &sys.policies[i];
+            double load = governor_policy_load(&sampler, policy);
+            unsigned long cur = policy->cur_freq;
+            unsigned long freq = governor_select(&params, &states[i], policy, cur, load);
+            if (slack_seg != NULL) {
+                unsigned long floor = slack_monitor_floor(&monitor, policy, cur);
+                if (floor > freq) {
+                    freq = floor;
+                }
+            }
+            apply_frequency(policy, freq, &metrics, &transitions);
+            metrics_set(metrics.load[i], load);
+            metrics_set(metrics.frequency[i], (double)policy->cur_freq * 1000.0);
+            if (verbose) {
+                printf("policy%d: Last %5.1f%%  %lu -> %lu kHz\n", policy->id, load * 100.0, cur, freq);
+            }
+        }
+        if (verbose) {
+            fflush(stdout);
+        }
+    }
+
+    printf("\nDVFS-Governor beendet, %ld Frequenzwechsel.\n", transitions);
+    for (int i = 0; i < sys.num_policies; ++i) {
+        printf("policy%d: %lu kHz\n", sys.policies[i].id, sys.policies[i].cur_freq);
+    }
+    cpufreq_restore_governors(&sys);
+    cpufreq_close(&sys);
+    load_sampler_close(&sampler);
+    if (slack_seg != NULL) {
+        rt_slack_set_waiting(slack_seg, 0);
+        rt_slack_detach(slack_seg);
+    }
+    metrics_shutdown();
+    return EXIT_SUCCESS;
 }
@@ -0,0 +1,118 @@
+// Lastgesteuerter Userspace-Governor (siehe governor.h)
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "governor.h"
+
+#define STAT_BUFFER_SIZE 65536
+
+int load_sampler_open(struct load_sampler *sampler, const char *stat_path) {
+    memset(sampler, 0, sizeof(*sampler));
+    sampler->fd = open(stat_path, O_RDONLY | O_CLOEXEC);
+    if (sampler->fd == -1) {
+        perror(stat_path);
+        return -1;
+    }
+    if (load_sampler_update(sampler) != 0) {
+        load_sampler_close(sampler);
+        return -1;
+    }
+    // Die erste Abtastung liefert nur Startwerte, keine Last
+    memset(sampler->load, 0, sizeof(sampler->load));
+    return 0;
+}
+
+int load_sampler_update(struct load_sampler *sampler) {
+    static char buffer[STAT_BUFFER_SIZE];
+    ssize_t bytes_read = pread(sampler->fd, buffer, sizeof(buffer) - 1, 0);
+    if (bytes_read < 0) {
+        perror("Failed to read cpu statistics");
+        return -1;
+    }
+    if (bytes_read == 0) {
+        return -1; // Leere Datei (nachgebauter Baum wird gerade neu geschrieben)
+    }
+    buffer[bytes_read] = '\0';
+
+    // Zeilen "cpuN user nice system idle iowait irq softirq steal ..."
+    char *line = buffer;
+    while (line != NULL && *line != '\0') {
+        char *next = strchr(line, '\n');
+        if (next != NULL) {
+            *next++ = '\0';
+        }
+        int cpu;
+        unsigned long long v[8] = {0};
+        if (sscanf(line, "cpu%d %llu %llu %llu %llu %llu %llu %llu %llu", &cpu,
+                   &v[0], &v[1], &v[2], &v[3], &v[4], &v[5], &v[6], &v[7]) >= 5 &&
+            cpu >= 0 && cpu < CPUFREQ_MAX_CPUS) {
+            unsigned long long total = v[0] + v[1] + v[2] + v[3] + v[4] + v[5] + v[6] + v[7];
+            unsigned long long idle = v[3] + v[4];
+            unsigned long long busy = total - idle;
+            unsigned long long d_total = total - sampler->prev_total[cpu];
+            unsigned long long d_busy = busy - sampler->prev_busy[cpu];
+            sampler->load[cpu] = (d_total > 0 && d_busy <= d_total) ? (double)d_busy / (double)d_total : 0.0;
+            sampler->prev_total[cpu] = total;
+            sampler->prev_busy[cpu] = busy;
+            if (cpu + 1 > sampler->num_cpus) {
+                sampler->num_cpus = cpu + 1;
+            }
+        }
+        line = next;
+    }
+    return 0;
+}
+
+void load_sampler_close(struct load_sampler *sampler) {
+    if (sampler->fd != -1) {
+        close(sampler->fd);
+        sampler->fd = -1;
+    }
+}
+
+double governor_policy_load(const struct load_sampler *sampler, const struct cpufreq_policy *policy) {
+    double max = 0.0;
+    for (int i = 0; i < policy->num_cpus; ++i) {
+        int cpu = policy->cpus[i];
+        if (cpu < sampler->num_cpus && sampler->load[cpu] > max) {
+            max = sampler->load[cpu];
+        }
+    }
+    return max;
+}
+
+// Index der höchsten Stufe <= khz
+static int freq_index(const struct cpufreq_policy *policy, unsigned long khz) {
+    int index = 0;
+    while (index + 1 < policy->num_freqs && policy->freqs[index + 1] <= khz) {
+        index++;
+    }
+    return index;
+}
+
+unsigned long governor_select(const struct governor_params *params, struct governor_state *state,
+                              const struct cpufreq_policy *policy, unsigned long cur_freq, double load) {
+    unsigned long needed = (unsigned long)((double)cur_freq * load * params->headroom);
+    unsigned long target = cpufreq_ceil_frequency(policy, needed);
+
+    if (load >= params->up_threshold) {
+        int next = freq_index(policy, cur_freq) + 1;
+        if (next < policy->num_freqs && policy->freqs[next] > target) {
+            target = policy->freqs[next];
+        }
+    }
+    if (target >= cur_freq) {
+        state->down_count = 0;
+        return target;
+    }
+    // Herunterschalten nur nach anhaltend niedrigerem Ziel, bei (fast) Leerlauf sofort
+    if (load > params->down_threshold && ++state->down_count < params->down_delay) {
+        return cur_freq;
+    }
+    state->down_count = 0;
+    return target;
+}
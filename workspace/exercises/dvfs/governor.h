@@ -0,0 +1,55 @@
+#ifndef GOVERNOR_H
+#define GOVERNOR_H
+
+#include "cpufreq.h"
+
+/*
+Lastgesteuerter Userspace-Governor.
+
+Die Last jeder CPU wird aus /proc/stat als Anteil der Nicht-Leerlaufzeit zwischen zwei
+Abtastungen berechnet. Pro Policy zählt die am stärksten belastete CPU der Domäne.
+
+Frequenzwahl mit Hysterese:
+- benötigte Frequenz = aktuelle Frequenz * Last * headroom, aufgerundet auf die nächste
+  verfügbare Stufe
+- Last >= up_threshold: mindestens eine Stufe höher, sofort
+- höhere Zielfrequenz: sofort übernehmen
+- niedrigere Zielfrequenz: erst wenn das Ziel down_delay Abtastungen in Folge niedriger
+  lag (verhindert Pendeln bei schwankender Last); bei Last <= down_threshold sofort
+*/
+
+struct load_sampler {
+    int fd;                                               // /proc/stat, bleibt offen
+    int num_cpus;                                         // höchste gesehene CPU-Nummer + 1
+    unsigned long long prev_busy[CPUFREQ_MAX_CPUS];
+    unsigned long long prev_total[CPUFREQ_MAX_CPUS];
+    double load[CPUFREQ_MAX_CPUS];                        // 0.0 - 1.0 seit der letzten Abtastung
+};
+
+struct governor_params {
+    double up_threshold;     // z.B. 0.80
+    double down_threshold;   // z.B. 0.30, darunter ohne Verzögerung herunterschalten
+    int down_delay;          // Abtastungen mit niedrigerem Ziel vor dem Herunterschalten
+    double headroom;         // Reserve auf die benötigte Frequenz, z.B. 1.25
+};
+
+struct governor_state {
+    int down_count;          // aufeinanderfolgende Abtastungen mit niedrigerem Ziel
+};
+
+// Öffnet die Statistikdatei (normalerweise /proc/stat) und nimmt die erste Abtastung; 0 bei Erfolg
+int load_sampler_open(struct load_sampler *sampler, const char *stat_path);
+
+// Liest die Statistik erneut und aktualisiert load[]; 0 bei Erfolg
+int load_sampler_update(struct load_sampler *sampler);
+
+void load_sampler_close(struct load_sampler *sampler);
+
+// Höchste Last aller CPUs der Policy
+double governor_policy_load(const struct load_sampler *sampler, const struct cpufreq_policy *policy);
+
+// Wählt die nächste Frequenz der Policy für die gemessene Last
+unsigned long governor_select(const struct governor_params *params, struct governor_state *state,
+                              const struct cpufreq_policy *policy, unsigned long cur_freq, double load);
+
+#endif
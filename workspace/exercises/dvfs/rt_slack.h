@@ -0,0 +1,160 @@
+#ifndef RT_SLACK_H
+#define RT_SLACK_H
+
+/*
+Shared-Memory-Schnittstelle zwischen Echtzeit-Tasks und dem DVFS-Governor.
+
+Jeder RT-Task belegt einen Slot und veröffentlicht nach jedem Job seinen Schlupf
+(Deadline - Fertigstellungszeit, negativ bei Überlauf). Der Governor liest die Slots bei jeder
+Abtastung und wählt die niedrigste Frequenz, bei der der Schlupf über einer Sicherheitsmarge
+bleibt; nach einem Überlauf schaltet er sofort auf die Höchstfrequenz.
+
+Alle Felder sind Einzelwerte mit atomarem Zugriff, es gibt keine Sperren: ein RT-Task wird
+vom Governor nie blockiert. window_min_slack_ns ist der kleinste Schlupf seit der letzten
+Abtastung; der Task senkt ihn per CAS, der Governor setzt ihn per Exchange zurück.
+
+Damit ein Überlauf nicht erst bei der nächsten Abtastung auffällt, wartet der Governor
+zwischen den Abtastungen per Futex auf overrun_seq. Ein Task erhöht overrun_seq bei jedem
+Überlauf und ruft FUTEX_WAKE nur auf, wenn ein Governor wartet (waiters > 0) - ohne Überlauf
+bleibt rt_slack_publish ohne Systemaufruf.
+
+Header-only, damit realtime_task ohne zusätzliche Bibliothek einbinden kann (-pthread -lrt).
+*/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <linux/futex.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h> // syscall: _DEFAULT_SOURCE oder _GNU_SOURCE beim Einbinden
+
+#define RT_SLACK_SHM_NAME "/rt_slack"
+#define RT_SLACK_MAGIC 0x52544c4bU // "RTLK"
+#define RT_SLACK_MAX_TASKS 32
+#define RT_SLACK_NONE INT64_MAX     // kein Job seit der letzten Abtastung
+
+struct rt_slack_task {
+    _Atomic int32_t pid;               // 0 = Slot frei
+    _Atomic int32_t cpu;               // CPU des Tasks, -1 = beliebig
+    _Atomic uint64_t period_ns;
+    _Atomic int64_t last_slack_ns;     // Schlupf des letzten Jobs
+    _Atomic int64_t window_min_slack_ns;
+    _Atomic uint64_t jobs;
+    _Atomic uint64_t overruns;         // Jobs mit negativem Schlupf
+    _Atomic uint64_t updated_ns;       // CLOCK_MONOTONIC der letzten Veröffentlichung
+} __attribute__((aligned(64)));        // ein Slot pro Cache-Line, kein False Sharing zwischen Tasks
+
+struct rt_slack_segment {
+    uint32_t magic;
+    uint32_t num_slots;
+    _Atomic uint32_t overrun_seq;      // Futex-Wort, +1 bei jedem Überlauf eines Tasks
+    _Atomic uint32_t waiters;          // Governor, die auf overrun_seq warten
+    char pad[48];
+    struct rt_slack_task tasks[RT_SLACK_MAX_TASKS];
+};
+
+// Segment einblenden; create != 0 legt es bei Bedarf an. NULL bei Fehler
+static inline struct rt_slack_segment *rt_slack_attach(const char *name, int create) {
+    int fd = shm_open(name, O_RDWR | (create ? O_CREAT : 0), 0666);
+    if (fd == -1) {
+        return NULL;
+    }
+    if (create && ftruncate(fd, sizeof(struct rt_slack_segment)) != 0) {
+        close(fd);
+        return NULL;
+    }
+    void *map = mmap(NULL, sizeof(struct rt_slack_segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return NULL;
+    }
+    struct rt_slack_segment *seg = map;
+    // Ein frisch angelegtes Segment ist genullt; magic markiert es als initialisiert
+    if (seg->magic != RT_SLACK_MAGIC) {
+        seg->num_slots = RT_SLACK_MAX_TASKS;
+        __atomic_store_n(&seg->magic, RT_SLACK_MAGIC, __ATOMIC_RELEASE);
+    }
+    return seg;
+}
+
+static inline void rt_slack_detach(struct rt_slack_segment *seg) {
+    munmap(seg, sizeof(*seg));
+}
+
+// Freien Slot für pid belegen; liefert den Slot-Index oder -1
+static inline int rt_slack_register(struct rt_slack_segment *seg, int32_t pid, int32_t cpu, uint64_t period_ns) {
+    for (int i = 0; i < RT_SLACK_MAX_TASKS; ++i) {
+        struct rt_slack_task *t = &seg->tasks[i];
+        int32_t expected = 0;
+        if (atomic_compare_exchange_strong(&t->pid, &expected, pid)) {
+            atomic_store_explicit(&t->cpu, cpu, memory_order_relaxed);
+            atomic_store_explicit(&t->period_ns, period_ns, memory_order_relaxed);
+            atomic_store_explicit(&t->last_slack_ns, (int64_t)period_ns, memory_order_relaxed);
+            atomic_store_explicit(&t->window_min_slack_ns, RT_SLACK_NONE, memory_order_relaxed);
+            atomic_store_explicit(&t->jobs, 0, memory_order_relaxed);
+            atomic_store_explicit(&t->overruns, 0, memory_order_relaxed);
+            atomic_store_explicit(&t->updated_ns, 0, memory_order_release);
+            return i;
+        }
+    }
+    return -1;
+}
+
+static inline void rt_slack_unregister(struct rt_slack_segment *seg, int slot) {
+    atomic_store_explicit(&seg->tasks[slot].pid, 0, memory_order_release);
+}
+
+// Nach jedem Job aufrufen: lock-free; ein Systemaufruf nur bei Überlauf mit wartendem Governor
+static inline void rt_slack_publish(struct rt_slack_segment *seg, int slot, int64_t slack_ns, uint64_t now_ns) {
+    struct rt_slack_task *t = &seg->tasks[slot];
+    atomic_store_explicit(&t->last_slack_ns, slack_ns, memory_order_relaxed);
+    int64_t cur = atomic_load_explicit(&t->window_min_slack_ns, memory_order_relaxed);
+    while (slack_ns < cur &&
+           !atomic_compare_exchange_weak_explicit(&t->window_min_slack_ns, &cur, slack_ns,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+    if (slack_ns < 0) {
+        atomic_fetch_add_explicit(&t->overruns, 1, memory_order_relaxed);
+    }
+    atomic_fetch_add_explicit(&t->jobs, 1, memory_order_relaxed);
+    atomic_store_explicit(&t->updated_ns, now_ns, memory_order_release);
+    if (slack_ns < 0) {
+        // seq_cst zusammen mit rt_slack_wait_overrun: entweder sieht der Task den Wartenden oder
+        // der Governor die neue Sequenz, ein Überlauf geht nicht verloren
+        atomic_fetch_add(&seg->overrun_seq, 1);
+        if (atomic_load(&seg->waiters) != 0) {
+            syscall(SYS_futex, &seg->overrun_seq, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+        }
+    }
+}
+
+// Governor: Warten auf Überläufe an- (waiting = 1) bzw. abmelden (waiting = 0)
+static inline void rt_slack_set_waiting(struct rt_slack_segment *seg, int waiting) {
+    if (waiting) {
+        atomic_fetch_add(&seg->waiters, 1);
+    } else {
+        atomic_fetch_sub(&seg->waiters, 1);
+    }
+}
+
+static inline uint32_t rt_slack_overrun_seq(struct rt_slack_segment *seg) {
+    return atomic_load(&seg->overrun_seq);
+}
+
+// Wartet, bis overrun_seq nicht mehr seen ist, höchstens bis deadline (absolut, CLOCK_MONOTONIC).
+// 0 nach einem Überlauf, ETIMEDOUT bei Ablauf, EINTR bei Signal, sonst errno des Futex
+static inline int rt_slack_wait_overrun(struct rt_slack_segment *seg, uint32_t seen, const struct timespec *deadline) {
+    if (syscall(SYS_futex, &seg->overrun_seq, FUTEX_WAIT_BITSET, seen, deadline, NULL, FUTEX_BITSET_MATCH_ANY) == 0 ||
+        errno == EAGAIN) {
+        return 0;
+    }
+    return errno;
+}
+
+#endif
@@ -0,0 +1,207 @@
+/*
+Benchmark: Energieersparnis gegenüber Deadline-Verletzungen beim Deadline-Hook (-b)
+
+Simuliert einen periodischen RT-Task mit schwankendem Rechenbedarf (Rauschen plus seltene
+Lastspitzen) auf einer Policy mit Frequenzstufen im Abstand von 100 MHz (grobe Stufen runden
+die Untergrenzen verschiedener Margen auf dieselbe Stufe). Die Frequenzwahl nutzt denselben
+Code wie der Daemon (governor_select, slack_monitor_floor, rt_slack_publish); wie dort hebt
+ein Überlauf die Frequenz sofort an und nicht erst bei der nächsten Abtastung. Nur Zeit und
+Leistungsaufnahme kommen aus einem Modell:
+  Laufzeit eines Jobs  = Zyklen / f
+  Leistung (aktiv)     = P_static + C * f * V(f)^2, V linear zwischen V_min und V_max
+  Leistung (Leerlauf)  = P_static
+
+Verglichen werden:
+  max          immer Höchstfrequenz (Referenz für Energie)
+  last         nur lastgesteuerter Governor
+  schlupf m=X  Governor plus Schlupf-Untergrenze mit Marge X und Boost nach Überlauf
+Margen unter der Reserve des Lastgovernors (headroom 1.25, also rund 20 % Schlupf) ändern das
+Ergebnis kaum; größere Margen kosten Energie und fangen mehr Lastspitzen ab.
+
+Verwendung: ./slack_bench [-j jobs] [-u auslastung] [-P periode_us] [-s abtastung_perioden]
+                          [-b spitzen_wahrscheinlichkeit] [-f spitzen_faktor] [-H boost] [-x seed]
+*/
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE // syscall (Futex in rt_slack.h)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "cpufreq.h"
+#include "governor.h"
+#include "rt_slack.h"
+#include "slack_boost.h"
+
+#define P_STATIC_W 0.5
+#define P_DYN_MAX_W 3.0
+#define V_MIN 0.8
+#define V_MAX 1.0
+#define BURST_JOBS 20
+
+struct workload {
+    long jobs;
+    double utilization;      // mittlere Auslastung bei Höchstfrequenz
+    double period_s;
+    int sample_periods;      // Governor-Abtastung alle N Perioden
+    double burst_prob;       // Wahrscheinlichkeit je Job, dass eine Lastspitze beginnt
+    double burst_factor;
+    unsigned int seed;
+};
+
+struct result {
+    double energy_j;
+    long misses;
+    double avg_freq_khz;
+};
+
+static double power_active(const struct cpufreq_policy *policy, unsigned long khz) {
+    double fmin = (double)policy->freqs[0];
+    double fmax = (double)policy->freqs[policy->num_freqs - 1];
+    double v = V_MIN + (V_MAX - V_MIN) * ((double)khz - fmin) / (fmax - fmin);
+    double c = P_DYN_MAX_W / (fmax * V_MAX * V_MAX);
+    return P_STATIC_W + c * (double)khz * v * v;
+}
+
+static double uniform(unsigned int *state) {
+    return (double)rand_r(state) / ((double)RAND_MAX + 1.0);
+}
+
+// strategy: 0 = max, 1 = nur Last, 2 = Last + Schlupf
+static struct result simulate(const struct workload *w, struct cpufreq_policy *policy,
+                              int strategy, double margin, int boost_hold) {
+    struct governor_params params = { .up_threshold = 0.80, .down_threshold = 0.30, .down_delay = 5, .headroom = 1.25 };
+    struct governor_state state = {0};
+    struct rt_slack_segment *seg = calloc(1, sizeof(*seg));
+    struct slack_monitor monitor;
+    struct result r = {0};
+    unsigned int rng = w->seed;
+    unsigned long fmax = policy->freqs[policy->num_freqs - 1];
+    unsigned long freq = fmax;
+    uint64_t period_ns = (uint64_t)(w->period_s * 1e9);
+    double base_cycles = w->utilization * w->period_s * (double)fmax * 1e3;
+    int burst_left = 0;
+    double window_busy = 0.0;
+    double freq_sum = 0.0;
+
+    slack_monitor_init(&monitor, seg, margin, boost_hold);
+    int slot = rt_slack_register(seg, 1, 0, period_ns);
+
+    for (long job = 0; job < w->jobs; ++job) {
+        if (burst_left == 0 && uniform(&rng) < w->burst_prob) {
+            burst_left = BURST_JOBS;
+        }
+        double cycles = base_cycles * (0.85 + 0.3 * uniform(&rng));
+        if (burst_left > 0) {
+            cycles *= w->burst_factor;
+            burst_left--;
+        }
+        double exec = cycles / ((double)freq * 1e3);
+        double slack = w->period_s - exec;
+        if (slack < 0.0) {
+            r.misses++;
+            exec = w->period_s; // Job wird an der Deadline abgebrochen
+        }
+        r.energy_j += power_active(policy, freq) * exec + P_STATIC_W * (w->period_s - exec);
+        window_busy += exec;
+        freq_sum += (double)freq;
+        uint64_t now_ns = (uint64_t)(job + 1) * period_ns;
+        rt_slack_publish(seg, slot, (int64_t)(slack * 1e9), now_ns);
+        if (strategy == 2 && slack < 0.0 && slack_monitor_check_overruns(&monitor)) {
+            // Aufwecken durch den Überlauf (rt_slack_wait_overrun im Daemon)
+            unsigned long floor = slack_monitor_floor(&monitor, policy, freq);
+            if (floor > freq) {
+                freq = floor;
+            }
+        }
+
+        if ((job + 1) % w->sample_periods != 0 || strategy == 0) {
+            continue;
+        }
+        // Abtastung: dieselbe Entscheidung wie im Daemon
+        double load = window_busy / (w->sample_periods * w->period_s);
+        window_busy = 0.0;
+        unsigned long next = governor_select(&params, &state, policy, freq, load);
+        if (strategy == 2) {
+            slack_monitor_sample(&monitor, now_ns);
+            unsigned long floor = slack_monitor_floor(&monitor, policy, freq);
+            if (floor > next) {
+                next = floor;
+            }
+        }
+        freq = next;
+    }
+    r.avg_freq_khz = freq_sum / (double)w->jobs;
+    free(seg);
+    return r;
+}
+
+static void print_result(const char *name, const struct result *r, const struct result *ref, long jobs) {
+    printf("%-16s %12.3f %9.1f%% %10ld %9.3f%% %10.0f\n", name, r->energy_j,
+           100.0 * (1.0 - r->energy_j / ref->energy_j), r->misses,
+           100.0 * (double)r->misses / (double)jobs, r->avg_freq_khz / 1000.0);
+}
+
+int main(int argc, char *argv[]) {
+    struct workload w = {
+        .jobs = 200000,
+        .utilization = 0.35,
+        .period_s = 0.001,
+        .sample_periods = 10,
+        .burst_prob = 0.002,
+        .burst_factor = 1.8,
+        .seed = 42,
+    };
+    int boost_hold = 10;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "j:u:P:s:b:f:H:x:h")) != -1) {
+        switch (opt) {
+        case 'j': w.jobs = atol(optarg); break;
+        case 'u': w.utilization = atof(optarg); break;
+        case 'P': w.period_s = atof(optarg) / 1e6; break;
+        case 's': w.sample_periods = atoi(optarg); break;
+        case 'b': w.burst_prob = atof(optarg); break;
+        case 'f': w.burst_factor = atof(optarg); break;
+        case 'H': boost_hold = atoi(optarg); break;
+        case 'x': w.seed = (unsigned int)strtoul(optarg, NULL, 10); break;
+        default:
+            fprintf(stderr, "Verwendung: %s [-j jobs] [-u auslastung] [-P periode_us] [-s abtastung_perioden]\n"
+                    "            [-b spitzen_wahrscheinlichkeit] [-f spitzen_faktor] [-H boost] [-x seed]\n", argv[0]);
+            return opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if (w.jobs <= 0 || w.sample_periods <= 0 || w.period_s <= 0.0) {
+        fprintf(stderr, "Ungültige Parameter\n");
+        return EXIT_FAILURE;
+    }
+
+    // Policy mit 600 - 2400 MHz in 100-MHz-Stufen (wie viele ARM-SoCs), ohne sysfs
+    struct cpufreq_policy policy;
+    memset(&policy, 0, sizeof(policy));
+    for (unsigned long khz = 600000; khz <= 2400000; khz += 100000) {
+        policy.freqs[policy.num_freqs++] = khz;
+    }
+    policy.num_cpus = 1;
+    policy.setspeed_fd = -1;
+    policy.cur_freq_fd = -1;
+
+    printf("Jobs: %ld, Periode: %.0f us, Auslastung bei f_max: %.0f%%, Spitzen: p=%.4f x%.1f\n\n",
+           w.jobs, w.period_s * 1e6, w.utilization * 100.0, w.burst_prob, w.burst_factor);
+    printf("%-16s %12s %10s %10s %10s %10s\n", "Strategie", "Energie [J]", "Ersparnis", "Verfehlt", "Rate", "f_mittel");
+
+    struct result ref = simulate(&w, &policy, 0, 0.0, boost_hold);
+    print_result("max", &ref, &ref, w.jobs);
+    struct result load = simulate(&w, &policy, 1, 0.0, boost_hold);
+    print_result("last", &load, &ref, w.jobs);
+    const double margins[] = { 0.05, 0.1, 0.2, 0.3, 0.4 };
+    for (size_t i = 0; i < sizeof(margins) / sizeof(margins[0]); ++i) {
+        char name[32];
+        snprintf(name, sizeof(name), "schlupf m=%.2f", margins[i]);
+        struct result r = simulate(&w, &policy, 2, margins[i], boost_hold);
+        print_result(name, &r, &ref, w.jobs);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,103 @@
+// Deadline-bewusste Untergrenze für die Frequenzwahl (siehe slack_boost.h)
+
+#include <string.h>
+
+#include "slack_boost.h"
+
+#define STALE_NS 1000000000ULL // 1 s ohne Job: Task gilt als inaktiv
+
+void slack_monitor_init(struct slack_monitor *mon, struct rt_slack_segment *seg, double margin, int boost_hold) {
+    memset(mon, 0, sizeof(*mon));
+    mon->seg = seg;
+    mon->margin = margin;
+    mon->boost_hold = boost_hold;
+    mon->stale_ns = STALE_NS;
+}
+
+void slack_monitor_sample(struct slack_monitor *mon, uint64_t now_ns) {
+    for (int i = 0; i < RT_SLACK_MAX_TASKS; ++i) {
+        struct rt_slack_task *t = &mon->seg->tasks[i];
+        struct slack_task_state *s = &mon->tasks[i];
+        int32_t pid = atomic_load_explicit(&t->pid, memory_order_acquire);
+        uint64_t updated = atomic_load_explicit(&t->updated_ns, memory_order_acquire);
+        if (pid == 0 || updated == 0 || now_ns - updated > mon->stale_ns) {
+            s->active = 0;
+            continue;
+        }
+        if (!s->active) {
+            // Neuer Task: Überläufe vor dem ersten Sample nicht als frischen Überlauf werten
+            s->overruns = atomic_load_explicit(&t->overruns, memory_order_relaxed);
+            s->boost_remaining = 0;
+        }
+        s->active = 1;
+        s->cpu = atomic_load_explicit(&t->cpu, memory_order_relaxed);
+        s->period_ns = atomic_load_explicit(&t->period_ns, memory_order_relaxed);
+
+        int64_t min = atomic_exchange_explicit(&t->window_min_slack_ns, RT_SLACK_NONE, memory_order_relaxed);
+        s->min_slack_ns = min != RT_SLACK_NONE ? min : atomic_load_explicit(&t->last_slack_ns, memory_order_relaxed);
+
+        uint64_t overruns = atomic_load_explicit(&t->overruns, memory_order_relaxed);
+        if (overruns != s->overruns) {
+            s->overruns = overruns;
+            s->boost_remaining = mon->boost_hold;
+        } else if (s->boost_remaining > 0) {
+            s->boost_remaining--;
+        }
+    }
+}
+
+int slack_monitor_check_overruns(struct slack_monitor *mon) {
+    int overrun = 0;
+    for (int i = 0; i < RT_SLACK_MAX_TASKS; ++i) {
+        struct slack_task_state *s = &mon->tasks[i];
+        if (!s->active) {
+            continue;
+        }
+        uint64_t overruns = atomic_load_explicit(&mon->seg->tasks[i].overruns, memory_order_relaxed);
+        if (overruns != s->overruns) {
+            s->overruns = overruns;
+            s->boost_remaining = mon->boost_hold;
+            overrun = 1;
+        }
+    }
+    return overrun;
+}
+
+static int policy_has_cpu(const struct cpufreq_policy *policy, int cpu) {
+    if (cpu < 0) {
+        return 1; // Task ohne feste CPU betrifft jede Domäne
+    }
+    for (int i = 0; i < policy->num_cpus; ++i) {
+        if (policy->cpus[i] == cpu) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+unsigned long slack_monitor_floor(const struct slack_monitor *mon, const struct cpufreq_policy *policy,
+                                  unsigned long cur_freq) {
+    unsigned long max_freq = policy->freqs[policy->num_freqs - 1];
+    unsigned long floor = 0;
+    for (int i = 0; i < RT_SLACK_MAX_TASKS; ++i) {
+        const struct slack_task_state *s = &mon->tasks[i];
+        if (!s->active || s->period_ns == 0 || !policy_has_cpu(policy, s->cpu)) {
+            continue;
+        }
+        if (s->boost_remaining > 0 || s->min_slack_ns < 0) {
+            return max_freq;
+        }
+        // Antwortzeit bei cur_freq, skaliert auf die Frequenz mit Antwortzeit <= (1 - margin) * Periode
+        double response = (double)s->period_ns - (double)s->min_slack_ns;
+        double budget = (double)s->period_ns * (1.0 - mon->margin);
+        if (response <= 0.0) {
+            continue;
+        }
+        unsigned long needed = budget > 0.0 ? (unsigned long)((double)cur_freq * response / budget) : max_freq;
+        unsigned long freq = cpufreq_ceil_frequency(policy, needed);
+        if (freq > floor) {
+            floor = freq;
+        }
+    }
+    return floor;
+}
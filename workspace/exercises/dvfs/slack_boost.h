@@ -0,0 +1,49 @@
+#ifndef SLACK_BOOST_H
+#define SLACK_BOOST_H
+
+#include <stdint.h>
+
+#include "cpufreq.h"
+#include "rt_slack.h"
+
+/*
+Deadline-bewusste Untergrenze für die Frequenzwahl.
+
+Aus dem kleinsten Schlupf seit der letzten Abtastung wird die Antwortzeit eines Jobs
+geschätzt (Periode - Schlupf) und auf andere Frequenzen hochgerechnet (Laufzeit ~ 1/f).
+Die Untergrenze ist die niedrigste Frequenz, bei der die Antwortzeit höchstens
+(1 - margin) * Periode beträgt. Nach einem Überlauf gilt für boost_hold Abtastungen die
+Höchstfrequenz.
+*/
+
+struct slack_task_state {
+    uint64_t overruns;        // zuletzt gesehener Überlaufzähler
+    int64_t min_slack_ns;     // kleinster Schlupf der letzten Abtastung
+    uint64_t period_ns;
+    int32_t cpu;
+    int boost_remaining;      // Abtastungen mit erzwungener Höchstfrequenz
+    int active;
+};
+
+struct slack_monitor {
+    struct rt_slack_segment *seg;
+    double margin;            // Sicherheitsmarge als Anteil der Periode, z.B. 0.2
+    int boost_hold;           // Abtastungen auf Höchstfrequenz nach einem Überlauf
+    uint64_t stale_ns;        // Tasks ohne Veröffentlichung seit stale_ns werden ignoriert
+    struct slack_task_state tasks[RT_SLACK_MAX_TASKS];
+};
+
+void slack_monitor_init(struct slack_monitor *mon, struct rt_slack_segment *seg, double margin, int boost_hold);
+
+// Liest alle Slots einmal pro Abtastung (now_ns: CLOCK_MONOTONIC)
+void slack_monitor_sample(struct slack_monitor *mon, uint64_t now_ns);
+
+// Nur die Überlaufzähler prüfen, z.B. nach dem Aufwecken durch rt_slack_wait_overrun zwischen
+// zwei Abtastungen; liefert 1, wenn ein aktiver Task übergelaufen ist (Boost beginnt sofort)
+int slack_monitor_check_overruns(struct slack_monitor *mon);
+
+// Untergrenze für die Policy bei aktueller Frequenz cur_freq; 0 = keine Einschränkung
+unsigned long slack_monitor_floor(const struct slack_monitor *mon, const struct cpufreq_policy *policy,
+                                  unsigned long cur_freq);
+
+#endif
@@ -0,0 +1,315 @@
+// Frequenz-Sweep mit Leistungs- und Energiemessung (siehe sweep.h)
+
+#define _GNU_SOURCE
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <linux/perf_event.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "sweep.h"
+
+#define MAX_RAPL_DOMAINS 8
+#define MAX_REPEATS 16
+
+// Energiequelle: alle obersten powercap-Domänen (Package) aufsummiert
+struct energy_meter {
+    int fds[MAX_RAPL_DOMAINS];
+    unsigned long long max_range[MAX_RAPL_DOMAINS];
+    int count;
+};
+
+// Hardware-Zähler dieses Threads: Zyklen (Gruppenleiter) und Instruktionen
+struct perf_counters {
+    int cycles_fd;
+    int instructions_fd;
+};
+
+struct measurement {
+    double time_s;
+    long long instructions;  // -1 wenn nicht verfügbar
+    long long cycles;        // -1 wenn nicht verfügbar
+    double energy_j;         // < 0 wenn nicht verfügbar
+};
+
+static volatile uint64_t sink; // verhindert, dass der Compiler die Kernel wegoptimiert
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static unsigned long long read_ull(int fd) {
+    char buf[32];
+    ssize_t len = pread(fd, buf, sizeof(buf) - 1, 0);
+    if (len <= 0) {
+        return 0;
+    }
+    buf[len] = '\0';
+    return strtoull(buf, NULL, 10);
+}
+
+static void energy_open(struct energy_meter *meter, const char *sysfs_root) {
+    char dirpath[PATH_MAX];
+    meter->count = 0;
+    snprintf(dirpath, sizeof(dirpath), "%s/class/powercap", sysfs_root);
+    DIR *dir = opendir(dirpath);
+    if (dir == NULL) {
+        return;
+    }
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL && meter->count < MAX_RAPL_DOMAINS) {
+        // Nur Package-Domänen (intel-rapl:N), keine Unterdomänen (intel-rapl:N:M)
+        int id;
+        char rest;
+        if (sscanf(entry->d_name, "intel-rapl:%d%c", &id, &rest) != 1) {
+            continue;
+        }
+        char path[PATH_MAX + 300];
+        snprintf(path, sizeof(path), "%s/%s/energy_uj", dirpath, entry->d_name);
+        int fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd == -1) {
+            continue; // energy_uj ist seit Linux 5.10 nur für root lesbar
+        }
+        snprintf(path, sizeof(path), "%s/%s/max_energy_range_uj", dirpath, entry->d_name);
+        int range_fd = open(path, O_RDONLY | O_CLOEXEC);
+        meter->max_range[meter->count] = range_fd == -1 ? 0 : read_ull(range_fd);
+        if (range_fd != -1) {
+            close(range_fd);
+        }
+        meter->fds[meter->count++] = fd;
+    }
+    closedir(dir);
+}
+
+static void energy_read(const struct energy_meter *meter, unsigned long long *values) {
+    for (int i = 0; i < meter->count; ++i) {
+        values[i] = read_ull(meter->fds[i]);
+    }
+}
+
+// Verbrauchte Energie in Joule, Zählerüberlauf über max_energy_range_uj berücksichtigt
+static double energy_delta(const struct energy_meter *meter, const unsigned long long *start,
+                           const unsigned long long *end) {
+    double total_uj = 0.0;
+    for (int i = 0; i < meter->count; ++i) {
+        unsigned long long delta = end[i] >= start[i] ? end[i] - start[i]
+                                                      : end[i] + meter->max_range[i] - start[i];
+        total_uj += (double)delta;
+    }
+    return total_uj / 1e6;
+}
+
+static void energy_close(struct energy_meter *meter) {
+    for (int i = 0; i < meter->count; ++i) {
+        close(meter->fds[i]);
+    }
+    meter->count = 0;
+}
+
+static int perf_open(uint64_t config, int group_fd) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = group_fd == -1;
+    attr.exclude_kernel = 1; // funktioniert auch mit perf_event_paranoid = 2
+    attr.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, PERF_FLAG_FD_CLOEXEC);
+}
+
+static void perf_counters_open(struct perf_counters *pc) {
+    pc->cycles_fd = perf_open(PERF_COUNT_HW_CPU_CYCLES, -1);
+    pc->instructions_fd = pc->cycles_fd == -1 ? -1 : perf_open(PERF_COUNT_HW_INSTRUCTIONS, pc->cycles_fd);
+}
+
+static void perf_counters_close(struct perf_counters *pc) {
+    if (pc->instructions_fd != -1) {
+        close(pc->instructions_fd);
+    }
+    if (pc->cycles_fd != -1) {
+        close(pc->cycles_fd);
+    }
+}
+
+static long long perf_value(int fd) {
+    long long value;
+    if (fd == -1 || read(fd, &value, sizeof(value)) != sizeof(value)) {
+        return -1;
+    }
+    return value;
+}
+
+// CPU-gebunden: Ganzzahl-Arithmetik in Registern, skaliert linear mit dem Takt
+static void cpu_kernel(long iterations) {
+    uint64_t x = 0x9e3779b97f4a7c15ULL;
+    uint64_t acc = 0;
+    for (long i = 0; i < iterations; ++i) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        acc += x * 0xff51afd7ed558ccdULL;
+    }
+    sink = acc;
+}
+
+// Speichergebunden: Zeigerverfolgung durch einen zufälligen Zyklus (Sattolo), latenzgebunden
+static size_t *mem_prepare(long bytes, size_t *count) {
+    *count = (size_t)bytes / sizeof(size_t);
+    if (*count < 2) {
+        return NULL;
+    }
+    size_t *next = malloc(*count * sizeof(size_t));
+    if (next == NULL) {
+        return NULL;
+    }
+    for (size_t i = 0; i < *count; ++i) {
+        next[i] = i;
+    }
+    uint64_t seed = 88172645463325252ULL;
+    for (size_t i = *count - 1; i > 0; --i) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        size_t j = (size_t)(seed % i);
+        size_t tmp = next[i];
+        next[i] = next[j];
+        next[j] = tmp;
+    }
+    return next;
+}
+
+static void mem_kernel(const size_t *next, long accesses) {
+    size_t pos = 0;
+    for (long i = 0; i < accesses; ++i) {
+        pos = next[pos];
+    }
+    sink = pos;
+}
+
+static void measure(const struct energy_meter *meter, struct perf_counters *pc,
+                    int kernel, long ops, const size_t *chain, struct measurement *m) {
+    unsigned long long e_start[MAX_RAPL_DOMAINS];
+    unsigned long long e_end[MAX_RAPL_DOMAINS];
+
+    if (pc->cycles_fd != -1) {
+        ioctl(pc->cycles_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(pc->cycles_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+    energy_read(meter, e_start);
+    double t0 = now_s();
+    if (kernel == 0) {
+        cpu_kernel(ops);
+    } else {
+        mem_kernel(chain, ops);
+    }
+    double t1 = now_s();
+    energy_read(meter, e_end);
+    if (pc->cycles_fd != -1) {
+        ioctl(pc->cycles_fd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    }
+
+    m->time_s = t1 - t0;
+    m->cycles = perf_value(pc->cycles_fd);
+    m->instructions = perf_value(pc->instructions_fd);
+    m->energy_j = meter->count > 0 ? energy_delta(meter, e_start, e_end) : -1.0;
+}
+
+static int compare_time(const void *a, const void *b) {
+    double x = ((const struct measurement *)a)->time_s;
+    double y = ((const struct measurement *)b)->time_s;
+    return (x > y) - (x < y);
+}
+
+static void print_row(FILE *out, unsigned long khz, const char *kernel, long ops, const struct measurement *m) {
+    fprintf(out, "%lu,%s,%ld,%.6f,", khz, kernel, ops, m->time_s);
+    if (m->instructions >= 0 && m->cycles > 0) {
+        fprintf(out, "%lld,%lld,%.3f,", m->instructions, m->cycles, (double)m->instructions / (double)m->cycles);
+    } else {
+        fprintf(out, "NA,NA,NA,");
+    }
+    double ops_per_s = (double)ops / m->time_s;
+    // Energie 0 bedeutet: Zähler nicht fortgeschrieben (z.B. nachgebauter Baum)
+    if (m->energy_j > 0.0) {
+        fprintf(out, "%.6f,%.3f,%.0f,%.0f\n", m->energy_j, m->energy_j / m->time_s, ops_per_s, (double)ops / m->energy_j);
+    } else {
+        fprintf(out, "NA,NA,%.0f,NA\n", ops_per_s);
+    }
+}
+
+int sweep_run(struct cpufreq_system *sys, struct cpufreq_policy *policy,
+              const struct sweep_params *params, FILE *out) {
+    int repeats = params->repeats < 1 ? 1 : (params->repeats > MAX_REPEATS ? MAX_REPEATS : params->repeats);
+
+    // Auf eine CPU der Policy festlegen, damit die Messung im gewählten Takt läuft
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(policy->cpus[0], &set);
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+        perror("Failed to pin to policy CPU");
+    }
+
+    size_t chain_len = 0;
+    size_t *chain = NULL;
+    if (params->mem_accesses > 0) {
+        chain = mem_prepare(params->mem_buffer_bytes, &chain_len);
+        if (chain == NULL) {
+            fprintf(stderr, "Speicher-Kernel: Puffer von %ld Bytes nicht verfügbar\n", params->mem_buffer_bytes);
+            return -1;
+        }
+    }
+
+    struct energy_meter meter;
+    struct perf_counters pc;
+    energy_open(&meter, sys->root);
+    perf_counters_open(&pc);
+    if (meter.count == 0) {
+        fprintf(stderr, "Hinweis: keine lesbare powercap/RAPL-Domäne, Energie-Spalten bleiben NA\n");
+    }
+    if (pc.cycles_fd == -1) {
+        perror("Hinweis: perf_event_open nicht verfügbar, Zähler-Spalten bleiben NA");
+    }
+
+    unsigned long original = policy->cur_freq;
+    fprintf(out, "freq_khz,kernel,ops,time_s,instructions,cycles,ipc,energy_j,power_w,ops_per_s,ops_per_j\n");
+    for (int f = 0; f < policy->num_freqs; ++f) {
+        unsigned long khz = policy->freqs[f];
+        if (cpufreq_set_frequency(policy, khz) != 0) {
+            perror("Failed to write scaling_setspeed");
+            continue;
+        }
+        struct timespec settle = { params->settle_ms / 1000, (params->settle_ms % 1000) * 1000000L };
+        nanosleep(&settle, NULL);
+
+        for (int kernel = 0; kernel < 2; ++kernel) {
+            long ops = kernel == 0 ? params->cpu_iterations : params->mem_accesses;
+            if (ops <= 0) {
+                continue;
+            }
+            struct measurement runs[MAX_REPEATS];
+            for (int r = 0; r < repeats; ++r) {
+                measure(&meter, &pc, kernel, ops, chain, &runs[r]);
+            }
+            qsort(runs, (size_t)repeats, sizeof(runs[0]), compare_time);
+            print_row(out, khz, kernel == 0 ? "cpu" : "mem", ops, &runs[repeats / 2]);
+        }
+        fflush(out);
+    }
+
+    if (cpufreq_set_frequency(policy, original) != 0) {
+        perror("Failed to restore scaling_setspeed");
+    }
+    perf_counters_close(&pc);
+    energy_close(&meter);
+    free(chain);
+    return 0;
+}
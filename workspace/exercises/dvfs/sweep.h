@@ -0,0 +1,32 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <stdio.h>
+
+#include "cpufreq.h"
+
+/*
+Frequenz-Sweep: Leistung und Energie je Betriebspunkt messen.
+
+Für jede Frequenz aus scaling_available_frequencies einer Policy wird ein CPU-gebundener und
+ein speichergebundener Kernel auf einer CPU dieser Policy ausgeführt. Gemessen werden
+Laufzeit, Instruktionen und Zyklen (perf_event_open) sowie die Energie aus powercap/RAPL
+(<sysfs>/class/powercap/intel-rapl:N/energy_uj). Fehlt eine Quelle, bleiben die Spalten
+leer ("NA") statt den Sweep abzubrechen.
+
+Ausgabe als CSV: freq_khz,kernel,ops,time_s,instructions,cycles,ipc,energy_j,power_w,ops_per_s,ops_per_j
+*/
+
+struct sweep_params {
+    long cpu_iterations;     // Iterationen des CPU-Kernels, 0 = auslassen
+    long mem_accesses;       // Zugriffe des Speicher-Kernels, 0 = auslassen
+    long mem_buffer_bytes;   // Puffergröße des Speicher-Kernels
+    int repeats;             // Messungen je Frequenz und Kernel (Median der Laufzeit zählt)
+    long settle_ms;          // Wartezeit nach dem Frequenzwechsel
+};
+
+// Führt den Sweep für eine Policy aus und schreibt CSV nach out; 0 bei Erfolg
+int sweep_run(struct cpufreq_system *sys, struct cpufreq_policy *policy,
+              const struct sweep_params *params, FILE *out);
+
+#endif
@@ -0,0 +1,83 @@
+#!/bin/bash
+
+# Testet den DVFS-Governor gegen einen nachgebauten sysfs-Baum in einem tmpdir
+# Usage: ./test_governor.sh [pfad_zu_dvfs]
+#
+# Zwei Policies (Cluster): policy0 = CPU 0-1 unter Volllast, policy2 = CPU 2-3 im Leerlauf.
+# Erwartet: policy0 landet auf der höchsten, policy2 auf der niedrigsten Frequenz.
+# Danach: Sweep-Modus (-S) liefert je Frequenz eine CSV-Zeile pro Kernel, auch ohne RAPL/perf.
+
+DVFS="${1:-./dvfs}"
+FREQS="600000 1000000 1400000 1800000"
+
+ROOT=$(mktemp -d)
+trap 'kill $FEEDER 2>/dev/null; rm -rf "$ROOT"' EXIT
+
+make_policy() {
+    local policy="$1" cpus="$2" dir="$ROOT/sys/devices/system/cpu/cpufreq/$1"
+    mkdir -p "$dir"
+    echo "$cpus" > "$dir/affected_cpus"
+    echo "$FREQS" > "$dir/scaling_available_frequencies"
+    echo "userspace" > "$dir/scaling_governor"
+    echo "1000000" > "$dir/scaling_cur_freq"
+    echo "1000000" > "$dir/scaling_setspeed"
+}
+
+make_policy policy0 "0 1"
+make_policy policy2 "2 3"
+
+# /proc/stat-Ersatz: CPU 0-1 sammeln nur Busy-Zeit, CPU 2-3 nur Leerlaufzeit.
+# Die Datei wird an Ort und Stelle überschrieben, da dvfs den Deskriptor offen hält.
+STAT="$ROOT/stat"
+write_stat() {
+    local t="$1"
+    {
+        echo "cpu  0 0 0 0 0 0 0 0 0 0"
+        echo "cpu0 $t 0 0 0 0 0 0 0 0 0"
+        echo "cpu1 $t 0 0 0 0 0 0 0 0 0"
+        echo "cpu2 0 0 0 $t 0 0 0 0 0 0"
+        echo "cpu3 0 0 0 $t 0 0 0 0 0 0"
+    } > "$STAT"
+}
+write_stat 0
+( t=0; while true; do t=$((t + 10)); write_stat $t; sleep 0.01; done ) &
+FEEDER=$!
+
+echo "=== DVFS-Governor Test (fake sysfs: $ROOT) ==="
+"$DVFS" -r "$ROOT/sys" -s "$STAT" -i 50 -n 40 -D 3 -k > "$ROOT/dvfs.log"
+status=$?
+
+check() {
+    local policy="$1" expected="$2"
+    local actual
+    actual=$(head -n1 "$ROOT/sys/devices/system/cpu/cpufreq/$policy/scaling_setspeed")
+    if [[ "$actual" == "$expected" ]]; then
+        echo "✓ $policy: $actual kHz"
+        return 0
+    fi
+    echo "✗ $policy: erwartet $expected kHz, gesetzt $actual kHz"
+    return 1
+}
+
+failed=0
+[[ $status -eq 0 ]] || { echo "✗ dvfs beendet mit Status $status"; failed=1; }
+check policy0 1800000 || failed=1
+check policy2 600000 || failed=1
+
+if [[ $failed -ne 0 ]]; then
+    cat "$ROOT/dvfs.log"
+    exit 1
+fi
+
+echo "=== Frequenz-Sweep (fake sysfs, ohne RAPL) ==="
+"$DVFS" -S -r "$ROOT/sys" -p 2 -c 1 -M 0.1 -B 1 -R 1 -k -o "$ROOT/sweep.csv" 2> /dev/null
+rows=$(tail -n +2 "$ROOT/sweep.csv" | wc -l)
+expected_rows=$(( $(echo $FREQS | wc -w) * 2 ))
+if [[ $rows -eq $expected_rows ]]; then
+    echo "✓ Sweep: $rows CSV-Zeilen"
+else
+    echo "✗ Sweep: erwartet $expected_rows CSV-Zeilen, erhalten $rows"
+    cat "$ROOT/sweep.csv"
+    exit 1
+fi
+echo "=== Test erfolgreich ==="
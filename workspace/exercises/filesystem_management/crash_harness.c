@@ -0,0 +1,336 @@
+/*
+Crash-Konsistenz- und Wiederherstellungszeit-Test für filesystem_management
+
+Der Harness startet den Arbeitsablauf (Erstellen/Auflisten/Löschen) von filesystem_management
+in einem Kindprozess und beendet ihn zu einem zufälligen Zeitpunkt mit SIGKILL. Im Modus -p
+wird zusätzlich ein Stromausfall simuliert: fault_inject.so protokolliert die per fsync
+dauerhaft geschriebene Journal-Größe, und alles dahinter wird nach dem Kill (zufällig
+zerrissen) verworfen.
+
+Nach jedem Ausfall wird die Wiederherstellung (filesystem_management --recover) ausgeführt,
+deren Laufzeit gemessen und anschließend werden die Invarianten geprüft:
+  1. Die Wiederherstellung endet mit Exit-Code 0.
+  2. Das Arbeitsverzeichnis existiert nicht mehr (kein halber Zyklus bleibt liegen).
+  3. Das Journal besteht nur aus vollständigen, bekannten Einträgen in gültiger Zyklus-Reihenfolge
+     und endet an einer Zyklusgrenze.
+
+Die Ausgabe ist CSV (eine Zeile pro Runde) gefolgt von einer Zusammenfassung der
+Wiederherstellungszeit in Abhängigkeit von der Journal-Größe - das ist die Boot-Zeit-Strafe
+nach einem Stromausfall.
+
+Verwendung: ./crash_harness [-n runden] [-d max_verzoegerung_us] [-p] [-s seed]
+                            [-b filesystem_management] [-l fault_inject.so]
+*/
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "fault_inject.h"
+
+#define DIRNAME "testdir"
+#define JOURNAL_FILE "journal.txt"
+#define STATE_FILE "fault_state.bin"
+#define WORKLOAD_CYCLES "1000000"
+#define MAX_BUCKETS 32
+
+// Einträge in Zyklus-Reihenfolge, identisch zu filesystem_management.c
+static const char *journal_entries[] = {
+    "Verzeichnis erstellt",
+    "Dateien erstellt",
+    "Dateien aufgelistet",
+    "Dateien gelöscht",
+    "Verzeichnis gelöscht",
+    "Zyklus zurückgerollt"
+};
+#define NUM_JOURNAL_ENTRIES (int)(sizeof(journal_entries) / sizeof(journal_entries[0]))
+#define ENTRY_CYCLE_END (NUM_JOURNAL_ENTRIES - 2)
+#define ENTRY_ROLLBACK (NUM_JOURNAL_ENTRIES - 1)
+
+// Wiederherstellungszeit, gruppiert nach Journal-Größe (Zweierpotenzen in Bytes)
+struct bucket {
+    int runs;
+    double total_us;
+    double max_us;
+};
+
+static double now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static long file_size(const char *path) {
+    struct stat st;
+    return stat(path, &st) == 0 ? (long)st.st_size : 0;
+}
+
+// Startet das Programm mit einem Argument; Ausgaben landen in /dev/null
+static pid_t spawn(const char *binary, const char *arg, const char *preload) {
+    pid_t pid = fork();
+    if (pid != 0) {
+        return pid;
+    }
+    int devnull = open("/dev/null", O_WRONLY);
+    if (devnull != -1) {
+        dup2(devnull, STDOUT_FILENO);
+        dup2(devnull, STDERR_FILENO);
+        close(devnull);
+    }
+    if (preload != NULL) {
+        setenv("LD_PRELOAD", preload, 1);
+        setenv("FAULT_STATE_FILE", STATE_FILE, 1);
+        setenv("FAULT_TRACK_FILE", JOURNAL_FILE, 1);
+    }
+    execl(binary, binary, arg, (char *)NULL);
+    _exit(127);
+}
+
+static int wait_status(pid_t pid) {
+    int status;
+    while (waitpid(pid, &status, 0) == -1) {
+        if (errno != EINTR) {
+            return -1;
+        }
+    }
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+// Zustandsdatei für fault_inject.so mit der aktuell dauerhaften Journal-Größe anlegen
+static struct fault_state *reset_state(void) {
+    int fd = open(STATE_FILE, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1 || ftruncate(fd, sizeof(struct fault_state)) != 0) {
+        perror("Fehler beim Anlegen der Zustandsdatei");
+        exit(EXIT_FAILURE);
+    }
+    struct fault_state *state = mmap(NULL, sizeof(*state), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (state == MAP_FAILED) {
+        perror("mmap");
+        exit(EXIT_FAILURE);
+    }
+    state->durable_size = (unsigned long long)file_size(JOURNAL_FILE);
+    state->sync_count = 0;
+    return state;
+}
+
+// Stromausfall: nicht synchronisierte Journal-Daten verwerfen, der Rest wird zufällig zerrissen
+static long drop_unsynced(struct fault_state *state) {
+    long size = file_size(JOURNAL_FILE);
+    long durable = (long)__atomic_load_n(&state->durable_size, __ATOMIC_ACQUIRE);
+    if (durable >= size) {
+        return 0;
+    }
+    long keep = durable + rand() % (size - durable);
+    if (truncate(JOURNAL_FILE, keep) != 0) {
+        perror("Fehler beim Verwerfen nicht synchronisierter Daten");
+        return 0;
+    }
+    return size - keep;
+}
+
+// Invariante 3: vollständige Einträge, gültige Reihenfolge, Ende an Zyklusgrenze
+static int check_journal(long *entries, char *reason, size_t reason_len) {
+    FILE *journal = fopen(JOURNAL_FILE, "r");
+    *entries = 0;
+    if (journal == NULL) {
+        return 0; // Noch kein Journal ist konsistent
+    }
+    char line[256];
+    int prev = ENTRY_CYCLE_END;
+    int ok = 1;
+    while (fgets(line, sizeof(line), journal)) {
+        size_t len = strlen(line);
+        if (len == 0 || line[len - 1] != '\n') {
+            snprintf(reason, reason_len, "unvollständiger Eintrag %ld", *entries + 1);
+            ok = 0;
+            break;
+        }
+        line[len - 1] = '\0';
+        int index = -1;
+        for (int i = 0; i < NUM_JOURNAL_ENTRIES; ++i) {
+            if (strcmp(line, journal_entries[i]) == 0) {
+                index = i;
+                break;
+            }
+        }
+        (*entries)++;
+        if (index < 0) {
+            snprintf(reason, reason_len, "unbekannter Eintrag %ld", *entries);
+            ok = 0;
+            break;
+        }
+        // Ein Rollback darf jeden Eintrag abschließen, ein neuer Zyklus beginnt nur an einer Grenze
+        int expected = (prev == ENTRY_CYCLE_END || prev == ENTRY_ROLLBACK) ? 0 : prev + 1;
+        if (index != ENTRY_ROLLBACK && index != expected) {
+            snprintf(reason, reason_len, "Reihenfolge verletzt bei Eintrag %ld", *entries);
+            ok = 0;
+            break;
+        }
+        prev = index;
+    }
+    fclose(journal);
+    if (ok && prev != ENTRY_CYCLE_END && prev != ENTRY_ROLLBACK) {
+        snprintf(reason, reason_len, "Journal endet mitten im Zyklus");
+        ok = 0;
+    }
+    return ok ? 0 : 1;
+}
+
+static int check_invariants(int recover_status, long *entries, char *reason, size_t reason_len) {
+    struct stat st;
+    if (recover_status != 0) {
+        snprintf(reason, reason_len, "Wiederherstellung mit Status %d beendet", recover_status);
+        return 1;
+    }
+    if (stat(DIRNAME, &st) == 0) {
+        snprintf(reason, reason_len, "%s existiert nach der Wiederherstellung", DIRNAME);
+        return 1;
+    }
+    return check_journal(entries, reason, reason_len);
+}
+
+static int bucket_index(long bytes) {
+    int index = 0;
+    while (bytes > 1 && index < MAX_BUCKETS - 1) {
+        bytes >>= 1;
+        index++;
+    }
+    return index;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Verwendung: %s [-n runden] [-d max_verzoegerung_us] [-p] [-s seed] "
+            "[-b filesystem_management] [-l fault_inject.so]\n", prog);
+}
+
+int main(int argc, char *argv[]) {
+    int runs = 50;
+    long max_delay_us = 20000;
+    int power_loss = 0;
+    unsigned int seed = (unsigned int)time(NULL);
+    const char *binary_arg = "./filesystem_management";
+    const char *preload_arg = "./fault_inject.so";
+    char binary[PATH_MAX];
+    char preload[PATH_MAX];
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:d:ps:b:l:h")) != -1) {
+        switch (opt) {
+        case 'n': runs = atoi(optarg); break;
+        case 'd': max_delay_us = atol(optarg); break;
+        case 'p': power_loss = 1; break;
+        case 's': seed = (unsigned int)strtoul(optarg, NULL, 10); break;
+        case 'b': binary_arg = optarg; break;
+        case 'l': preload_arg = optarg; break;
+        default: usage(argv[0]); return opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if (runs <= 0 || max_delay_us <= 0) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (realpath(binary_arg, binary) == NULL) {
+        perror(binary_arg);
+        return EXIT_FAILURE;
+    }
+    if (power_loss && realpath(preload_arg, preload) == NULL) {
+        perror(preload_arg);
+        return EXIT_FAILURE;
+    }
+
+    // Jeder Lauf arbeitet in einem eigenen, leeren Verzeichnis
+    char workdir[] = "/tmp/fsm_crash_XXXXXX";
+    if (mkdtemp(workdir) == NULL || chdir(workdir) != 0) {
+        perror("Fehler beim Anlegen des Arbeitsverzeichnisses");
+        return EXIT_FAILURE;
+    }
+    srand(seed);
+    fprintf(stderr, "Arbeitsverzeichnis: %s, Seed: %u, Modus: %s\n",
+            workdir, seed, power_loss ? "Stromausfall (fsync-Verlust)" : "SIGKILL");
+
+    struct bucket buckets[MAX_BUCKETS] = {0};
+    int failures = 0;
+    long dropped_total = 0;
+
+    printf("runde,verzoegerung_us,verworfen_bytes,journal_bytes,journal_eintraege,recovery_us,status\n");
+    for (int run = 1; run <= runs; ++run) {
+        struct fault_state *state = power_loss ? reset_state() : NULL;
+        long delay_us = rand() % max_delay_us;
+
+        // Ausfall: Kindprozess mitten im Arbeitsablauf hart beenden
+        pid_t pid = spawn(binary, WORKLOAD_CYCLES, power_loss ? preload : NULL);
+        if (pid == -1) {
+            perror("fork");
+            return EXIT_FAILURE;
+        }
+        usleep((useconds_t)delay_us);
+        kill(pid, SIGKILL);
+        wait_status(pid);
+
+        long dropped = 0;
+        if (state != NULL) {
+            dropped = drop_unsynced(state);
+            munmap(state, sizeof(*state));
+            dropped_total += dropped;
+        }
+
+        // Wiederherstellung messen
+        long journal_bytes = file_size(JOURNAL_FILE);
+        double start = now_us();
+        int recover_status = wait_status(spawn(binary, "--recover", NULL));
+        double recovery_us = now_us() - start;
+
+        long entries;
+        char reason[128] = "ok";
+        if (check_invariants(recover_status, &entries, reason, sizeof(reason)) != 0) {
+            failures++;
+        }
+        printf("%d,%ld,%ld,%ld,%ld,%.0f,%s\n", run, delay_us, dropped, journal_bytes, entries, recovery_us, reason);
+        fflush(stdout);
+
+        struct bucket *b = &buckets[bucket_index(journal_bytes)];
+        b->runs++;
+        b->total_us += recovery_us;
+        if (recovery_us > b->max_us) {
+            b->max_us = recovery_us;
+        }
+    }
+
+    // Nach allen Ausfällen muss ein regulärer Zyklus wieder fehlerfrei durchlaufen
+    long entries;
+    char reason[128] = "ok";
+    int final_status = wait_status(spawn(binary, "1", NULL));
+    if (check_invariants(final_status, &entries, reason, sizeof(reason)) != 0) {
+        failures++;
+    }
+
+    fprintf(stderr, "\n=== Wiederherstellungszeit nach Journal-Größe ===\n");
+    fprintf(stderr, "%-22s %6s %14s %14s\n", "Journal-Bytes", "Runden", "Mittel [us]", "Max [us]");
+    for (int i = 0; i < MAX_BUCKETS; ++i) {
+        if (buckets[i].runs == 0) {
+            continue;
+        }
+        char range[32];
+        snprintf(range, sizeof(range), "%ld - %ld", i == 0 ? 0L : 1L << i, (1L << (i + 1)) - 1);
+        fprintf(stderr, "%-22s %6d %14.0f %14.0f\n", range, buckets[i].runs,
+                buckets[i].total_us / buckets[i].runs, buckets[i].max_us);
+    }
+    if (power_loss) {
+        fprintf(stderr, "Verworfene, nicht synchronisierte Bytes gesamt: %ld\n", dropped_total);
+    }
+    fprintf(stderr, "Abschlusszyklus: %s\n", reason);
+    fprintf(stderr, "Invarianten verletzt: %d von %d Runden\n", failures, runs + 1);
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,97 @@
+/*
+Fault-Injector für den Crash-Test (LD_PRELOAD)
+
+Simuliert einen Stromausfall: Nur Daten, die per fsync/fdatasync synchronisiert wurden,
+gelten als dauerhaft. Der Injector fängt fsync/fdatasync ab und merkt sich nach jedem
+erfolgreichen Aufruf die Größe der überwachten Datei in einer gemeinsam genutzten
+Zustandsdatei (MAP_SHARED). Nach dem SIGKILL liest crash_harness diesen Wert und verwirft
+alles dahinter - genau das, was nach einem echten Ausfall im Page-Cache verloren ginge.
+
+Umgebungsvariablen:
+  FAULT_STATE_FILE  Pfad der Zustandsdatei (struct fault_state), angelegt vom Harness
+  FAULT_TRACK_FILE  Dateiname, dessen dauerhafte Größe verfolgt wird (Standard: journal.txt)
+
+Kompilieren: gcc -shared -fPIC -o fault_inject.so fault_inject.c -ldl
+*/
+
+#define _GNU_SOURCE
+
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "fault_inject.h"
+
+static struct fault_state *state = NULL;
+static const char *track_file = "journal.txt";
+static int (*real_fsync)(int) = NULL;
+static int (*real_fdatasync)(int) = NULL;
+
+__attribute__((constructor))
+static void fault_inject_init(void) {
+    real_fsync = (int (*)(int))dlsym(RTLD_NEXT, "fsync");
+    real_fdatasync = (int (*)(int))dlsym(RTLD_NEXT, "fdatasync");
+
+    const char *name = getenv("FAULT_TRACK_FILE");
+    if (name != NULL) {
+        track_file = name;
+    }
+    const char *path = getenv("FAULT_STATE_FILE");
+    if (path == NULL) {
+        return;
+    }
+    int fd = open(path, O_RDWR);
+    if (fd == -1) {
+        return;
+    }
+    void *map = mmap(NULL, sizeof(struct fault_state), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map != MAP_FAILED) {
+        state = map;
+    }
+}
+
+// Dauerhafte Größe merken, falls fd auf die überwachte Datei zeigt
+static void record_durable(int fd) {
+    char link[64];
+    char target[512];
+    struct stat st;
+
+    if (state == NULL) {
+        return;
+    }
+    snprintf(link, sizeof(link), "/proc/self/fd/%d", fd);
+    ssize_t len = readlink(link, target, sizeof(target) - 1);
+    if (len <= 0) {
+        return;
+    }
+    target[len] = '\0';
+    const char *base = strrchr(target, '/');
+    base = base ? base + 1 : target;
+    if (strcmp(base, track_file) != 0 || fstat(fd, &st) != 0) {
+        return;
+    }
+    __atomic_store_n(&state->durable_size, (unsigned long long)st.st_size, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&state->sync_count, 1, __ATOMIC_RELEASE);
+}
+
+int fsync(int fd) {
+    int ret = real_fsync(fd);
+    if (ret == 0) {
+        record_durable(fd);
+    }
+    return ret;
+}
+
+int fdatasync(int fd) {
+    int ret = real_fdatasync(fd);
+    if (ret == 0) {
+        record_durable(fd);
+    }
+    return ret;
+}
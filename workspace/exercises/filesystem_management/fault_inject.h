@@ -0,0 +1,10 @@
+#ifndef FAULT_INJECT_H
+#define FAULT_INJECT_H
+
+// Gemeinsamer Zustand zwischen fault_inject.so und crash_harness (MAP_SHARED)
+struct fault_state {
+    unsigned long long durable_size; // Größe der überwachten Datei beim letzten fsync
+    unsigned long long sync_count;   // Anzahl erfolgreicher fsync-Aufrufe
+};
+
+#endif
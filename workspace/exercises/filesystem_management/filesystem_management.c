@@ -50,6 +50,9 @@ Aufgabe:
 #include <fcntl.h>
 #include <time.h>
 
+#include "oplog_index.h"
+#include "metrics.h" // Kennzahlen für metrics_collector (../metrics)
+
 // Konstanten
 #define DIRNAME "testdir"
 #define FILENAME_PREFIX "file"
@@ -57,27 +60,66 @@ Aufgabe:
 #define NUM_FILES 3
 #define DATA "Das ist ein nicht ganz so langer Test."
 #define JOURNAL_FILE "journal.txt"
+#define JOURNAL_ROLLBACK "Zyklus zurückgerollt"
+
+// Gültige Journal-Einträge in Zyklus-Reihenfolge; alles andere gilt als zerrissener Schreibvorgang
+static const char *journal_entries[] = {
+    "Verzeichnis erstellt",
+    "Dateien erstellt",
+    "Dateien aufgelistet",
+    "Dateien gelöscht",
+    "Verzeichnis gelöscht",
+    JOURNAL_ROLLBACK
+};
+#define NUM_JOURNAL_ENTRIES (int)(sizeof(journal_entries) / sizeof(journal_entries[0]))
+
+// Kennzahlen; NULL (wirkungslos), wenn /dev/shm nicht verfügbar ist
+static struct metric *metric_cycles;
+static struct metric *metric_files_created;
+static struct metric *metric_files_deleted;
+static struct metric *metric_rollbacks;
+static struct metric *metric_directory_size;
+static struct metric *metric_journal_sync;
 
 // Funktionen
-void log_operation(const char *operation) {
-    FILE *logfile = fopen(LOGFILE, "a");
-    if (logfile == NULL) {
-        perror("Fehler beim Öffnen der Log-Datei");
+static void setup_metrics(void) {
+    static const double sync_bounds[] = {1e-5, 5e-5, 1e-4, 5e-4, 1e-3, 5e-3, 1e-2, 5e-2, 1e-1};
+    if (metrics_init("filesystem_management") != 0) {
+        perror("Hinweis: Kennzahlen nicht verfügbar");
         return;
     }
-    time_t now = time(NULL); // Aktuelle Zeit abrufen
-    fprintf(logfile, "%s: %s\n", ctime(&now), operation); // Zeitstempel hinzufügen
-    fclose(logfile);
+    metric_cycles = metrics_counter("fsm_cycles_total", "Abgeschlossene Zyklen");
+    metric_files_created = metrics_counter("fsm_files_created_total", "Erstellte Dateien");
+    metric_files_deleted = metrics_counter("fsm_files_deleted_total", "Gelöschte Dateien");
+    metric_rollbacks = metrics_counter("fsm_journal_rollbacks_total", "Bei der Wiederherstellung zurückgerollte Zyklen");
+    metric_directory_size = metrics_gauge("fsm_directory_size_bytes", "Zuletzt gemessene Verzeichnisgröße");
+    metric_journal_sync = metrics_histogram("fsm_journal_fsync_seconds", "Dauer von fsync auf das Journal",
+                                            sync_bounds, sizeof(sync_bounds) / sizeof(sync_bounds[0]));
 }
-void log_operation_with_size(const char *operation, long size) {
+
+// Schreibt einen Log-Eintrag und hängt ihn an den Sidecar-Index an (Zeit, Pfad-Hash -> Byte-Offset)
+static void append_log(const char *operation, const char *suffix) {
     FILE *logfile = fopen(LOGFILE, "a");
     if (logfile == NULL) {
         perror("Fehler beim Öffnen der Log-Datei");
         return;
     }
-    time_t now = time(NULL);
-    fprintf(logfile, "%s: %s (Dateigröße: %ld Bytes)\n", ctime(&now), operation, size);
+    fseek(logfile, 0, SEEK_END);
+    long offset = ftell(logfile);
+    time_t now = time(NULL); // Aktuelle Zeit abrufen
+    int length = fprintf(logfile, "%s: %s%s\n", ctime(&now), operation, suffix); // Zeitstempel hinzufügen
     fclose(logfile);
+    if (offset >= 0 && length > 0) {
+        oplog_index_append(LOGFILE, LOGFILE OPLOG_INDEX_SUFFIX, now, operation, offset, length);
+    }
+}
+void log_operation(const char *operation) {
+    append_log(operation, "");
+}
+void log_operation_with_size(const char *operation, long size) {
+    char suffix[64];
+    snprintf(suffix, sizeof(suffix), " (Dateigröße: %ld Bytes)", size);
+    append_log(operation, suffix);
 }
 int create_directory(const char *dirname) {
     // Verzeichnis erstellen
@@ -116,6 +158,7 @@ int create_files(const char *dirname, int num_files, const char *data) {
         char operation[256];
         snprintf(operation, sizeof(operation), "Datei erstellt: %s", filename);
         log_operation_with_size(operation, size);
+        metrics_inc(metric_files_created);
     }
     return 0;
 }
@@ -168,6 +211,7 @@ int delete_files(const char *dirname) {
             char operation[256];
             snprintf(operation, sizeof(operation), "Datei gelöscht: %s", filepath);
             log_operation_with_size(operation, size);
+            metrics_inc(metric_files_deleted);
         }
     }
     // Verzeichnis schließen
@@ -190,6 +234,15 @@ void update_journal(const char *operation) {
         return;
     }
     fprintf(journal, "%s\n", operation);
+    // Eintrag erst nach fsync als dauerhaft betrachten (Stromausfall-Sicherheit)
+    fflush(journal);
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    if (fsync(fileno(journal)) != 0) {
+        perror("Fehler beim Synchronisieren der Journal-Datei");
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    metrics_observe(metric_journal_sync, (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) / 1e9);
     fclose(journal);
 }
 void apply_journal() {
@@ -225,9 +278,64 @@ long get_directory_size(const char *dirname) {
     closedir(dir);
     return total_size;
 }
-int main() {
-    // Journal anwenden
-    apply_journal();
+// Liefert den Index eines gültigen Journal-Eintrags oder -1
+int journal_entry_index(const char *operation) {
+    for (int i = 0; i < NUM_JOURNAL_ENTRIES; ++i) {
+        if (strcmp(operation, journal_entries[i]) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+// Wiederherstellung nach einem plötzlichen Ausfall:
+// - ein unvollständiger oder unbekannter Eintrag am Journal-Ende wird abgeschnitten
+// - ein unterbrochener Zyklus (Verzeichnis vorhanden oder letzter Eintrag mitten im Zyklus)
+//   wird zurückgerollt und mit JOURNAL_ROLLBACK im Journal abgeschlossen
+int recover_journal() {
+    int last = -1;
+    FILE *journal = fopen(JOURNAL_FILE, "r");
+    if (journal != NULL) {
+        char operation[256];
+        long valid_end = 0;
+        while (fgets(operation, sizeof(operation), journal)) {
+            size_t len = strlen(operation);
+            if (len == 0 || operation[len - 1] != '\n') {
+                break; // Letzte Zeile ohne Newline: Schreibvorgang wurde unterbrochen
+            }
+            operation[len - 1] = 0;
+            int index = journal_entry_index(operation);
+            if (index < 0) {
+                break;
+            }
+            last = index;
+            valid_end = ftell(journal);
+        }
+        fseek(journal, 0, SEEK_END);
+        long total = ftell(journal);
+        fclose(journal);
+        if (valid_end < total) {
+            if (truncate(JOURNAL_FILE, valid_end) != 0) {
+                perror("Fehler beim Abschneiden der Journal-Datei");
+                return 1;
+            }
+            log_operation("Journal: unvollständiger Eintrag verworfen");
+        }
+    }
+    struct stat st;
+    int dir_exists = stat(DIRNAME, &st) == 0 && S_ISDIR(st.st_mode);
+    int cycle_open = last >= 0 && last < NUM_JOURNAL_ENTRIES - 2;
+    if (!dir_exists && !cycle_open) {
+        return 0;
+    }
+    if (dir_exists && (delete_files(DIRNAME) != 0 || delete_directory(DIRNAME) != 0)) {
+        return 1;
+    }
+    update_journal(JOURNAL_ROLLBACK);
+    metrics_inc(metric_rollbacks);
+    return 0;
+}
+// Ein vollständiger Zyklus: Verzeichnis und Dateien anlegen, auflisten, löschen
+int run_cycle() {
     // Verzeichnis erstellen
     if (create_directory(DIRNAME) != 0) {
         return 1;
@@ -242,6 +350,7 @@ int main() {
     long dir_size = get_directory_size(DIRNAME);
     if (dir_size >= 0) {
         printf("Speicherplatznutzung nach dem Erstellen: %ld Bytes\n", dir_size);
+        metrics_set(metric_directory_size, (double)dir_size);
     }
     // Dateien im Verzeichnis auflisten
     if (list_files(DIRNAME) != 0) {
@@ -257,12 +366,38 @@ int main() {
     dir_size = get_directory_size(DIRNAME);
     if (dir_size >= 0) {
         printf("Speicherplatznutzung nach dem Löschen: %ld Bytes\n", dir_size);
+        metrics_set(metric_directory_size, (double)dir_size);
     }
     // Verzeichnis löschen
     if (delete_directory(DIRNAME) != 0) {
         return 1;
     }
     update_journal("Verzeichnis gelöscht");
+    metrics_inc(metric_cycles);
+    return 0;
+}
+// Verwendung: filesystem_management [zyklen] | --recover
+int main(int argc, char *argv[]) {
+    setup_metrics();
+    // Nach einem Ausfall zuerst den konsistenten Zustand wiederherstellen
+    if (recover_journal() != 0) {
+        metrics_shutdown();
+        return 1;
+    }
+    // Journal anwenden
+    apply_journal();
+    if (argc > 1 && strcmp(argv[1], "--recover") == 0) {
+        metrics_shutdown();
+        return 0;
+    }
+    long cycles = argc > 1 ? strtol(argv[1], NULL, 10) : 1;
+    for (long i = 0; i < cycles; ++i) {
+        if (run_cycle() != 0) {
+            metrics_shutdown();
+            return 1;
+        }
+    }
     printf("Alle Operationen erfolgreich abgeschlossen.\n");
+    metrics_shutdown();
     return 0;
 }
@@ -0,0 +1,220 @@
+// Sidecar-Index für operation_log.txt (siehe oplog_index.h)
+
+#define _GNU_SOURCE
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "oplog_index.h"
+
+#define ENTRY_SIZE ((off_t)sizeof(struct oplog_index_entry))
+#define CATCH_UP_BATCH 4096
+
+uint64_t oplog_path_hash(const char *path, size_t len) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < len; ++i) {
+        hash ^= (unsigned char)path[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash ? hash : 1;
+}
+
+const char *oplog_operation_path(const char *operation, size_t operation_len, size_t *len) {
+    const char *end = operation + operation_len;
+    const char *sep = memmem(operation, operation_len, ": ", 2);
+    if (sep == NULL) {
+        return NULL;
+    }
+    const char *path = sep + 2;
+    // Der Pfad endet vor einem Zusatz wie " (Dateigröße: ...)"
+    const char *suffix = memmem(path, (size_t)(end - path), " (", 2);
+    if (suffix != NULL) {
+        end = suffix;
+    }
+    if (end <= path || memchr(path, '/', (size_t)(end - path)) == NULL) {
+        return NULL;
+    }
+    *len = (size_t)(end - path);
+    return path;
+}
+
+static uint64_t operation_hash(const char *operation, size_t operation_len) {
+    size_t len;
+    const char *path = oplog_operation_path(operation, operation_len, &len);
+    return path ? oplog_path_hash(path, len) : 0;
+}
+
+// Öffnet den Index zum Anhängen, verwirft einen zerrissenen letzten Datensatz und liefert den letzten
+static int open_index(const char *index_file, struct oplog_index_entry *last) {
+    int fd = open(index_file, O_RDWR | O_CREAT, 0644);
+    if (fd == -1) {
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return -1;
+    }
+    off_t size = st.st_size - st.st_size % ENTRY_SIZE;
+    if (size != st.st_size && ftruncate(fd, size) != 0) {
+        close(fd);
+        return -1;
+    }
+    memset(last, 0, sizeof(*last));
+    if (size > 0 && pread(fd, last, sizeof(*last), size - ENTRY_SIZE) != ENTRY_SIZE) {
+        close(fd);
+        return -1;
+    }
+    lseek(fd, size, SEEK_SET);
+    return fd;
+}
+
+int oplog_index_append(const char *log_file, const char *index_file, time_t time, const char *operation,
+                       long offset, long length) {
+    struct oplog_index_entry last;
+    int fd = open_index(index_file, &last);
+    if (fd == -1) {
+        perror("Fehler beim Öffnen der Index-Datei");
+        return -1;
+    }
+    uint64_t indexed_end = last.offset + last.length;
+    if (indexed_end != (uint64_t)offset) {
+        // Eintrag schon indexiert (z.B. von oplog_query nachgezogen) oder Lücke davor: Einträge aus der
+        // Zeit vor dem Index oder nach einem Abbruch zwischen Log und Index. Das Nachziehen ab dem
+        // letzten indexierten Eintrag erfasst die Lücke und den neuen Eintrag, der schon im Log steht
+        close(fd);
+        if (indexed_end > (uint64_t)offset) {
+            return 0;
+        }
+        return oplog_index_catch_up(log_file, index_file) >= 0 ? 0 : -1;
+    }
+    struct oplog_index_entry entry = {
+        .time = time < last.time ? last.time : time,
+        .path_hash = operation_hash(operation, strlen(operation)),
+        .offset = (uint64_t)offset,
+        .length = (uint32_t)length,
+    };
+    ssize_t written = write(fd, &entry, sizeof(entry));
+    close(fd);
+    return written == ENTRY_SIZE ? 0 : -1;
+}
+
+// Parst einen Eintrag "<ctime>\n: <operation>\n" ab p; liefert das Ende oder NULL
+static const char *parse_record(const char *p, const char *end, time_t *time,
+                                const char **operation, size_t *operation_len) {
+    const char *nl = memchr(p, '\n', (size_t)(end - p));
+    if (nl == NULL) {
+        return NULL;
+    }
+    char stamp[64];
+    size_t stamp_len = (size_t)(nl - p);
+    if (stamp_len >= sizeof(stamp)) {
+        return NULL;
+    }
+    memcpy(stamp, p, stamp_len);
+    stamp[stamp_len] = '\0';
+    // Viele Einträge teilen sich eine Sekunde; mktime() nur bei neuem Zeitstempel aufrufen
+    static char cached_stamp[64];
+    static time_t cached_time;
+    int cached = strcmp(stamp, cached_stamp) == 0;
+    struct tm tm = {0};
+    tm.tm_isdst = -1;
+    if (!cached) {
+        char *rest = strptime(stamp, "%a %b %d %H:%M:%S %Y", &tm);
+        if (rest == NULL || *rest != '\0') {
+            return NULL;
+        }
+    }
+    const char *op = nl + 1;
+    if (end - op < 2 || op[0] != ':' || op[1] != ' ') {
+        return NULL;
+    }
+    op += 2;
+    const char *op_end = memchr(op, '\n', (size_t)(end - op));
+    if (op_end == NULL) {
+        return NULL; // Eintrag noch nicht vollständig geschrieben
+    }
+    if (!cached) {
+        cached_time = mktime(&tm);
+        memcpy(cached_stamp, stamp, stamp_len + 1);
+    }
+    *time = cached_time;
+    *operation = op;
+    *operation_len = (size_t)(op_end - op);
+    return op_end + 1;
+}
+
+long oplog_index_catch_up(const char *log_file, const char *index_file) {
+    int log_fd = open(log_file, O_RDONLY);
+    if (log_fd == -1) {
+        return -1;
+    }
+    struct stat st;
+    if (fstat(log_fd, &st) != 0) {
+        close(log_fd);
+        return -1;
+    }
+    struct oplog_index_entry last;
+    int index_fd = open_index(index_file, &last);
+    if (index_fd == -1) {
+        close(log_fd);
+        return -1;
+    }
+    uint64_t start = last.offset + last.length;
+    if ((off_t)start >= st.st_size) {
+        close(index_fd);
+        close(log_fd);
+        return 0;
+    }
+    const char *log = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, log_fd, 0);
+    close(log_fd);
+    if (log == MAP_FAILED) {
+        close(index_fd);
+        return -1;
+    }
+    madvise((void *)log, (size_t)st.st_size, MADV_SEQUENTIAL);
+
+    struct oplog_index_entry batch[CATCH_UP_BATCH];
+    int fill = 0;
+    long added = 0;
+    int64_t prev_time = last.time;
+    const char *end = log + st.st_size;
+    const char *p = log + start;
+    while (p < end) {
+        time_t time;
+        const char *operation;
+        size_t operation_len;
+        const char *next = parse_record(p, end, &time, &operation, &operation_len);
+        if (next == NULL) {
+            break;
+        }
+        struct oplog_index_entry *entry = &batch[fill++];
+        entry->time = time < prev_time ? prev_time : time;
+        entry->path_hash = operation_hash(operation, operation_len);
+        entry->offset = (uint64_t)(p - log);
+        entry->length = (uint32_t)(next - p);
+        entry->reserved = 0;
+        prev_time = entry->time;
+        p = next;
+        if (fill == CATCH_UP_BATCH) {
+            if (write(index_fd, batch, sizeof(batch)) != (ssize_t)sizeof(batch)) {
+                added = -1;
+                break;
+            }
+            added += fill;
+            fill = 0;
+        }
+    }
+    if (added >= 0 && fill > 0) {
+        ssize_t bytes = (ssize_t)(fill * sizeof(batch[0]));
+        added = write(index_fd, batch, (size_t)bytes) == bytes ? added + fill : -1;
+    }
+    munmap((void *)log, (size_t)st.st_size);
+    close(index_fd);
+    return added;
+}
@@ -0,0 +1,43 @@
+#ifndef OPLOG_INDEX_H
+#define OPLOG_INDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+/*
+Sidecar-Index für operation_log.txt
+
+Pro Log-Eintrag wird ein Datensatz fester Größe an <log>.idx angehängt. Die Zeitstempel sind
+monoton (rückwärts laufende Uhren werden auf den Vorgänger geklemmt), daher findet eine
+Binärsuche im gemappten Index jedes Zeitfenster direkt. Der Pfad-Hash erlaubt das Filtern
+nach einer Datei, ohne den Log-Text zu lesen.
+*/
+
+#define OPLOG_INDEX_SUFFIX ".idx"
+
+struct oplog_index_entry {
+    int64_t time;       // Zeitstempel (Sekunden seit Epoch, monoton)
+    uint64_t path_hash; // FNV-1a des Dateipfads, 0 wenn die Operation keinen Pfad enthält
+    uint64_t offset;    // Byte-Offset des Eintrags im Log
+    uint32_t length;    // Länge des Eintrags in Bytes
+    uint32_t reserved;
+};
+
+// Hash des Pfads (len Bytes); liefert nie 0
+uint64_t oplog_path_hash(const char *path, size_t len);
+
+// Sucht den Pfad in einem Operationstext ("Datei erstellt: <pfad> (...)"); Länge in *len
+const char *oplog_operation_path(const char *operation, size_t operation_len, size_t *len);
+
+// Hängt einen Index-Eintrag für den Log-Eintrag bei offset an; 0 bei Erfolg. Endet der Index vor
+// offset (Einträge aus der Zeit vor dem Index oder verlorene Index-Schreibvorgänge), werden die
+// fehlenden Einträge samt dem neuen aus log_file nachgezogen
+int oplog_index_append(const char *log_file, const char *index_file, time_t time, const char *operation,
+                       long offset, long length);
+
+// Indexiert alle Log-Einträge hinter dem letzten indexierten Eintrag nach;
+// liefert die Anzahl neuer Einträge oder -1 bei Fehlern
+long oplog_index_catch_up(const char *log_file, const char *index_file);
+
+#endif
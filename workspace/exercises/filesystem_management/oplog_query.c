@@ -0,0 +1,246 @@
+/*
+Abfrage-Werkzeug für operation_log.txt: "Was ist mit Datei X zwischen T1 und T2 passiert?"
+
+Statt das ganze Log zu durchsuchen, werden Log und Sidecar-Index (operation_log.txt.idx) per
+mmap eingeblendet. Eine Binärsuche über die monotonen Zeitstempel des Index liefert den Anfang
+des Zeitfensters, der Pfad-Hash filtert die Einträge, und nur die Treffer werden direkt aus dem
+gemappten Log ausgegeben. Der Aufwand hängt damit vom Fenster ab, nicht von der Log-Größe.
+
+Fehlende Index-Einträge (z.B. nach einem Absturz zwischen Log- und Index-Schreiben oder für
+alte Logs ohne Index) werden vor der Abfrage inkrementell nachgetragen.
+
+Verwendung: ./oplog_query [-l log] [-p pfad] [-s start] [-e ende] [-c] [-v]
+            ./oplog_query [-l log] -G anzahl     (synthetische Einträge für Benchmarks anhängen)
+  start/ende: Sekunden seit Epoch oder "JJJJ-MM-TT HH:MM:SS" (lokale Zeit)
+  -c  nur die Anzahl der Treffer ausgeben
+  -v  Statistik (Index-Größe, durchsuchte Einträge, Abfragezeit) auf stderr
+*/
+
+#define _GNU_SOURCE
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "oplog_index.h"
+
+#define LOGFILE "operation_log.txt"
+#define GEN_FILES 64
+
+struct mapping {
+    const void *data;
+    size_t size;
+};
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static int map_file(const char *path, struct mapping *m) {
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) {
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return -1;
+    }
+    m->size = (size_t)st.st_size;
+    m->data = NULL;
+    if (m->size > 0) {
+        m->data = mmap(NULL, m->size, PROT_READ, MAP_SHARED, fd, 0);
+        if (m->data == MAP_FAILED) {
+            close(fd);
+            return -1;
+        }
+    }
+    close(fd);
+    return 0;
+}
+
+static void unmap_file(struct mapping *m) {
+    if (m->data != NULL) {
+        munmap((void *)m->data, m->size);
+    }
+}
+
+static int parse_time(const char *arg, int64_t *out) {
+    char *end;
+    long long value = strtoll(arg, &end, 10);
+    if (*end == '\0') {
+        *out = value;
+        return 0;
+    }
+    struct tm tm = {0};
+    tm.tm_isdst = -1;
+    end = strptime(arg, "%Y-%m-%d %H:%M:%S", &tm);
+    if (end == NULL || *end != '\0') {
+        return -1;
+    }
+    *out = (int64_t)mktime(&tm);
+    return 0;
+}
+
+// Erster Index-Eintrag mit time >= start
+static size_t lower_bound(const struct oplog_index_entry *index, size_t count, int64_t start) {
+    size_t lo = 0;
+    size_t hi = count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (index[mid].time < start) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// Hash-Treffer gegen den tatsächlichen Pfad im Log-Eintrag prüfen (Kollisionen ausschließen)
+static int record_has_path(const char *record, size_t length, const char *path, size_t path_len) {
+    const char *op = memchr(record, '\n', length);
+    if (op == NULL || (size_t)(op - record) + 3 > length) {
+        return 0;
+    }
+    op += 3; // "\n: " überspringen
+    size_t op_len = length - (size_t)(op - record) - 1;
+    size_t found_len;
+    const char *found = oplog_operation_path(op, op_len, &found_len);
+    return found != NULL && found_len == path_len && memcmp(found, path, path_len) == 0;
+}
+
+// Synthetische Einträge im Format von log_operation() anhängen, ein Eintrag pro Sekunde ab jetzt
+static int generate(const char *log_file, long count) {
+    FILE *log = fopen(log_file, "a");
+    if (log == NULL) {
+        perror("Fehler beim Öffnen der Log-Datei");
+        return -1;
+    }
+    time_t t = time(NULL);
+    for (long i = 0; i < count; ++i, ++t) {
+        fprintf(log, "%s: Datei %s: testdir/file%ld.txt (Dateigröße: %ld Bytes)\n",
+                ctime(&t), (i & 1) ? "gelöscht" : "erstellt", i % GEN_FILES, 39 + i % 7);
+    }
+    return fclose(log);
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Verwendung: %s [-l log] [-p pfad] [-s start] [-e ende] [-c] [-v] | [-l log] -G anzahl\n", prog);
+}
+
+int main(int argc, char *argv[]) {
+    const char *log_file = LOGFILE;
+    const char *path = NULL;
+    int64_t start = INT64_MIN;
+    int64_t end = INT64_MAX;
+    int count_only = 0;
+    int verbose = 0;
+    long generate_count = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "l:p:s:e:cvG:h")) != -1) {
+        switch (opt) {
+        case 'l': log_file = optarg; break;
+        case 'p': path = optarg; break;
+        case 's':
+            if (parse_time(optarg, &start) != 0) {
+                fprintf(stderr, "Ungültige Startzeit: %s\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        case 'e':
+            if (parse_time(optarg, &end) != 0) {
+                fprintf(stderr, "Ungültige Endzeit: %s\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        case 'c': count_only = 1; break;
+        case 'v': verbose = 1; break;
+        case 'G': generate_count = atol(optarg); break;
+        default: usage(argv[0]); return opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    char index_file[4096];
+    snprintf(index_file, sizeof(index_file), "%s%s", log_file, OPLOG_INDEX_SUFFIX);
+
+    if (generate_count > 0 && generate(log_file, generate_count) != 0) {
+        return EXIT_FAILURE;
+    }
+
+    // Index bis zum Log-Ende nachtragen
+    double t0 = now_ms();
+    long added = oplog_index_catch_up(log_file, index_file);
+    double t1 = now_ms();
+    if (added < 0) {
+        fprintf(stderr, "Warnung: Index konnte nicht aktualisiert werden (%s)\n", index_file);
+    }
+    if (verbose || generate_count > 0) {
+        fprintf(stderr, "Index nachgetragen: %ld Einträge in %.2f ms\n", added < 0 ? 0 : added, t1 - t0);
+    }
+    if (generate_count > 0) {
+        return EXIT_SUCCESS;
+    }
+
+    struct mapping log_map;
+    struct mapping index_map;
+    if (map_file(log_file, &log_map) != 0) {
+        perror(log_file);
+        return EXIT_FAILURE;
+    }
+    if (map_file(index_file, &index_map) != 0) {
+        perror(index_file);
+        unmap_file(&log_map);
+        return EXIT_FAILURE;
+    }
+
+    double q0 = now_ms();
+    const struct oplog_index_entry *index = index_map.data;
+    size_t entries = index_map.size / sizeof(*index);
+    const char *log = log_map.data;
+    uint64_t hash = path ? oplog_path_hash(path, strlen(path)) : 0;
+    size_t path_len = path ? strlen(path) : 0;
+    size_t scanned = 0;
+    size_t matches = 0;
+
+    for (size_t i = lower_bound(index, entries, start); i < entries && index[i].time <= end; ++i) {
+        const struct oplog_index_entry *e = &index[i];
+        scanned++;
+        if (path != NULL && e->path_hash != hash) {
+            continue;
+        }
+        // Einträge hinter dem Log-Ende (abgeschnittenes Log) ignorieren
+        if (e->offset + e->length > log_map.size) {
+            continue;
+        }
+        const char *record = log + e->offset;
+        if (path != NULL && !record_has_path(record, e->length, path, path_len)) {
+            continue;
+        }
+        matches++;
+        if (!count_only) {
+            fwrite(record, 1, e->length, stdout);
+        }
+    }
+    double q1 = now_ms();
+
+    if (count_only) {
+        printf("%zu\n", matches);
+    }
+    if (verbose) {
+        fprintf(stderr, "Log: %zu Bytes, Index: %zu Einträge, durchsucht: %zu, Treffer: %zu, Abfrage: %.3f ms\n",
+                log_map.size, entries, scanned, matches, q1 - q0);
+    }
+    unmap_file(&index_map);
+    unmap_file(&log_map);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,49 @@
+#!/bin/bash
+
+# Headless frame-time benchmark for the sensor dashboard
+# Runs gtk_app in benchmark mode at several sample rates and prints frame interval
+# and draw time statistics. Draw time should stay flat while the rate grows.
+#
+# Usage: ./bench_headless.sh [frames] [rates...]
+# Uses broadwayd if available, otherwise Xvfb (apt install xvfb)
+
+FRAMES=${1:-600}
+shift
+RATES=${@:-1000 10000 100000 1000000}
+
+if [ ! -x ./gtk_app ]; then
+    echo "Building gtk_app..."
+    make || exit 1
+fi
+
+# Start a headless display server
+SERVER_PID=""
+if command -v broadwayd >/dev/null 2>&1; then
+    echo "Using broadwayd (GDK_BACKEND=broadway)"
+    broadwayd :5 >/dev/null 2>&1 &
+    SERVER_PID=$!
+    export GDK_BACKEND=broadway
+    export BROADWAY_DISPLAY=:5
+elif command -v Xvfb >/dev/null 2>&1; then
+    echo "Using Xvfb on :99"
+    Xvfb :99 -screen 0 1280x720x24 >/dev/null 2>&1 &
+    SERVER_PID=$!
+    export GDK_BACKEND=x11
+    export DISPLAY=:99
+else
+    echo "Neither broadwayd nor Xvfb found"
+    exit 1
+fi
+trap 'kill $SERVER_PID 2>/dev/null' EXIT
+sleep 1
+
+for RATE in $RATES; do
+    echo ""
+    echo "=== $RATE samples/s, $FRAMES frames ==="
+    # Window grows with the rate so that it always covers about ten seconds
+    WINDOW=$((RATE * 10))
+    if [ $WINDOW -ge 1048576 ]; then
+        WINDOW=1000000
+    fi
+    timeout 120 ./gtk_app -r "$RATE" -w "$WINDOW" -b "$FRAMES" 2>/dev/null || echo "gtk_app failed (exit $?)"
+done
@@ -0,0 +1,125 @@
+// Min/max decimation (see decimator.h)
+
+#include <float.h>
+#include <stdlib.h>
+
+#include "decimator.h"
+
+static void clear_column(struct decimator *dec, int64_t column) {
+    int slot = (int)(column % dec->columns);
+    dec->min[slot] = FLT_MAX;
+    dec->max[slot] = -FLT_MAX;
+}
+
+static int alloc_columns(struct decimator *dec, int columns) {
+    float *min = malloc((size_t)columns * sizeof(float));
+    float *max = malloc((size_t)columns * sizeof(float));
+    if (min == NULL || max == NULL) {
+        free(min);
+        free(max);
+        return -1;
+    }
+    free(dec->min);
+    free(dec->max);
+    dec->min = min;
+    dec->max = max;
+    dec->columns = columns;
+    dec->samples_per_column = (dec->window + (uint64_t)columns - 1) / (uint64_t)columns;
+    if (dec->samples_per_column == 0) {
+        dec->samples_per_column = 1;
+    }
+    for (int i = 0; i < columns; ++i) {
+        dec->min[i] = FLT_MAX;
+        dec->max[i] = -FLT_MAX;
+    }
+    dec->current_column = -1;
+    return 0;
+}
+
+int decimator_init(struct decimator *dec, int columns, uint64_t window) {
+    dec->min = NULL;
+    dec->max = NULL;
+    dec->window = window > 0 ? window : 1;
+    dec->next_index = 0;
+    dec->dropped = 0;
+    dec->last_time_ns = 0;
+    return alloc_columns(dec, columns > 0 ? columns : 1);
+}
+
+void decimator_destroy(struct decimator *dec) {
+    free(dec->min);
+    free(dec->max);
+    dec->min = NULL;
+    dec->max = NULL;
+}
+
+int decimator_resize(struct decimator *dec, struct sample_ring *ring, int columns) {
+    if (columns < 1) {
+        columns = 1;
+    }
+    if (alloc_columns(dec, columns) != 0) {
+        return -1;
+    }
+    // Re-read the visible window (one-off O(window))
+    uint64_t head = sample_ring_head(ring);
+    uint64_t span = dec->window < sample_ring_capacity(ring) ? dec->window : sample_ring_capacity(ring) - 1;
+    dec->next_index = head > span ? head - span : 0;
+    decimator_update(dec, ring);
+    return 0;
+}
+
+uint64_t decimator_update(struct decimator *dec, struct sample_ring *ring) {
+    uint64_t head = sample_ring_head(ring);
+    uint64_t oldest = sample_ring_valid_from(ring);
+    if (dec->next_index < oldest) {
+        dec->dropped += oldest - dec->next_index;
+        dec->next_index = oldest;
+    }
+    uint64_t start = dec->next_index;
+    for (uint64_t i = start; i < head; ++i) {
+        const struct sample *s = sample_ring_at(ring, i);
+        float value = s->value;
+        int64_t time_ns = s->time_ns;
+        int64_t column = (int64_t)(i / dec->samples_per_column);
+        if (column > dec->current_column) {
+            // Clear skipped and new columns (at most one full round)
+            int64_t first = dec->current_column + 1;
+            if (column - first >= dec->columns) {
+                first = column - dec->columns + 1;
+            }
+            for (int64_t c = first; c <= column; ++c) {
+                clear_column(dec, c);
+            }
+            dec->current_column = column;
+        }
+        int slot = (int)(column % dec->columns);
+        if (value < dec->min[slot]) {
+            dec->min[slot] = value;
+        }
+        if (value > dec->max[slot]) {
+            dec->max[slot] = value;
+        }
+        dec->last_time_ns = time_ns;
+    }
+    // Anything overwritten while reading counts as dropped (the next frame catches up)
+    uint64_t valid = sample_ring_valid_from(ring);
+    if (valid > start) {
+        dec->dropped += (valid < head ? valid : head) - start;
+    }
+    dec->next_index = head;
+    return head - start;
+}
+
+int decimator_column(const struct decimator *dec, int x, float *min, float *max) {
+    int64_t column = dec->current_column - (dec->columns - 1) + x;
+    if (dec->current_column < 0 || column < 0) {
+        return 0;
+    }
+    int slot = (int)(column % dec->columns);
+    if (dec->min[slot] > dec->max[slot]) {
+        return 0;
+    }
+    *min = dec->min[slot];
+    *max = dec->max[slot];
+    return 1;
+}
@@ -0,0 +1,45 @@
+#ifndef DECIMATOR_H
+#define DECIMATOR_H
+
+#include <stdint.h>
+
+#include "sample_ring.h"
+
+/*
+Min/max decimation to pixel columns.
+
+The visible window spans window samples; each of the columns columns reduces
+samples_per_column = ceil(window / columns) consecutive samples to their minimum and maximum.
+The columns form a ring themselves: each frame only folds in the samples that arrived since the
+previous frame, and drawing always touches exactly columns columns. Per-frame cost therefore
+depends on the width and the number of new samples, not on the window size.
+
+Spikes survive decimation because every column shows its full min/max range.
+*/
+
+struct decimator {
+    int columns;
+    uint64_t window;
+    uint64_t samples_per_column;
+    float *min;                     // per column, min > max = empty
+    float *max;
+    int64_t current_column;         // running column number of the newest sample, -1 = none
+    uint64_t next_index;            // next ring index to fold in
+    uint64_t dropped;               // samples overtaken by the writer before being shown
+    int64_t last_time_ns;           // timestamp of the newest sample
+};
+
+// Returns 0 on success
+int decimator_init(struct decimator *dec, int columns, uint64_t window);
+void decimator_destroy(struct decimator *dec);
+
+// New width: reallocate the columns and rebuild the window from the ring once
+int decimator_resize(struct decimator *dec, struct sample_ring *ring, int columns);
+
+// Fold in new samples from the ring; returns the number of samples consumed
+uint64_t decimator_update(struct decimator *dec, struct sample_ring *ring);
+
+// Column x (0 = left, columns - 1 = newest); returns 0 if empty
+int decimator_column(const struct decimator *dec, int x, float *min, float *max);
+
+#endif
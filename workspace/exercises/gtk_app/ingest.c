@@ -0,0 +1,109 @@
+// Ingestion thread (see ingest.h)
+
+#define _DEFAULT_SOURCE // M_PI, clock_nanosleep
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "ingest.h"
+
+#define TICK_NS 1000000L // batch interval of the synthetic source
+
+static int64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void synthetic_loop(struct ingest *ingest) {
+    struct timespec next;
+    unsigned int seed = 1;
+    uint64_t n = 0;
+    int64_t start = now_ns();
+    clock_gettime(CLOCK_MONOTONIC, &next);
+
+    while (!atomic_load_explicit(&ingest->stop, memory_order_relaxed)) {
+        int64_t now = now_ns();
+        // Generate as many samples as are due since the start
+        double due = (double)(now - start) * ingest->rate / 1e9;
+        while ((double)n < due) {
+            double t = (double)n / ingest->rate;
+            double value = 40.0 * sin(2.0 * M_PI * 0.5 * t) + 10.0 * sin(2.0 * M_PI * 7.0 * t) + 50.0;
+            value += ((double)rand_r(&seed) / RAND_MAX - 0.5) * 4.0;
+            if (rand_r(&seed) % 20000 == 0) {
+                value += 35.0; // rare spike: must stay visible despite decimation
+            }
+            int64_t stamp = start + (int64_t)(t * 1e9);
+            sample_ring_push(ingest->ring, stamp, (float)value);
+            n++;
+        }
+        atomic_store_explicit(&ingest->produced, n, memory_order_relaxed);
+
+        next.tv_nsec += TICK_NS;
+        if (next.tv_nsec >= 1000000000L) {
+            next.tv_sec += 1;
+            next.tv_nsec -= 1000000000L;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+    }
+}
+
+static void file_loop(struct ingest *ingest) {
+    FILE *file = fopen(ingest->input_path, "r");
+    if (file == NULL) {
+        perror("Failed to open input");
+        return;
+    }
+    char line[128];
+    unsigned long long n = 0;
+    while (!atomic_load_explicit(&ingest->stop, memory_order_relaxed) && fgets(line, sizeof(line), file) != NULL) {
+        char *end;
+        float value = strtof(line, &end);
+        if (end == line) {
+            continue;
+        }
+        sample_ring_push(ingest->ring, now_ns(), value);
+        atomic_store_explicit(&ingest->produced, ++n, memory_order_relaxed);
+    }
+    fclose(file);
+}
+
+static void *ingest_main(void *arg) {
+    struct ingest *ingest = arg;
+    if (ingest->input_path != NULL) {
+        file_loop(ingest);
+    } else {
+        synthetic_loop(ingest);
+    }
+    return NULL;
+}
+
+int ingest_start(struct ingest *ingest, struct sample_ring *ring, const char *input_path, double rate) {
+    ingest->ring = ring;
+    ingest->input_path = input_path;
+    ingest->rate = rate > 0.0 ? rate : 1000.0;
+    atomic_init(&ingest->stop, 0);
+    atomic_init(&ingest->produced, 0);
+    if (pthread_create(&ingest->thread, NULL, ingest_main, ingest) != 0) {
+        perror("Failed to start ingestion thread");
+        return -1;
+    }
+    ingest->running = 1;
+    return 0;
+}
+
+void ingest_stop(struct ingest *ingest) {
+    if (!ingest->running) {
+        return;
+    }
+    ingest->running = 0;
+    atomic_store_explicit(&ingest->stop, 1, memory_order_relaxed);
+    // fgets blocks on a FIFO without writer, so do not wait for the thread
+    if (ingest->input_path != NULL) {
+        pthread_detach(ingest->thread);
+        return;
+    }
+    pthread_join(ingest->thread, NULL);
+}
@@ -0,0 +1,32 @@
+#ifndef INGEST_H
+#define INGEST_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "sample_ring.h"
+
+/*
+Ingestion thread: writes samples into the ring independently of the UI thread.
+
+Sources:
+- synthetic: rate samples per second (sine, noise, occasional spikes), generated in batches
+  every millisecond on an absolute timer
+- file/FIFO: one number per line, e.g. from the controller: mkfifo /tmp/sensor; ./gtk_app -i /tmp/sensor
+*/
+
+struct ingest {
+    struct sample_ring *ring;
+    const char *input_path;   // NULL = synthetic
+    double rate;              // samples per second (synthetic)
+    pthread_t thread;
+    int running;
+    _Atomic int stop;
+    _Atomic unsigned long long produced;
+};
+
+// Returns 0 on success
+int ingest_start(struct ingest *ingest, struct sample_ring *ring, const char *input_path, double rate);
+void ingest_stop(struct ingest *ingest);
+
+#endif
@@ -1,28 +1,288 @@
+#define _POSIX_C_SOURCE 200809L // getopt
+
 #include <gtk/gtk.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "decimator.h"
+#include "ingest.h"
+#include "sample_ring.h"
+
+/*
+Live sensor dashboard.
+
+The ingestion thread writes into a lock-free ring at any rate; the UI thread never waits for it.
+Once per display frame (tick callback of the frame clock) the decimator folds the new samples
+into one min/max pair per pixel column, and the draw handler strokes exactly one path with one
+vertical segment per column. Drawing cost thus depends on the window width only.
+
+Usage: ./gtk_app [-r samples_per_s] [-w window_samples] [-i input] [-b bench_frames]
+  -i  read one value per line from a file or FIFO instead of the synthetic source
+  -b  benchmark mode: print frame and draw time statistics after N frames and quit
+*/
+
+#define DEFAULT_RATE 5000.0
+#define DEFAULT_WINDOW 50000
+#define RING_CAPACITY (1U << 20)
+#define LABEL_INTERVAL_US 500000
+
+struct dashboard {
+    double rate;
+    uint64_t window;
+    const char *input;
+    int bench_frames;
+
+    struct sample_ring ring;
+    struct ingest ingest;
+    struct decimator dec;
+    GtkApplication *app;
+    GtkWidget *area;
+    GtkWidget *label;
+
+    gint64 last_frame_time;
+    gint64 last_label_time;
+    unsigned long long last_produced;
+    double draw_us_sum;
+    int draws;
+
+    // Benchmark mode
+    int frames;
+    double *frame_us;
+    double *draw_us;
+    int bench_draws;
+};
+
+static int compare_double(const void *a, const void *b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static void print_stats(const char *name, double *values, int count) {
+    if (count == 0) {
+        printf("%-14s no values\n", name);
+        return;
+    }
+    double sum = 0.0;
+    for (int i = 0; i < count; ++i) {
+        sum += values[i];
+    }
+    qsort(values, (size_t)count, sizeof(double), compare_double);
+    int p99 = (int)((double)count * 0.99);
+    if (p99 >= count) {
+        p99 = count - 1;
+    }
+    printf("%-14s avg %8.1f us  p99 %8.1f us  max %8.1f us  (%d)\n", name, sum / count, values[p99],
+           values[count - 1], count);
+}
+
+static void finish_bench(struct dashboard *dash) {
+    unsigned long long produced = atomic_load(&dash->ingest.produced);
+    printf("rate %.0f/s, window %llu samples, width %d px\n", dash->rate, (unsigned long long)dash->window,
+           dash->dec.columns);
+    print_stats("frame interval", dash->frame_us, dash->frames - 1);
+    print_stats("draw", dash->draw_us, dash->bench_draws);
+    printf("ingested %llu samples, dropped %llu\n", produced, (unsigned long long)dash->dec.dropped);
+    fflush(stdout);
+    g_application_quit(G_APPLICATION(dash->app));
+}
+
+static gboolean on_draw(GtkWidget *widget, cairo_t *cr, gpointer user_data) {
+    struct dashboard *dash = user_data;
+    gint64 start = g_get_monotonic_time();
+    int width = gtk_widget_get_allocated_width(widget);
+    int height = gtk_widget_get_allocated_height(widget);
+
+    if (width != dash->dec.columns) {
+        decimator_resize(&dash->dec, &dash->ring, width);
+    }
+
+    cairo_set_source_rgb(cr, 0.08, 0.08, 0.1);
+    cairo_paint(cr);
+
+    // Y range from the visible columns
+    float low = 0.0f;
+    float high = 0.0f;
+    int found = 0;
+    for (int x = 0; x < dash->dec.columns; ++x) {
+        float min;
+        float max;
+        if (!decimator_column(&dash->dec, x, &min, &max)) {
+            continue;
+        }
+        if (!found || min < low) {
+            low = min;
+        }
+        if (!found || max > high) {
+            high = max;
+        }
+        found = 1;
+    }
+
+    if (found) {
+        double span = high - low > 1e-6f ? (double)(high - low) : 1.0;
+        double scale = (height - 8) / span;
+        double base = height - 4;
+
+        cairo_set_source_rgb(cr, 0.3, 0.85, 0.4);
+        cairo_set_line_width(cr, 1.0);
+        for (int x = 0; x < dash->dec.columns; ++x) {
+            float min;
+            float max;
+            if (!decimator_column(&dash->dec, x, &min, &max)) {
+                continue;
+            }
+            double top = base - (max - low) * scale;
+            double bottom = base - (min - low) * scale;
+            if (bottom - top < 1.0) {
+                bottom = top + 1.0; // flat columns still get one pixel
+            }
+            cairo_move_to(cr, x + 0.5, top);
+            cairo_line_to(cr, x + 0.5, bottom);
+        }
+        cairo_stroke(cr);
+    }
+
+    double elapsed = (double)(g_get_monotonic_time() - start);
+    dash->draw_us_sum += elapsed;
+    dash->draws++;
+    if (dash->bench_frames > 0 && dash->bench_draws < dash->bench_frames) {
+        dash->draw_us[dash->bench_draws++] = elapsed;
+    }
+    return FALSE;
+}
+
+static void update_label(struct dashboard *dash, gint64 now) {
+    unsigned long long produced = atomic_load(&dash->ingest.produced);
+    double seconds = (double)(now - dash->last_label_time) / 1e6;
+    double rate = seconds > 0.0 ? (double)(produced - dash->last_produced) / seconds : 0.0;
+    double draw = dash->draws > 0 ? dash->draw_us_sum / dash->draws : 0.0;
+
+    char text[160];
+    snprintf(text, sizeof(text), "%.0f samples/s   %llu samples/column   draw %.0f us   dropped %llu", rate,
+             (unsigned long long)dash->dec.samples_per_column, draw, (unsigned long long)dash->dec.dropped);
+    gtk_label_set_text(GTK_LABEL(dash->label), text);
+
+    dash->last_label_time = now;
+    dash->last_produced = produced;
+    dash->draw_us_sum = 0.0;
+    dash->draws = 0;
+}
+
+// Runs once per display frame; redraws only when new samples arrived
+static gboolean on_tick(GtkWidget *widget, GdkFrameClock *clock, gpointer user_data) {
+    struct dashboard *dash = user_data;
+    gint64 frame_time = gdk_frame_clock_get_frame_time(clock);
+
+    if (dash->bench_frames > 0) {
+        if (dash->frames > 0) {
+            dash->frame_us[dash->frames - 1] = (double)(frame_time - dash->last_frame_time);
+        }
+        dash->frames++;
+        if (dash->frames > dash->bench_frames) {
+            finish_bench(dash);
+            return G_SOURCE_REMOVE;
+        }
+    }
+    dash->last_frame_time = frame_time;
+
+    if (decimator_update(&dash->dec, &dash->ring) > 0) {
+        gtk_widget_queue_draw(widget);
+    }
+    if (frame_time - dash->last_label_time >= LABEL_INTERVAL_US) {
+        update_label(dash, frame_time);
+    }
+    return G_SOURCE_CONTINUE;
+}
 
 static void activate(GtkApplication *app, gpointer user_data) {
+    struct dashboard *dash = user_data;
     GtkWidget *window;
-    (void)user_data; // Suppress unused parameter warning
 
     window = gtk_application_window_new(app);
-    gtk_window_set_title(GTK_WINDOW(window), "Hello, Embedded Linux");
+    gtk_window_set_title(GTK_WINDOW(window), "Sensor Dashboard");
     gtk_window_set_default_size(GTK_WINDOW(window), 640, 480);
 
-    GtkWidget *label = gtk_label_new("Hello, Embedded Linux World!");
-    gtk_container_add(GTK_CONTAINER(window), label);
+    GtkWidget *box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 4);
+    gtk_container_add(GTK_CONTAINER(window), box);
+
+    dash->area = gtk_drawing_area_new();
+    gtk_widget_set_size_request(dash->area, 320, 200);
+    gtk_box_pack_start(GTK_BOX(box), dash->area, TRUE, TRUE, 0);
+    g_signal_connect(dash->area, "draw", G_CALLBACK(on_draw), dash);
+    gtk_widget_add_tick_callback(dash->area, on_tick, dash, NULL);
+
+    dash->label = gtk_label_new("waiting for samples...");
+    gtk_box_pack_start(GTK_BOX(box), dash->label, FALSE, FALSE, 2);
 
     gtk_widget_show_all(window);
+
+    if (ingest_start(&dash->ingest, &dash->ring, dash->input, dash->rate) != 0) {
+        g_application_quit(G_APPLICATION(app));
+    }
 }
 
 int main(int argc, char **argv) {
     GtkApplication *app;
     int status;
+    struct dashboard dash = {
+        .rate = DEFAULT_RATE,
+        .window = DEFAULT_WINDOW,
+    };
+    int opt;
+
+    while ((opt = getopt(argc, argv, "r:w:i:b:")) != -1) {
+        switch (opt) {
+        case 'r':
+            dash.rate = atof(optarg);
+            break;
+        case 'w':
+            dash.window = strtoull(optarg, NULL, 10);
+            break;
+        case 'i':
+            dash.input = optarg;
+            break;
+        case 'b':
+            dash.bench_frames = atoi(optarg);
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-r samples_per_s] [-w window_samples] [-i input] [-b bench_frames]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+    if (dash.rate <= 0.0 || dash.window == 0 || dash.window >= RING_CAPACITY) {
+        fprintf(stderr, "Invalid rate or window (window must be below %u)\n", RING_CAPACITY);
+        return 1;
+    }
+
+    if (sample_ring_init(&dash.ring, RING_CAPACITY) != 0 || decimator_init(&dash.dec, 1, dash.window) != 0) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    if (dash.bench_frames > 0) {
+        dash.frame_us = calloc((size_t)dash.bench_frames, sizeof(double));
+        dash.draw_us = calloc((size_t)dash.bench_frames, sizeof(double));
+        if (dash.frame_us == NULL || dash.draw_us == NULL) {
+            fprintf(stderr, "Out of memory\n");
+            return 1;
+        }
+    }
 
-    app = gtk_application_new("com.example.GtkApp", G_APPLICATION_DEFAULT_FLAGS);
-    g_signal_connect(app, "activate", G_CALLBACK(activate), NULL);
+    app = gtk_application_new("com.example.GtkApp", G_APPLICATION_NON_UNIQUE);
+    dash.app = app;
+    g_signal_connect(app, "activate", G_CALLBACK(activate), &dash);
 
-    status = g_application_run(G_APPLICATION(app), argc, argv);
+    // Our options are consumed above, GApplication only sees the program name
+    status = g_application_run(G_APPLICATION(app), 1, argv);
     g_object_unref(app);
 
+    ingest_stop(&dash.ingest);
+    decimator_destroy(&dash.dec);
+    free(dash.frame_us);
+    free(dash.draw_us);
+    // The ring is left to the OS: a detached FIFO reader may still hold a pointer to it
+
     return status;
-}
\ No newline at end of file
+}
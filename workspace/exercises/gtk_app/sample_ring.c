@@ -0,0 +1,24 @@
+// Sample ring buffer (see sample_ring.h)
+
+#include <stdlib.h>
+
+#include "sample_ring.h"
+
+int sample_ring_init(struct sample_ring *ring, uint64_t capacity) {
+    uint64_t size = 1;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    ring->data = calloc(size, sizeof(struct sample));
+    if (ring->data == NULL) {
+        return -1;
+    }
+    ring->mask = size - 1;
+    atomic_init(&ring->head, 0);
+    return 0;
+}
+
+void sample_ring_destroy(struct sample_ring *ring) {
+    free(ring->data);
+    ring->data = NULL;
+}
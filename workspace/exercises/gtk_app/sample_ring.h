@@ -0,0 +1,61 @@
+#ifndef SAMPLE_RING_H
+#define SAMPLE_RING_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+/*
+Lock-free sample ring: exactly one writer (the ingestion thread), any number of readers.
+
+The writer never blocks and overwrites the oldest samples. Every sample has a running index;
+head is the index of the next sample to be written. A reader copies samples and then checks
+with sample_ring_valid_from whether they were overwritten meanwhile (seqlock style). This keeps
+the UI fully decoupled from the acquisition rate.
+*/
+
+struct sample {
+    int64_t time_ns;      // CLOCK_MONOTONIC at acquisition
+    float value;
+};
+
+struct sample_ring {
+    _Atomic uint64_t head;
+    char pad[56];         // head alone in its cache line
+    uint64_t mask;        // capacity - 1 (power of two)
+    struct sample *data;
+};
+
+// capacity is rounded up to a power of two; returns 0 on success
+int sample_ring_init(struct sample_ring *ring, uint64_t capacity);
+void sample_ring_destroy(struct sample_ring *ring);
+
+static inline uint64_t sample_ring_capacity(const struct sample_ring *ring) {
+    return ring->mask + 1;
+}
+
+// Writer only
+static inline void sample_ring_push(struct sample_ring *ring, int64_t time_ns, float value) {
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    struct sample *slot = &ring->data[head & ring->mask];
+    slot->time_ns = time_ns;
+    slot->value = value;
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+static inline uint64_t sample_ring_head(struct sample_ring *ring) {
+    return atomic_load_explicit(&ring->head, memory_order_acquire);
+}
+
+static inline const struct sample *sample_ring_at(const struct sample_ring *ring, uint64_t index) {
+    return &ring->data[index & ring->mask];
+}
+
+// Call after reading: samples with index < return value may have been overwritten
+static inline uint64_t sample_ring_valid_from(struct sample_ring *ring) {
+    atomic_thread_fence(memory_order_acquire);
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    // At head == n the writer may be writing index n, i.e. the slot of n - capacity
+    return head >= ring->mask ? head - ring->mask : 0;
+}
+
+#endif
@@ -0,0 +1,369 @@
+/* hrtimer-Latenzsonde als Kernel-Modul
+
+Misst, wie viel der Weck-Latenz im Kernel selbst entsteht. Pro ausgewählter CPU läuft ein
+periodischer hrtimer (Hardirq-Modus, auch unter PREEMPT_RT) und ein an die CPU gebundener
+SCHED_FIFO-kthread:
+
+  irq  - Soll-Ablaufzeit → Timer-Handler: Interrupt-Sperren, Hardirq-Latenz
+  wake - Timer-Handler → kthread läuft: Scheduler- und Preemption-Latenz
+
+Die Histogramme liegen in einem vmalloc-Puffer (Layout: struct hrp_shared in hrtimer_probe.h),
+der über read() und mmap() auf dem Zeichengerät binär gelesen wird. Per ioctl lassen sich die
+Histogramme zurücksetzen sowie Periode, CPU-Maske und Bucket-Breite ändern.
+
+Laden: insmod hrtimer_probe.ko [period_us=1000] [cpumask=0x3] [bucket_ns=100]
+*/
+
+#include <linux/module.h>
+#include <linux/kernel.h>
+#include <linux/fs.h>
+#include <linux/uaccess.h>
+#include <linux/vmalloc.h>
+#include <linux/mm.h>
+#include <linux/mutex.h>
+#include <linux/hrtimer.h>
+#include <linux/ktime.h>
+#include <linux/kthread.h>
+#include <linux/sched.h>
+#include <linux/cpumask.h>
+#include <linux/math64.h>
+#include <linux/version.h>
+#include <linux/capability.h>
+
+#include "hrtimer_probe.h"
+
+#define MIN_PERIOD_NS 10000ULL /* kürzere Perioden würden die CPU mit Interrupts fluten */
+
+static unsigned int period_us = 1000;
+module_param(period_us, uint, 0444);
+MODULE_PARM_DESC(period_us, "Timer-Periode in Mikrosekunden (Standard 1000)");
+
+static unsigned long cpumask;
+module_param(cpumask, ulong, 0444);
+MODULE_PARM_DESC(cpumask, "Zu messende CPUs als Bitmaske (0 = alle online)");
+
+static unsigned int bucket_ns = 100;
+module_param(bucket_ns, uint, 0444);
+MODULE_PARM_DESC(bucket_ns, "Breite eines Histogramm-Buckets in Nanosekunden (Standard 100)");
+
+struct probe_cpu {
+    struct hrtimer timer;
+    struct task_struct *thread;
+    struct hrp_cpu_stats *stats;
+    ktime_t wake_start;
+    bool pending;
+    bool active;
+};
+
+static int major;
+static struct hrp_shared *shared;
+static struct probe_cpu probe_cpus[HRP_MAX_CPUS];
+static u64 cur_period_ns;
+static u64 cur_bucket_ns;
+static u64 cur_cpumask;
+static DEFINE_MUTEX(probe_mutex);
+
+// Funktionsprototypen
+static ssize_t device_read(struct file *, char __user *, size_t, loff_t *);
+static int device_mmap(struct file *, struct vm_area_struct *);
+static long device_ioctl(struct file *, unsigned int, unsigned long);
+
+/* File-Operationsstruktur */
+static struct file_operations fops = {
+    .owner = THIS_MODULE,
+    .read = device_read,
+    .mmap = device_mmap,
+    .unlocked_ioctl = device_ioctl,
+    .llseek = default_llseek
+};
+
+/* Latenz in ein Histogramm eintragen (läuft nur auf der jeweiligen CPU, daher ohne Atomics) */
+static void record_latency(struct hrp_hist *hist, s64 ns) {
+    u64 bucket;
+
+    if (ns < 0) {
+        ns = 0;
+    }
+    bucket = div64_u64(ns, cur_bucket_ns);
+    if (bucket < HRP_BUCKETS) {
+        hist->buckets[bucket]++;
+    } else {
+        hist->overflow++;
+    }
+    hist->count++;
+    hist->sum_ns += ns;
+    if (ns > hist->max_ns) {
+        hist->max_ns = ns;
+    }
+}
+
+/* Timer-Handler (Hardirq) */
+static enum hrtimer_restart probe_timer_fn(struct hrtimer *timer) {
+    struct probe_cpu *pc = container_of(timer, struct probe_cpu, timer);
+    ktime_t now = ktime_get();
+    u64 overruns;
+
+    record_latency(&pc->stats->irq, ktime_to_ns(ktime_sub(now, hrtimer_get_expires(timer))));
+
+    /* Handler und kthread laufen auf derselben CPU, WRITE_ONCE genügt */
+    WRITE_ONCE(pc->wake_start, now);
+    WRITE_ONCE(pc->pending, true);
+    wake_up_process(pc->thread);
+
+    overruns = hrtimer_forward(timer, now, ns_to_ktime(cur_period_ns));
+    if (overruns > 1) {
+        pc->stats->overruns += overruns - 1;
+    }
+    return HRTIMER_RESTART;
+}
+
+/* Mess-kthread: armiert den Timer auf seiner CPU und misst die eigene Weck-Latenz */
+static int probe_thread_fn(void *data) {
+    struct probe_cpu *pc = data;
+
+    /* ABS_PINNED: Timer läuft auf der CPU, auf der er gestartet wird, also auf dieser */
+    hrtimer_start(&pc->timer, ktime_add_ns(ktime_get(), cur_period_ns), HRTIMER_MODE_ABS_PINNED_HARD);
+
+    for (;;) {
+        ktime_t now;
+
+        set_current_state(TASK_INTERRUPTIBLE);
+        if (kthread_should_stop()) {
+            break;
+        }
+        if (!READ_ONCE(pc->pending)) {
+            schedule();
+            continue;
+        }
+        __set_current_state(TASK_RUNNING);
+
+        now = ktime_get();
+        WRITE_ONCE(pc->pending, false);
+        record_latency(&pc->stats->wake, ktime_to_ns(ktime_sub(now, READ_ONCE(pc->wake_start))));
+    }
+    __set_current_state(TASK_RUNNING);
+
+    /* Erst nach dem Abbruch des Timers darf der Thread verschwinden (Handler weckt ihn) */
+    hrtimer_cancel(&pc->timer);
+    return 0;
+}
+
+static void probe_stop(void) {
+    int cpu;
+
+    for (cpu = 0; cpu < HRP_MAX_CPUS; cpu++) {
+        struct probe_cpu *pc = &probe_cpus[cpu];
+
+        if (!pc->active) {
+            continue;
+        }
+        kthread_stop(pc->thread);
+        pc->thread = NULL;
+        pc->active = false;
+    }
+}
+
+static int probe_start(void) {
+    u64 started = 0;
+    int cpu;
+
+    for_each_online_cpu(cpu) {
+        struct probe_cpu *pc;
+
+        if (cpu >= HRP_MAX_CPUS || !(cur_cpumask & BIT_ULL(cpu))) {
+            continue;
+        }
+        pc = &probe_cpus[cpu];
+        pc->stats = &shared->cpu[cpu];
+        pc->pending = false;
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 13, 0)
+        hrtimer_setup(&pc->timer, probe_timer_fn, CLOCK_MONOTONIC, HRTIMER_MODE_ABS_PINNED_HARD);
+#else
+        hrtimer_init(&pc->timer, CLOCK_MONOTONIC, HRTIMER_MODE_ABS_PINNED_HARD);
+        pc->timer.function = probe_timer_fn;
+#endif
+
+        pc->thread = kthread_create(probe_thread_fn, pc, "hrtimer_probe/%d", cpu);
+        if (IS_ERR(pc->thread)) {
+            int err = PTR_ERR(pc->thread);
+
+            printk(KERN_ALERT "HRTimer Probe: Failed to create thread for CPU %d\n", cpu);
+            pc->thread = NULL;
+            probe_stop();
+            return err;
+        }
+        kthread_bind(pc->thread, cpu);
+        sched_set_fifo(pc->thread);
+        pc->active = true;
+        started |= BIT_ULL(cpu);
+        wake_up_process(pc->thread);
+    }
+
+    shared->header.period_ns = cur_period_ns;
+    shared->header.bucket_ns = cur_bucket_ns;
+    shared->header.cpumask = started;
+    return started ? 0 : -EINVAL;
+}
+
+/* Messung anhalten, Histogramme leeren, mit aktueller Konfiguration neu starten */
+static int probe_restart(void) {
+    probe_stop();
+    memset(shared->cpu, 0, sizeof(shared->cpu));
+    shared->header.generation++;
+    return probe_start();
+}
+
+/* Initialisierungsfunktion */
+static int __init hrtimer_probe_init(void) {
+    int ret;
+
+    printk(KERN_INFO "HRTimer Probe: Initializing...\n");
+
+    cur_period_ns = max_t(u64, (u64)period_us * NSEC_PER_USEC, MIN_PERIOD_NS);
+    cur_bucket_ns = bucket_ns ? bucket_ns : 100;
+    cur_cpumask = cpumask ? cpumask : ~0ULL;
+
+    /* vmalloc_user: genullt und für remap_vmalloc_range geeignet */
+    shared = vmalloc_user(sizeof(*shared));
+    if (!shared) {
+        printk(KERN_ALERT "HRTimer Probe: Failed to allocate memory\n");
+        return -ENOMEM;
+    }
+    shared->header.magic = HRP_MAGIC;
+    shared->header.version = HRP_VERSION;
+    shared->header.max_cpus = HRP_MAX_CPUS;
+    shared->header.buckets = HRP_BUCKETS;
+
+    major = register_chrdev(0, HRP_DEVICE_NAME, &fops);
+    if (major < 0) {
+        printk(KERN_ALERT "HRTimer Probe: Failed to register device with %d\n", major);
+        vfree(shared);
+        return major;
+    }
+
+    mutex_lock(&probe_mutex);
+    ret = probe_start();
+    mutex_unlock(&probe_mutex);
+    if (ret) {
+        printk(KERN_ALERT "HRTimer Probe: No CPU could be started (%d)\n", ret);
+        unregister_chrdev(major, HRP_DEVICE_NAME);
+        vfree(shared);
+        return ret;
+    }
+
+    printk(KERN_INFO "HRTimer Probe: Registered with major number %d\n", major);
+    printk(KERN_INFO "HRTimer Probe: period %llu ns, cpumask 0x%llx, bucket %llu ns\n", cur_period_ns,
+           shared->header.cpumask, cur_bucket_ns);
+    printk(KERN_INFO "To create device file, run: mknod /dev/%s c %d 0\n", HRP_DEVICE_NAME, major);
+
+    return 0;
+}
+
+/* Aufräumfunktion */
+static void __exit hrtimer_probe_exit(void) {
+    mutex_lock(&probe_mutex);
+    probe_stop();
+    mutex_unlock(&probe_mutex);
+
+    unregister_chrdev(major, HRP_DEVICE_NAME);
+    vfree(shared);
+
+    printk(KERN_INFO "HRTimer Probe: Unregistered and cleaned up\n");
+}
+
+/* Histogramme binär lesen (Momentaufnahme der laufenden Zähler) */
+static ssize_t device_read(struct file *filp, char __user *buffer, size_t length, loff_t *offset) {
+    size_t size = sizeof(*shared);
+
+    if (*offset >= size) {
+        return 0; /* EOF */
+    }
+    length = min(length, (size_t)(size - *offset));
+
+    if (copy_to_user(buffer, (char *)shared + *offset, length)) {
+        return -EFAULT;
+    }
+    *offset += length;
+
+    return length;
+}
+
+/* Puffer nur lesend einblenden; die Zähler laufen live weiter */
+static int device_mmap(struct file *filp, struct vm_area_struct *vma) {
+    if (vma->vm_flags & VM_WRITE) {
+        return -EPERM;
+    }
+    /* Mit gesetztem VM_MAYWRITE könnte mprotect(PROT_WRITE) die Abbildung nachträglich beschreibbar machen */
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 3, 0)
+    vm_flags_clear(vma, VM_MAYWRITE);
+#else
+    vma->vm_flags &= ~VM_MAYWRITE;
+#endif
+    return remap_vmalloc_range(vma, shared, vma->vm_pgoff);
+}
+
+static long device_ioctl(struct file *filp, unsigned int cmd, unsigned long arg) {
+    struct hrp_config config;
+    long ret = 0;
+
+    /* Lesen darf jeder mit Zugriff aufs Gerät, Umkonfigurieren nur root */
+    if (cmd != HRP_IOC_GET_CONFIG && !capable(CAP_SYS_ADMIN)) {
+        return -EPERM;
+    }
+
+    switch (cmd) {
+    case HRP_IOC_RESET:
+        mutex_lock(&probe_mutex);
+        ret = probe_restart();
+        mutex_unlock(&probe_mutex);
+        break;
+
+    case HRP_IOC_SET_CONFIG:
+        if (copy_from_user(&config, (void __user *)arg, sizeof(config))) {
+            return -EFAULT;
+        }
+        if (config.period_ns && config.period_ns < MIN_PERIOD_NS) {
+            return -EINVAL;
+        }
+        mutex_lock(&probe_mutex);
+        if (config.period_ns) {
+            cur_period_ns = config.period_ns;
+        }
+        if (config.cpumask) {
+            cur_cpumask = config.cpumask;
+        }
+        if (config.bucket_ns) {
+            cur_bucket_ns = config.bucket_ns;
+        }
+        ret = probe_restart();
+        mutex_unlock(&probe_mutex);
+        printk(KERN_INFO "HRTimer Probe: Reconfigured: period %llu ns, cpumask 0x%llx, bucket %llu ns\n",
+               cur_period_ns, shared->header.cpumask, cur_bucket_ns);
+        break;
+
+    case HRP_IOC_GET_CONFIG:
+        mutex_lock(&probe_mutex);
+        config.period_ns = cur_period_ns;
+        config.cpumask = shared->header.cpumask;
+        config.bucket_ns = cur_bucket_ns;
+        mutex_unlock(&probe_mutex);
+        if (copy_to_user((void __user *)arg, &config, sizeof(config))) {
+            return -EFAULT;
+        }
+        break;
+
+    default:
+        return -ENOTTY;
+    }
+
+    return ret;
+}
+
+/* Modul-Makros */
+module_init(hrtimer_probe_init);
+module_exit(hrtimer_probe_exit);
+
+MODULE_LICENSE("GPL");
+MODULE_DESCRIPTION("hrtimer latency probe with per-CPU histograms via char device");
+MODULE_AUTHOR("Linux Driver Developer");
+MODULE_VERSION("1.0");
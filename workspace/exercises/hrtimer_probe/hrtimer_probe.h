@@ -0,0 +1,77 @@
+/*
+Gemeinsame Definitionen für hrtimer_probe (Kernel-Modul und User-Space-Werkzeuge)
+
+Das Modul misst pro CPU zwei Latenzen und legt sie als Histogramme in einem Puffer ab, der über
+read() und mmap() auf /dev/hrtimer_probe binär gelesen werden kann:
+
+  irq  - Soll-Ablaufzeit des hrtimers → Eintritt in den Timer-Handler (Hardirq)
+  wake - Timer-Handler → der geweckte, an die CPU gebundene SCHED_FIFO-kthread läuft
+
+Damit lässt sich der Anteil des Kernels (Interrupt-Sperren, Scheduler) an der Latenz getrennt von
+Systemaufruf- und Timer-Slack-Effekten im User-Space bestimmen.
+*/
+
+#ifndef HRTIMER_PROBE_H
+#define HRTIMER_PROBE_H
+
+#ifdef __KERNEL__
+#include <linux/ioctl.h>
+#include <linux/types.h>
+#else
+#include <linux/types.h>
+#include <sys/ioctl.h>
+#endif
+
+#define HRP_DEVICE_NAME "hrtimer_probe"
+#define HRP_MAGIC 0x48525450 /* "HRTP" */
+#define HRP_VERSION 1
+
+#define HRP_MAX_CPUS 64
+#define HRP_BUCKETS 1024
+
+/* Ein Histogramm: buckets[i] zählt Latenzen in [i * bucket_ns, (i + 1) * bucket_ns) */
+struct hrp_hist {
+    __u64 buckets[HRP_BUCKETS];
+    __u64 overflow;
+    __u64 count;
+    __u64 sum_ns;
+    __u64 max_ns;
+};
+
+struct hrp_cpu_stats {
+    struct hrp_hist irq;
+    struct hrp_hist wake;
+    __u64 overruns; /* verpasste Perioden (hrtimer_forward > 1) */
+    __u64 pad[7];   /* nächste CPU beginnt in einer neuen Cache-Line */
+};
+
+struct hrp_header {
+    __u32 magic;
+    __u32 version;
+    __u32 max_cpus;
+    __u32 buckets;
+    __u64 period_ns;
+    __u64 bucket_ns;
+    __u64 cpumask;    /* gemessene CPUs (Bit n = CPU n) */
+    __u64 generation; /* wird bei jedem Reset/Umkonfigurieren erhöht */
+    __u64 pad[2];
+};
+
+/* Layout des Puffers hinter read()/mmap() */
+struct hrp_shared {
+    struct hrp_header header;
+    struct hrp_cpu_stats cpu[HRP_MAX_CPUS];
+};
+
+struct hrp_config {
+    __u64 period_ns; /* 0 = unverändert */
+    __u64 cpumask;   /* 0 = unverändert */
+    __u64 bucket_ns; /* 0 = unverändert */
+};
+
+#define HRP_IOC_MAGIC 'h'
+#define HRP_IOC_RESET _IO(HRP_IOC_MAGIC, 0)
+#define HRP_IOC_SET_CONFIG _IOW(HRP_IOC_MAGIC, 1, struct hrp_config)
+#define HRP_IOC_GET_CONFIG _IOR(HRP_IOC_MAGIC, 2, struct hrp_config)
+
+#endif
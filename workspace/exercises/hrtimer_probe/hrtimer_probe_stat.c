@@ -0,0 +1,164 @@
+/*
+Auswertung der hrtimer-Latenzsonde
+
+Blendet die Histogramme des Moduls per mmap ein und gibt pro CPU Mittelwert, p99, p99.9 und
+Maximum für beide Latenzen aus. Über ioctl lassen sich Histogramme zurücksetzen und Periode,
+CPU-Maske und Bucket-Breite ändern; -s schreibt eine binäre Momentaufnahme (per read()).
+
+Aufruf: hrtimer_probe_stat [-d gerät] [-r] [-p periode_us] [-c cpumaske] [-b bucket_ns]
+                           [-w sekunden] [-s datei]
+*/
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "hrtimer_probe.h"
+
+static double percentile(const struct hrp_hist *hist, __u64 bucket_ns, double fraction) {
+    __u64 total = hist->count;
+    __u64 target = (__u64)((double)total * fraction);
+    __u64 cum = 0;
+
+    for (int i = 0; i < HRP_BUCKETS; ++i) {
+        cum += hist->buckets[i];
+        if (cum > 0 && cum >= target) {
+            return (double)((i + 1) * bucket_ns) / 1000.0; // Obergrenze des Buckets
+        }
+    }
+    return (double)hist->max_ns / 1000.0; // im Überlauf
+}
+
+static void print_hist(const char *name, const struct hrp_hist *hist, __u64 bucket_ns) {
+    double avg = hist->count ? (double)hist->sum_ns / (double)hist->count / 1000.0 : 0.0;
+    printf("  %-5s %10llu  avg %7.2f  p99 %7.2f  p99.9 %7.2f  max %8.2f us  overflow %llu\n", name,
+           (unsigned long long)hist->count, avg, percentile(hist, bucket_ns, 0.99),
+           percentile(hist, bucket_ns, 0.999), (double)hist->max_ns / 1000.0, (unsigned long long)hist->overflow);
+}
+
+static void print_stats(const struct hrp_shared *shared) {
+    const struct hrp_header *h = &shared->header;
+
+    printf("Periode %llu us, Bucket %llu ns, CPU-Maske 0x%llx, Generation %llu\n",
+           (unsigned long long)(h->period_ns / 1000), (unsigned long long)h->bucket_ns,
+           (unsigned long long)h->cpumask, (unsigned long long)h->generation);
+    for (unsigned int cpu = 0; cpu < h->max_cpus && cpu < HRP_MAX_CPUS; ++cpu) {
+        if (!(h->cpumask & (1ULL << cpu))) {
+            continue;
+        }
+        const struct hrp_cpu_stats *s = &shared->cpu[cpu];
+        printf("CPU %u (verpasste Perioden: %llu)\n", cpu, (unsigned long long)s->overruns);
+        print_hist("irq", &s->irq, h->bucket_ns);
+        print_hist("wake", &s->wake, h->bucket_ns);
+    }
+}
+
+static int save_snapshot(int fd, const char *path) {
+    FILE *out = fopen(path, "wb");
+    if (out == NULL) {
+        perror("Snapshot-Datei öffnen");
+        return -1;
+    }
+    char buffer[65536];
+    ssize_t n;
+    size_t total = 0;
+    lseek(fd, 0, SEEK_SET);
+    while ((n = read(fd, buffer, sizeof(buffer))) > 0) {
+        fwrite(buffer, 1, (size_t)n, out);
+        total += (size_t)n;
+    }
+    fclose(out);
+    printf("Snapshot: %zu Bytes nach %s\n", total, path);
+    return n < 0 ? -1 : 0;
+}
+
+int main(int argc, char *argv[]) {
+    const char *device = "/dev/" HRP_DEVICE_NAME;
+    const char *snapshot = NULL;
+    struct hrp_config config = {0};
+    int reset = 0;
+    int watch = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "d:rp:c:b:w:s:")) != -1) {
+        switch (opt) {
+        case 'd':
+            device = optarg;
+            break;
+        case 'r':
+            reset = 1;
+            break;
+        case 'p':
+            config.period_ns = strtoull(optarg, NULL, 10) * 1000;
+            break;
+        case 'c':
+            config.cpumask = strtoull(optarg, NULL, 0);
+            break;
+        case 'b':
+            config.bucket_ns = strtoull(optarg, NULL, 10);
+            break;
+        case 'w':
+            watch = atoi(optarg);
+            break;
+        case 's':
+            snapshot = optarg;
+            break;
+        default:
+            fprintf(stderr,
+                    "Verwendung: %s [-d gerät] [-r] [-p periode_us] [-c cpumaske] [-b bucket_ns] [-w sekunden] "
+                    "[-s datei]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+
+    int fd = open(device, O_RDONLY);
+    if (fd < 0) {
+        perror("Gerät öffnen");
+        return 1;
+    }
+
+    if (config.period_ns || config.cpumask || config.bucket_ns) {
+        if (ioctl(fd, HRP_IOC_SET_CONFIG, &config) != 0) {
+            perror("HRP_IOC_SET_CONFIG");
+            return 1;
+        }
+    } else if (reset && ioctl(fd, HRP_IOC_RESET) != 0) {
+        perror("HRP_IOC_RESET");
+        return 1;
+    }
+
+    size_t size = sizeof(struct hrp_shared);
+    const struct hrp_shared *shared = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (shared == MAP_FAILED) {
+        perror("mmap");
+        return 1;
+    }
+    if (shared->header.magic != HRP_MAGIC || shared->header.version != HRP_VERSION) {
+        fprintf(stderr, "Unbekanntes Pufferformat (magic 0x%x, version %u)\n", shared->header.magic,
+                shared->header.version);
+        return 1;
+    }
+
+    if (snapshot != NULL) {
+        if (watch > 0) {
+            sleep((unsigned int)watch);
+        }
+        save_snapshot(fd, snapshot);
+    } else if (watch > 0) {
+        for (;;) {
+            sleep((unsigned int)watch);
+            printf("\n");
+            print_stats(shared);
+            fflush(stdout);
+        }
+    } else {
+        print_stats(shared);
+    }
+
+    munmap((void *)shared, size);
+    close(fd);
+    return 0;
+}
@@ -0,0 +1,104 @@
+#!/bin/bash
+
+# Farben für die Ausgabe
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+YELLOW='\033[1;33m'
+NC='\033[0m' # No Color
+
+echo -e "${YELLOW}=== hrtimer Latency Probe Test ===${NC}"
+
+# Überprüfen, ob das Skript als Root ausgeführt wird
+if [ "$EUID" -ne 0 ]; then
+    echo -e "${RED}Bitte als Root ausführen (sudo ./test_probe.sh)${NC}"
+    exit 1
+fi
+
+cleanup() {
+    rm -f /dev/hrtimer_probe
+    rmmod hrtimer_probe 2>/dev/null
+}
+
+# Schritt 1: Modul und Auswertewerkzeug kompilieren
+echo -e "${YELLOW}Schritt 1: Kompilieren${NC}"
+make clean
+make
+if [ $? -ne 0 ]; then
+    echo -e "${RED}Kompilierung fehlgeschlagen!${NC}"
+    exit 1
+fi
+echo -e "${GREEN}Kompilierung erfolgreich!${NC}"
+
+# Schritt 2: Modul laden (Periode 500 µs, alle CPUs)
+echo -e "${YELLOW}Schritt 2: Modul laden${NC}"
+insmod hrtimer_probe.ko period_us=500
+if [ $? -ne 0 ]; then
+    echo -e "${RED}Modul konnte nicht geladen werden!${NC}"
+    exit 1
+fi
+echo -e "${GREEN}Modul erfolgreich geladen!${NC}"
+
+# Major-Nummer aus dmesg extrahieren
+MAJOR=$(dmesg | grep "HRTimer Probe: Registered with major number" | tail -1 | grep -o '[0-9]\+$')
+if [ -z "$MAJOR" ]; then
+    echo -e "${RED}Konnte Major-Nummer nicht ermitteln!${NC}"
+    cleanup
+    exit 1
+fi
+echo -e "${GREEN}Major-Nummer: $MAJOR${NC}"
+
+# Schritt 3: Device-Datei erstellen
+echo -e "${YELLOW}Schritt 3: Device-Datei erstellen${NC}"
+mknod /dev/hrtimer_probe c $MAJOR 0
+chmod 644 /dev/hrtimer_probe
+echo -e "${GREEN}Device-Datei erstellt!${NC}"
+
+# Schritt 4: Messen lassen und per mmap auswerten
+echo -e "${YELLOW}Schritt 4: 3 Sekunden messen (mmap)${NC}"
+sleep 3
+./hrtimer_probe_stat
+if [ $? -ne 0 ]; then
+    echo -e "${RED}Auswertung fehlgeschlagen!${NC}"
+    cleanup
+    exit 1
+fi
+
+# Schritt 5: Binärer Snapshot per read()
+echo -e "${YELLOW}Schritt 5: Snapshot per read()${NC}"
+SIZE=$(cat /dev/hrtimer_probe | wc -c)
+if [ "$SIZE" -gt 0 ]; then
+    echo -e "${GREEN}read() liefert $SIZE Bytes${NC}"
+else
+    echo -e "${RED}read() liefert keine Daten!${NC}"
+fi
+
+# Schritt 6: Umkonfigurieren per ioctl (CPU 0, 200 µs, 50-ns-Buckets)
+echo -e "${YELLOW}Schritt 6: Umkonfigurieren per ioctl${NC}"
+./hrtimer_probe_stat -c 0x1 -p 200 -b 50 > /dev/null
+sleep 2
+./hrtimer_probe_stat
+if ./hrtimer_probe_stat | grep -q "CPU-Maske 0x1,"; then
+    echo -e "${GREEN}Neue Konfiguration aktiv!${NC}"
+else
+    echo -e "${RED}Konfiguration wurde nicht übernommen!${NC}"
+fi
+
+# Schritt 7: Reset
+echo -e "${YELLOW}Schritt 7: Reset${NC}"
+./hrtimer_probe_stat -r | head -1
+
+# Schritt 8: Kernel-Logs anzeigen
+echo -e "${YELLOW}Schritt 8: Kernel-Logs (letzte 10 Zeilen)${NC}"
+dmesg | grep "HRTimer Probe" | tail -10
+
+# Schritt 9: Aufräumen
+echo -e "${YELLOW}Schritt 9: Aufräumen${NC}"
+rm -f /dev/hrtimer_probe
+rmmod hrtimer_probe
+if [ $? -eq 0 ]; then
+    echo -e "${GREEN}Modul erfolgreich entladen!${NC}"
+else
+    echo -e "${RED}Fehler beim Entladen des Moduls!${NC}"
+fi
+
+echo -e "${YELLOW}=== Test abgeschlossen ===${NC}"
@@ -0,0 +1,527 @@
+#define _GNU_SOURCE // O_DIRECTORY, pthread_cond_timedwait mit CLOCK_MONOTONIC
+
+#include "checkpoint.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define LOG_MAGIC 0x474c4b43U  // "CKLG"
+#define SNAP_MAGIC 0x4e534b43U // "CKSN"
+#define CKPT_VERSION 1
+#define LOG_HEADER_SIZE 64
+#define PAGE_BYTES 4096
+
+struct log_header {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t generation;
+    uint32_t record_size;
+    uint32_t capacity;             // Datensätze hinter dem Kopf
+    uint32_t crc;                  // über die Felder davor
+    char pad[LOG_HEADER_SIZE - 28];
+};
+
+struct log_record {
+    uint32_t seq;                  // 1, 2, ... innerhalb einer Generation
+    int32_t value;
+    uint16_t channel;
+    uint16_t reserved;
+    uint32_t crc;                  // über Generation, seq, value, channel
+};
+
+struct snapshot {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t generation;
+    uint64_t valid;                // Bitmaske der belegten Kanäle
+    int32_t values[CKPT_MAX_CHANNELS];
+    uint32_t crc;                  // über die Felder davor
+};
+
+_Static_assert(sizeof(struct log_header) == LOG_HEADER_SIZE, "Log-Kopf muss 64 Bytes groß sein");
+_Static_assert(sizeof(struct log_record) == 16, "Delta-Datensatz muss 16 Bytes groß sein");
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// CRC-32 (IEEE) mit Tabelle: beim Wiederherstellen werden tausende Datensätze geprüft
+static uint32_t crc_table[256];
+static pthread_once_t crc_once = PTHREAD_ONCE_INIT;
+
+static void crc_init(void) {
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; ++k) {
+            c = (c >> 1) ^ (0xedb88320U & (0U - (c & 1U)));
+        }
+        crc_table[i] = c;
+    }
+}
+
+static uint32_t crc32_update(uint32_t crc, const void *data, size_t len) {
+    const uint8_t *p = data;
+    crc = ~crc;
+    while (len--) {
+        crc = crc_table[(crc ^ *p++) & 0xff] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+static uint32_t record_crc(uint64_t generation, const struct log_record *r) {
+    uint32_t crc = crc32_update(0, &generation, sizeof(generation));
+    return crc32_update(crc, r, offsetof(struct log_record, crc));
+}
+
+static uint64_t pages_spanned(uint64_t offset, uint64_t len) {
+    return len == 0 ? 0 : (offset + len - 1) / PAGE_BYTES - offset / PAGE_BYTES + 1;
+}
+
+static int write_all(int fd, const void *buf, size_t len, off_t offset) {
+    const char *p = buf;
+    while (len > 0) {
+        ssize_t n = pwrite(fd, p, len, offset);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        p += n;
+        len -= (size_t)n;
+        offset += n;
+    }
+    return 0;
+}
+
+static int write_log_header(struct checkpoint *ck) {
+    struct log_header h;
+    memset(&h, 0, sizeof(h));
+    h.magic = LOG_MAGIC;
+    h.version = CKPT_VERSION;
+    h.generation = ck->generation;
+    h.record_size = sizeof(struct log_record);
+    h.capacity = ck->log_capacity;
+    h.crc = crc32_update(0, &h, offsetof(struct log_header, crc));
+    if (write_all(ck->log_fd, &h, sizeof(h), 0) != 0 || fdatasync(ck->log_fd) != 0) {
+        return -1;
+    }
+    ck->stats.syncs++;
+    ck->stats.pages_written++;
+    return 0;
+}
+
+// Log-Datei anlegen und einmalig mit Nullen füllen: spätere Schreibzugriffe ändern dann weder
+// Dateigröße noch Extents, fdatasync muss keine Metadaten mehr schreiben
+static int create_log(struct checkpoint *ck, const char *path) {
+    static const char zeros[PAGE_BYTES];
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return -1;
+    }
+    for (off_t off = 0; off < (off_t)ck->options.log_bytes; off += PAGE_BYTES) {
+        if (write_all(fd, zeros, PAGE_BYTES, off) != 0) {
+            close(fd);
+            return -1;
+        }
+    }
+    if (fsync(fd) != 0 || fsync(ck->dir_fd) != 0) {
+        close(fd);
+        return -1;
+    }
+    ck->log_fd = fd;
+    ck->stats.pages_written += ck->options.log_bytes / PAGE_BYTES;
+    return write_log_header(ck);
+}
+
+// Vollständigen Zustand als Snapshot der nächsten Generation sichern
+static int write_snapshot(struct checkpoint *ck) {
+    struct snapshot snap;
+    memset(&snap, 0, sizeof(snap));
+    snap.magic = SNAP_MAGIC;
+    snap.version = CKPT_VERSION;
+    snap.generation = ck->generation + 1;
+    snap.valid = ck->durable_valid;
+    memcpy(snap.values, ck->durable, sizeof(snap.values));
+    snap.crc = crc32_update(0, &snap, offsetof(struct snapshot, crc));
+
+    int fd = open(ck->tmp_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return -1;
+    }
+    if (write_all(fd, &snap, sizeof(snap), 0) != 0 || fdatasync(fd) != 0) {
+        close(fd);
+        return -1;
+    }
+    close(fd);
+    // Erst nach dem Umbenennen gilt die neue Generation; ein Absturz davor lässt den alten
+    // Snapshot samt Log gültig
+    if (rename(ck->tmp_path, ck->snap_path) != 0 || fsync(ck->dir_fd) != 0) {
+        return -1;
+    }
+    ck->generation = snap.generation;
+    ck->stats.snapshots++;
+    ck->stats.snapshot_bytes += sizeof(snap);
+    ck->stats.syncs += 2;
+    ck->stats.pages_written += pages_spanned(0, sizeof(snap));
+    return 0;
+}
+
+// Snapshot schreiben und das Log mit der neuen Generation von vorn beginnen
+static int compact(struct checkpoint *ck) {
+    if (write_snapshot(ck) != 0) {
+        return -1;
+    }
+    ck->next_seq = 1;
+    // Ein Absturz vor dem neuen Log-Kopf ist unkritisch: Datensätze der alten Generation
+    // passen nicht mehr zum Snapshot und werden verworfen
+    if (write_log_header(ck) != 0) {
+        // Unter dem alten Kopf angehängte Datensätze würden ebenso verworfen: das Log gilt als
+        // voll, der nächste Stapel verdichtet erneut
+        ck->log_records = ck->log_capacity;
+        return -1;
+    }
+    ck->log_records = 0;
+    return 0;
+}
+
+static void apply_records(struct checkpoint *ck, const struct log_record *records, uint32_t n) {
+    for (uint32_t i = 0; i < n; ++i) {
+        ck->durable[records[i].channel] = records[i].value;
+        ck->durable_valid |= 1ULL << records[i].channel;
+    }
+}
+
+// Gesammelte Änderungen als ein Stapel schreiben. Sequenznummern, durable und pending ändern
+// sich erst nach erfolgreichem Schreiben, ein Fehler lässt Log und Zustand unverändert
+static void flush(struct checkpoint *ck) {
+    uint32_t tail = atomic_load_explicit(&ck->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&ck->head, memory_order_acquire);
+
+    // Mehrfach geänderte Kanäle zusammenfassen: nur der letzte Wert zählt
+    for (; tail != head; ++tail) {
+        const struct ckpt_change *c = &ck->ring[tail & (CKPT_RING_SIZE - 1)];
+        ck->pending[c->channel] = c->value;
+        ck->pending_mask |= 1ULL << c->channel;
+    }
+    atomic_store_explicit(&ck->tail, tail, memory_order_release);
+
+    struct log_record records[CKPT_MAX_CHANNELS];
+    uint32_t n = 0;
+    for (unsigned int ch = 0; ch < CKPT_MAX_CHANNELS; ++ch) {
+        if (!(ck->pending_mask & (1ULL << ch))) {
+            continue;
+        }
+        // Hin und zurück innerhalb eines Stapels: nichts zu schreiben
+        if ((ck->durable_valid & (1ULL << ch)) && ck->durable[ch] == ck->pending[ch]) {
+            ck->pending_mask &= ~(1ULL << ch);
+            continue;
+        }
+        records[n].channel = (uint16_t)ch;
+        records[n].value = ck->pending[ch];
+        n++;
+    }
+    if (n == 0) {
+        return;
+    }
+
+    pthread_mutex_lock(&ck->lock);
+    uint64_t limit = (uint64_t)ck->log_capacity * ck->options.compact_pct / 100;
+    if (ck->log_records + n > limit) {
+        // Der Snapshot nimmt die neuen Werte auf, Datensätze sind dann nicht mehr nötig
+        int32_t old_durable[CKPT_MAX_CHANNELS];
+        uint64_t old_valid = ck->durable_valid;
+        uint64_t old_generation = ck->generation;
+        memcpy(old_durable, ck->durable, sizeof(old_durable));
+        apply_records(ck, records, n);
+        if (compact(ck) != 0) {
+            perror("Checkpoint: Verdichten fehlgeschlagen");
+        }
+        if (ck->generation != old_generation) {
+            ck->pending_mask = 0; // Snapshot geschrieben, auch wenn der Log-Kopf fehlschlug
+        } else {
+            memcpy(ck->durable, old_durable, sizeof(old_durable));
+            ck->durable_valid = old_valid;
+        }
+        pthread_mutex_unlock(&ck->lock);
+        return;
+    }
+    for (uint32_t i = 0; i < n; ++i) {
+        records[i].seq = ck->next_seq + i;
+        records[i].reserved = 0;
+        records[i].crc = record_crc(ck->generation, &records[i]);
+    }
+    off_t offset = LOG_HEADER_SIZE + (off_t)ck->log_records * (off_t)sizeof(struct log_record);
+    size_t len = n * sizeof(struct log_record);
+    if (write_all(ck->log_fd, records, len, offset) != 0 || fdatasync(ck->log_fd) != 0) {
+        perror("Checkpoint: Schreiben fehlgeschlagen");
+    } else {
+        apply_records(ck, records, n);
+        ck->pending_mask = 0;
+        ck->next_seq += n;
+        ck->log_records += n;
+        ck->stats.records += n;
+        ck->stats.record_bytes += len;
+        ck->stats.syncs++;
+        ck->stats.pages_written += pages_spanned((uint64_t)offset, len);
+    }
+    pthread_mutex_unlock(&ck->lock);
+}
+
+static void *writer_main(void *arg) {
+    struct checkpoint *ck = arg;
+
+    pthread_mutex_lock(&ck->lock);
+    while (atomic_load(&ck->running)) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_sec += ck->options.flush_ms / 1000;
+        deadline.tv_nsec += (long)(ck->options.flush_ms % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        pthread_cond_timedwait(&ck->wake, &ck->lock, &deadline);
+        pthread_mutex_unlock(&ck->lock);
+        flush(ck);
+        pthread_mutex_lock(&ck->lock);
+    }
+    pthread_mutex_unlock(&ck->lock);
+    flush(ck); // letzte Änderungen vor dem Beenden
+    return NULL;
+}
+
+// Datei nur lesend einblenden; NULL wenn sie fehlt oder leer ist
+static const void *map_file(const char *path, size_t *size) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return NULL;
+    }
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return NULL;
+    }
+    *size = (size_t)st.st_size;
+    return map;
+}
+
+// Snapshot übernehmen und passende Delta-Datensätze anwenden. Liefert 1, wenn das vorhandene
+// Log weiterverwendet werden kann (gleiche Generation und Größe)
+static int restore(struct checkpoint *ck, const char *log_path) {
+    size_t snap_size = 0;
+    const struct snapshot *snap = map_file(ck->snap_path, &snap_size);
+    ck->generation = 0;
+    if (snap != NULL) {
+        if (snap_size >= sizeof(*snap) && snap->magic == SNAP_MAGIC && snap->version == CKPT_VERSION &&
+            snap->crc == crc32_update(0, snap, offsetof(struct snapshot, crc))) {
+            ck->generation = snap->generation;
+            ck->durable_valid = snap->valid;
+            memcpy(ck->durable, snap->values, sizeof(ck->durable));
+        } else {
+            fprintf(stderr, "Checkpoint: Snapshot %s ungültig, ignoriert\n", ck->snap_path);
+        }
+        munmap((void *)snap, snap_size);
+    }
+
+    size_t log_size = 0;
+    const char *log = map_file(log_path, &log_size);
+    if (log == NULL) {
+        return 0;
+    }
+    int reusable = 0;
+    const struct log_header *h = (const struct log_header *)log;
+    if (log_size >= sizeof(*h) && h->magic == LOG_MAGIC && h->version == CKPT_VERSION &&
+        h->record_size == sizeof(struct log_record) &&
+        h->crc == crc32_update(0, h, offsetof(struct log_header, crc)) && h->generation == ck->generation) {
+        uint32_t capacity = h->capacity;
+        if ((size_t)capacity > (log_size - LOG_HEADER_SIZE) / sizeof(struct log_record)) {
+            capacity = (uint32_t)((log_size - LOG_HEADER_SIZE) / sizeof(struct log_record));
+        }
+        const struct log_record *records = (const struct log_record *)(log + LOG_HEADER_SIZE);
+        uint32_t i = 0;
+        // Ende des Logs: Nullen, Datensatz einer alten Generation oder halb geschrieben
+        for (; i < capacity; ++i) {
+            const struct log_record *r = &records[i];
+            if (r->seq != i + 1 || r->channel >= CKPT_MAX_CHANNELS || r->crc != record_crc(ck->generation, r)) {
+                break;
+            }
+            ck->durable[r->channel] = r->value;
+            ck->durable_valid |= 1ULL << r->channel;
+        }
+        ck->log_records = i;
+        ck->next_seq = i + 1;
+        ck->stats.restored_records = i;
+        reusable = log_size == ck->options.log_bytes;
+    }
+    munmap((void *)log, log_size);
+    return reusable;
+}
+
+int ckpt_open(struct checkpoint *ck, const char *dir, const struct ckpt_options *options) {
+    uint64_t t0 = now_ns();
+    char log_path[512];
+
+    pthread_once(&crc_once, crc_init);
+    memset(ck, 0, sizeof(*ck));
+    ck->options.log_bytes = 64 * 1024;
+    ck->options.flush_ms = 1000;
+    ck->options.compact_pct = 75;
+    if (options != NULL) {
+        if (options->log_bytes) {
+            ck->options.log_bytes = options->log_bytes;
+        }
+        if (options->flush_ms) {
+            ck->options.flush_ms = options->flush_ms;
+        }
+        if (options->compact_pct) {
+            ck->options.compact_pct = options->compact_pct;
+        }
+    }
+    // Ganze Seiten, mindestens eine Seite für Datensätze
+    ck->options.log_bytes = (ck->options.log_bytes + PAGE_BYTES - 1) / PAGE_BYTES * PAGE_BYTES;
+    if (ck->options.log_bytes < 2 * PAGE_BYTES) {
+        ck->options.log_bytes = 2 * PAGE_BYTES;
+    }
+    if (ck->options.compact_pct > 100) {
+        ck->options.compact_pct = 100;
+    }
+    ck->log_capacity = (ck->options.log_bytes - LOG_HEADER_SIZE) / sizeof(struct log_record);
+    ck->next_seq = 1;
+    ck->log_fd = -1;
+    snprintf(ck->snap_path, sizeof(ck->snap_path), "%s/controller.snap", dir);
+    snprintf(ck->tmp_path, sizeof(ck->tmp_path), "%s/controller.snap.tmp", dir);
+    snprintf(log_path, sizeof(log_path), "%s/controller.log", dir);
+
+    ck->dir_fd = open(dir, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (ck->dir_fd < 0) {
+        return -1;
+    }
+
+    int reusable = restore(ck, log_path);
+    ck->stats.restore_ns = now_ns() - t0;
+    memcpy(ck->shadow, ck->durable, sizeof(ck->shadow));
+    ck->shadow_valid = ck->durable_valid;
+
+    pthread_mutex_init(&ck->lock, NULL);
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&ck->wake, &attr);
+    pthread_condattr_destroy(&attr);
+
+    if (reusable) {
+        ck->log_fd = open(log_path, O_RDWR | O_CLOEXEC);
+    }
+    if (ck->log_fd < 0) {
+        // Neues oder unpassendes Log: wiederhergestellten Zustand zuerst als Snapshot sichern,
+        // erst dann das alte Log überschreiben
+        ck->log_records = 0;
+        ck->next_seq = 1;
+        if ((ck->durable_valid && write_snapshot(ck) != 0) || create_log(ck, log_path) != 0) {
+            int err = errno;
+            if (ck->log_fd >= 0) {
+                close(ck->log_fd);
+            }
+            close(ck->dir_fd);
+            errno = err;
+            return -1;
+        }
+    }
+
+    ck->start_ns = now_ns();
+    atomic_store(&ck->running, 1);
+    if (pthread_create(&ck->thread, NULL, writer_main, ck) != 0) {
+        close(ck->log_fd);
+        close(ck->dir_fd);
+        errno = EAGAIN;
+        return -1;
+    }
+    ck->thread_started = 1;
+    return 0;
+}
+
+int ckpt_get(const struct checkpoint *ck, unsigned int channel, int32_t *value) {
+    if (channel >= CKPT_MAX_CHANNELS || !(ck->shadow_valid & (1ULL << channel))) {
+        return 0;
+    }
+    *value = ck->shadow[channel];
+    return 1;
+}
+
+void ckpt_set_deadband(struct checkpoint *ck, unsigned int channel, int32_t deadband) {
+    if (channel < CKPT_MAX_CHANNELS) {
+        ck->deadband[channel] = deadband < 0 ? 0 : deadband;
+    }
+}
+
+void ckpt_set(struct checkpoint *ck, unsigned int channel, int32_t value) {
+    if (channel >= CKPT_MAX_CHANNELS) {
+        return;
+    }
+    uint64_t bit = 1ULL << channel;
+    if (ck->shadow_valid & bit) {
+        int64_t diff = (int64_t)value - ck->shadow[channel];
+        if (diff == 0 || (diff < 0 ? -diff : diff) <= ck->deadband[channel]) {
+            return;
+        }
+    }
+    uint32_t head = atomic_load_explicit(&ck->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&ck->tail, memory_order_acquire);
+    if (head - tail == CKPT_RING_SIZE) {
+        // Schatten nicht aktualisieren: die Änderung wird im nächsten Zyklus erneut gemeldet
+        atomic_fetch_add_explicit(&ck->overflows, 1, memory_order_relaxed);
+        return;
+    }
+    ck->ring[head & (CKPT_RING_SIZE - 1)] = (struct ckpt_change){(uint16_t)channel, value};
+    atomic_store_explicit(&ck->head, head + 1, memory_order_release);
+    ck->shadow[channel] = value;
+    ck->shadow_valid |= bit;
+}
+
+void ckpt_get_stats(struct checkpoint *ck, struct ckpt_stats *out) {
+    pthread_mutex_lock(&ck->lock);
+    *out = ck->stats;
+    pthread_mutex_unlock(&ck->lock);
+    out->ring_overflows = atomic_load_explicit(&ck->overflows, memory_order_relaxed);
+    out->uptime_ns = now_ns() - ck->start_ns;
+}
+
+void ckpt_close(struct checkpoint *ck, struct ckpt_stats *final) {
+    if (ck->thread_started) {
+        pthread_mutex_lock(&ck->lock);
+        atomic_store(&ck->running, 0);
+        pthread_cond_signal(&ck->wake);
+        pthread_mutex_unlock(&ck->lock);
+        pthread_join(ck->thread, NULL);
+        ck->thread_started = 0;
+    }
+    if (final != NULL) {
+        ckpt_get_stats(ck, final);
+    }
+    if (ck->log_fd >= 0) {
+        close(ck->log_fd);
+        ck->log_fd = -1;
+    }
+    if (ck->dir_fd >= 0) {
+        close(ck->dir_fd);
+        ck->dir_fd = -1;
+    }
+    pthread_cond_destroy(&ck->wake);
+    pthread_mutex_destroy(&ck->lock);
+}
@@ -0,0 +1,118 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+
+/*
+Verschleißarme Sicherung des Steuerungszustands (Kanäle mit int32-Werten).
+
+Die Regelschleife meldet pro Zyklus ihre Kanäle mit ckpt_set; geändert gemeldete Werte (mit
+optionalem Totband) landen in einem lock-freien Ring, die Schleife macht dabei weder
+Systemaufrufe noch wartet sie. Ein Hintergrund-Thread sammelt die Änderungen, fasst mehrfach
+geänderte Kanäle zu einem Datensatz zusammen und hängt sie alle flush_ms als 16-Byte-
+Delta-Datensätze an eine vorbelegte Log-Datei an - ein pwrite und ein fdatasync pro Stapel.
+Die Log-Datei wird beim Anlegen einmal mit Nullen beschrieben, damit spätere Schreibzugriffe
+keine Metadaten (Dateigröße, Extents) mehr ändern.
+
+Ist das Log zu compact_pct Prozent gefüllt, schreibt der Thread einen vollständigen Snapshot
+(temporäre Datei, fdatasync, rename) und beginnt das Log mit einer neuen Generation von vorn.
+Jeder Datensatz trägt eine Prüfsumme über Generation, Sequenznummer und Inhalt; alte
+Datensätze einer früheren Generation und ein halb geschriebener letzter Datensatz werden so
+beim Wiederherstellen erkannt und ignoriert.
+
+Wiederherstellen (ckpt_open): Snapshot und Log per mmap einblenden, Snapshot übernehmen und die
+gültigen Datensätze der passenden Generation der Reihe nach anwenden.
+
+Dateien: <dir>/controller.snap, <dir>/controller.log
+*/
+
+#define CKPT_MAX_CHANNELS 64
+#define CKPT_RING_SIZE 1024                // Zweierpotenz
+
+struct ckpt_options {
+    uint32_t log_bytes;                    // Größe der Log-Datei (Standard 64 KiB)
+    uint32_t flush_ms;                     // Abstand der Stapel (Standard 1000 ms)
+    uint32_t compact_pct;                  // Füllstand, ab dem verdichtet wird (Standard 75)
+};
+
+struct ckpt_stats {
+    uint64_t records;                      // geschriebene Delta-Datensätze
+    uint64_t record_bytes;
+    uint64_t snapshots;
+    uint64_t snapshot_bytes;
+    uint64_t syncs;                        // fdatasync-Aufrufe
+    uint64_t pages_written;                // berührte 4-KiB-Seiten (Schätzung für den eMMC-Verschleiß)
+    uint64_t ring_overflows;
+    uint64_t uptime_ns;
+    uint64_t restore_ns;                   // Dauer der Wiederherstellung beim Öffnen
+    uint32_t restored_records;             // beim Öffnen angewendete Datensätze
+};
+
+struct ckpt_change {
+    uint16_t channel;
+    int32_t value;
+};
+
+struct checkpoint {
+    // Zustand der Regelschleife (nur deren Thread)
+    int32_t shadow[CKPT_MAX_CHANNELS];     // zuletzt gemeldeter Wert
+    int32_t deadband[CKPT_MAX_CHANNELS];
+    uint64_t shadow_valid;                 // Bitmaske
+
+    // Ring Regelschleife → Hintergrund-Thread
+    _Atomic uint32_t head;
+    char pad1[60];
+    _Atomic uint32_t tail;
+    char pad2[60];
+    struct ckpt_change ring[CKPT_RING_SIZE];
+    _Atomic uint64_t overflows;            // Ring voll: Kanal wird im nächsten Zyklus erneut gemeldet
+
+    // Dauerhafter Zustand (nur Hintergrund-Thread nach dem Öffnen); durable enthält nur
+    // erfolgreich geschriebene Werte, pending die aus dem Ring übernommenen, noch offenen. Nach
+    // einem Schreibfehler bleiben sie offen und gehen in den nächsten Stapel ein
+    int32_t durable[CKPT_MAX_CHANNELS];
+    uint64_t durable_valid;
+    int32_t pending[CKPT_MAX_CHANNELS];
+    uint64_t pending_mask;
+    uint64_t generation;
+    uint32_t next_seq;
+    uint32_t log_records;                  // Datensätze im Log der aktuellen Generation
+    uint32_t log_capacity;
+    int log_fd;
+    int dir_fd;
+    char snap_path[512];
+    char tmp_path[512];
+
+    struct ckpt_options options;
+    pthread_t thread;
+    _Atomic int running;
+    int thread_started;
+    uint64_t start_ns;
+    struct ckpt_stats stats;               // vom Hintergrund-Thread geschrieben
+    pthread_mutex_t lock;                  // Statistik und Aufwecken, nie in der Regelschleife
+    pthread_cond_t wake;
+};
+
+// Zustand aus dir wiederherstellen (fehlende Dateien = leerer Zustand) und den
+// Hintergrund-Thread starten. options darf NULL sein. 0 bei Erfolg, sonst -1 (errno)
+int ckpt_open(struct checkpoint *ck, const char *dir, const struct ckpt_options *options);
+
+// Wiederhergestellter bzw. zuletzt gemeldeter Wert eines Kanals; 1 wenn vorhanden
+// (nur im Thread der Regelschleife)
+int ckpt_get(const struct checkpoint *ck, unsigned int channel, int32_t *value);
+
+// Änderungen mit |neu - alt| <= deadband nicht sichern (vor dem ersten ckpt_set setzen)
+void ckpt_set_deadband(struct checkpoint *ck, unsigned int channel, int32_t deadband);
+
+// Aus der Regelschleife: wartet nie, keine Systemaufrufe
+void ckpt_set(struct checkpoint *ck, unsigned int channel, int32_t value);
+
+void ckpt_get_stats(struct checkpoint *ck, struct ckpt_stats *out);
+
+// Ausstehende Änderungen schreiben, Thread beenden, Dateien schließen; final (darf NULL sein)
+// erhält die Statistik einschließlich des letzten Stapels
+void ckpt_close(struct checkpoint *ck, struct ckpt_stats *final);
+
+#endif
@@ -0,0 +1,257 @@
+/*
+Benchmark: Schreibvolumen und Wiederherstellungszeit der Zustandssicherung
+
+1. Delta-Log: eine simulierte Regelschleife (alle periode_us) meldet pro Zyklus 16 Kanäle mit
+   ckpt_set - einige Schaltzustände, die selten wechseln, und analoge Messwerte mit Rauschen und
+   Totband. Ausgegeben werden Datensätze, Bytes, fdatasync-Aufrufe und berührte Seiten, auf eine
+   Stunde hochgerechnet, sowie die Dauer von ckpt_set in der Schleife.
+2. Zum Vergleich der naive Ansatz: jeden Zyklus den vollständigen Zustand per pwrite und
+   fdatasync in eine Datei schreiben, direkt in der Schleife.
+3. Wiederherstellung: Log bis kurz vor die Verdichtungsschwelle füllen, neu öffnen, Dauer
+   messen und die wiederhergestellten Werte prüfen.
+
+Hinweis: Auf tmpfs (oft /tmp) kostet fdatasync fast nichts; für aussagekräftige Zeiten mit -d
+ein Verzeichnis auf dem Zielspeicher (eMMC, SD-Karte) angeben.
+
+Verwendung: ./ckpt_bench [-d verzeichnis] [-D sekunden] [-p periode_us] [-f flush_ms]
+*/
+
+#define _GNU_SOURCE
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "checkpoint.h"
+
+#define CHANNELS 16
+#define DISCRETE 4             // Kanäle 0..3: Schaltzustände, Rest: Messwerte
+#define DEADBAND 8
+#define PAGE_BYTES 4096
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static uint64_t percentile(const uint64_t *sorted, size_t n, double p) {
+    size_t i = (size_t)(p * (double)n);
+    return n == 0 ? 0 : sorted[i < n ? i : n - 1];
+}
+
+// Nächster simulierter Zustand: Schaltzustände wechseln selten, Messwerte rauschen um einen
+// langsam wandernden Sollwert
+static void simulate(int32_t *values, uint64_t cycle) {
+    for (int ch = 0; ch < DISCRETE; ++ch) {
+        if (rand() % 2000 == 0) {
+            values[ch] ^= 1;
+        }
+    }
+    for (int ch = DISCRETE; ch < CHANNELS; ++ch) {
+        int32_t setpoint = 500 + (int32_t)((cycle / 5000 + (uint64_t)ch) % 10) * 50;
+        values[ch] = setpoint + rand() % 11 - 5;
+    }
+}
+
+static void wait_until(uint64_t deadline) {
+    struct timespec ts = {(time_t)(deadline / 1000000000ULL), (long)(deadline % 1000000000ULL)};
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0) {
+    }
+}
+
+static void print_latency(const char *label, uint64_t *lat, size_t n) {
+    qsort(lat, n, sizeof(*lat), compare_u64);
+    printf("  %-26s p50 %8llu ns  p99 %8llu ns  max %10llu ns\n", label,
+           (unsigned long long)percentile(lat, n, 0.50), (unsigned long long)percentile(lat, n, 0.99),
+           (unsigned long long)(n ? lat[n - 1] : 0));
+}
+
+static double per_hour(uint64_t value, uint64_t ns) {
+    return ns ? (double)value * 3600e9 / (double)ns : 0.0;
+}
+
+static int bench_delta(const char *dir, int seconds, int period_us, uint32_t flush_ms) {
+    struct checkpoint ck;
+    struct ckpt_options options = {.flush_ms = flush_ms};
+    size_t cycles = (size_t)seconds * 1000000 / (size_t)period_us;
+    uint64_t *lat = calloc(cycles, sizeof(*lat));
+    int32_t values[CHANNELS] = {0};
+
+    if (lat == NULL || ckpt_open(&ck, dir, &options) != 0) {
+        perror("ckpt_open");
+        return -1;
+    }
+    for (int ch = DISCRETE; ch < CHANNELS; ++ch) {
+        ckpt_set_deadband(&ck, (unsigned int)ch, DEADBAND);
+    }
+    uint64_t next = now_ns();
+    for (size_t i = 0; i < cycles; ++i) {
+        simulate(values, i);
+        uint64_t t0 = now_ns();
+        for (int ch = 0; ch < CHANNELS; ++ch) {
+            ckpt_set(&ck, (unsigned int)ch, values[ch]);
+        }
+        lat[i] = now_ns() - t0;
+        next += (uint64_t)period_us * 1000;
+        wait_until(next);
+    }
+    struct ckpt_stats st;
+    ckpt_close(&ck, &st);
+
+    uint64_t bytes = st.record_bytes + st.snapshot_bytes;
+    printf("Delta-Log (%zu Zyklen, Stapel alle %u ms):\n", cycles, flush_ms);
+    printf("  %llu Datensätze, %llu Snapshots, %llu Ringüberläufe\n", (unsigned long long)st.records,
+           (unsigned long long)st.snapshots, (unsigned long long)st.ring_overflows);
+    printf("  %12.0f Bytes/h  %10.0f fdatasync/h  %10.0f Seiten/h (ohne Vorbelegung)\n",
+           per_hour(bytes, st.uptime_ns), per_hour(st.syncs, st.uptime_ns),
+           per_hour(st.pages_written - ck.options.log_bytes / PAGE_BYTES, st.uptime_ns));
+    print_latency("ckpt_set (16 Kanäle):", lat, cycles);
+    free(lat);
+    return 0;
+}
+
+static int bench_naive(const char *dir, int seconds, int period_us) {
+    char path[512];
+    size_t cycles = (size_t)seconds * 1000000 / (size_t)period_us;
+    uint64_t *lat = calloc(cycles, sizeof(*lat));
+    int32_t values[CHANNELS] = {0};
+
+    snprintf(path, sizeof(path), "%s/naive.state", dir);
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (lat == NULL || fd < 0) {
+        perror(path);
+        return -1;
+    }
+    uint64_t start = now_ns();
+    uint64_t next = start;
+    for (size_t i = 0; i < cycles; ++i) {
+        simulate(values, i);
+        uint64_t t0 = now_ns();
+        if (pwrite(fd, values, sizeof(values), 0) != (ssize_t)sizeof(values) || fdatasync(fd) != 0) {
+            perror("naiv schreiben");
+            break;
+        }
+        lat[i] = now_ns() - t0;
+        next += (uint64_t)period_us * 1000;
+        wait_until(next);
+    }
+    uint64_t elapsed = now_ns() - start;
+    close(fd);
+    unlink(path);
+
+    printf("Naiv (vollständiger Zustand + fdatasync pro Zyklus):\n");
+    printf("  %12.0f Bytes/h  %10.0f fdatasync/h  %10.0f Seiten/h\n", per_hour(cycles * sizeof(values), elapsed),
+           per_hour(cycles, elapsed), per_hour(cycles, elapsed));
+    print_latency("Schreiben in der Schleife:", lat, cycles);
+    free(lat);
+    return 0;
+}
+
+static int bench_restore(const char *dir) {
+    struct checkpoint ck;
+    struct ckpt_options options = {.flush_ms = 1, .compact_pct = 100};
+    int32_t expected[CHANNELS];
+    struct timespec pause = {0, 2000000L};
+
+    if (ckpt_open(&ck, dir, &options) != 0) {
+        perror("ckpt_open");
+        return -1;
+    }
+    // Bis auf einen Stapel vor der Schwelle füllen: jeder Stapel ändert alle Kanäle
+    uint32_t batches = (ck.log_capacity - ck.log_records) / CHANNELS - 1;
+    for (uint32_t b = 0; b < batches; ++b) {
+        for (int ch = 0; ch < CHANNELS; ++ch) {
+            expected[ch] = (int32_t)(b * CHANNELS + (uint32_t)ch);
+            ckpt_set(&ck, (unsigned int)ch, expected[ch]);
+        }
+        nanosleep(&pause, NULL);
+    }
+    ckpt_close(&ck, NULL);
+
+    if (ckpt_open(&ck, dir, NULL) != 0) {
+        perror("ckpt_open");
+        return -1;
+    }
+    struct ckpt_stats st;
+    int ok = 1;
+    for (int ch = 0; ch < CHANNELS; ++ch) {
+        int32_t value;
+        if (!ckpt_get(&ck, (unsigned int)ch, &value) || value != expected[ch]) {
+            ok = 0;
+        }
+    }
+    ckpt_close(&ck, &st);
+    printf("Wiederherstellung: %u Datensätze (%.0f %% des Logs) in %.1f µs, Werte %s\n", st.restored_records,
+           100.0 * st.restored_records / ck.log_capacity, (double)st.restore_ns / 1000.0, ok ? "korrekt" : "FALSCH");
+    return ok ? 0 : -1;
+}
+
+static void remove_files(const char *dir) {
+    const char *names[] = {"controller.snap", "controller.snap.tmp", "controller.log"};
+    char path[512];
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); ++i) {
+        snprintf(path, sizeof(path), "%s/%s", dir, names[i]);
+        unlink(path);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    char tmpdir[] = "/tmp/ckpt_bench.XXXXXX";
+    const char *dir = NULL;
+    int seconds = 5;
+    int period_us = 1000;
+    int flush_ms = 1000;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "d:D:p:f:h")) != -1) {
+        switch (opt) {
+        case 'd': dir = optarg; break;
+        case 'D': seconds = atoi(optarg); break;
+        case 'p': period_us = atoi(optarg); break;
+        case 'f': flush_ms = atoi(optarg); break;
+        default:
+            fprintf(stderr, "Verwendung: %s [-d verzeichnis] [-D sekunden] [-p periode_us] [-f flush_ms]\n", argv[0]);
+            return opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if (seconds < 1 || period_us < 1 || flush_ms < 1) {
+        fprintf(stderr, "Ungültige Parameter\n");
+        return EXIT_FAILURE;
+    }
+    int own_dir = dir == NULL;
+    if (own_dir && (dir = mkdtemp(tmpdir)) == NULL) {
+        perror("mkdtemp");
+        return EXIT_FAILURE;
+    }
+
+    srand(1);
+    printf("Verzeichnis %s, %d s pro Messung, Zyklus %d µs, %d Kanäle\n", dir, seconds, period_us, CHANNELS);
+    int status = EXIT_SUCCESS;
+    remove_files(dir);
+    if (bench_delta(dir, seconds, period_us, (uint32_t)flush_ms) != 0) {
+        status = EXIT_FAILURE;
+    }
+    remove_files(dir);
+    if (bench_naive(dir, seconds, period_us) != 0) {
+        status = EXIT_FAILURE;
+    }
+    if (bench_restore(dir) != 0) {
+        status = EXIT_FAILURE;
+    }
+    remove_files(dir);
+    if (own_dir) {
+        rmdir(dir);
+    }
+    return status;
+}
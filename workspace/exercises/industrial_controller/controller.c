@@ -2,23 +2,175 @@
 #include <unistd.h>
 #include <stdlib.h>
 #include <time.h>
+#include <signal.h>
+#include <stdint.h>
+#include "process_image.h" // Prozessabbild für HMI, Logger, Governor (Shared Memory)
+#include "checkpoint.h" // Zustand über Neustarts hinweg sichern (verschleißarm)
+#include "metrics.h" // Kennzahlen für metrics_collector (../metrics)
 
 #define SENSOR_PIN 4
 #define ACTUATOR_PIN 7
 #define UPPER_THRESHOLD 60
 #define LOWER_THRESHOLD 40
 
+// Gesicherte Kanäle (Nummern stehen in den Dateien, nicht umnummerieren; 2 war der Sensorwert,
+// der nach einem Neustart ohnehin neu gelesen wird). Der Zykluszähler nur bei größeren Sprüngen,
+// damit nicht jeder Zyklus einen Schreibvorgang auslöst; der 64-Bit-Schaltzähler in zwei Kanälen
+enum {
+    CKPT_ACTUATOR = 0,
+    CKPT_SWITCH_COUNT = 1,                 // untere 32 Bit
+    CKPT_SCAN_COUNTER = 3,
+    CKPT_SWITCH_COUNT_HI = 4,              // obere 32 Bit
+};
+#define SCAN_COUNTER_DEADBAND 60
+
+int generateSensorData();
+void controlActuator(int sensorValue);
+void activateActuator();
+void deactivateActuator();
+void publishImage(int sensorValue, const struct timespec *cycleStart);
+void restoreState();
+void saveState();
+void setupMetrics();
+void updateMetrics(int sensorValue, const struct timespec *cycleStart);
+
+static int actuatorState = 0; // 0 = aus, 1 = an
+static uint64_t switchCount = 0;
+static struct process_image *processImage;
+static struct pi_data image;
+static struct checkpoint checkpoint;
+static int checkpointOpen = 0;
+static struct metric *metricCycles;
+static struct metric *metricSwitches;
+static struct metric *metricSensor;
+static struct metric *metricActuator;
+static struct metric *metricCycleTime;
+static uint64_t metricSwitchCount; // bereits gezählte Schaltvorgänge
+static volatile sig_atomic_t running = 1;
+
+static void handleSignal(int sig) {
+    (void)sig;
+    running = 0;
+}
+
 void setup() {
     // Initialisierung der Pins (Simulation)
     printf("Initialisiere Sensor-Pin %d und Aktuator-Pin %d\n", SENSOR_PIN, ACTUATOR_PIN);
     srand(time(NULL));
+    // Prozessabbild anlegen; ohne läuft die Steuerung weiter, nur ohne externe Leser
+    processImage = pi_create(PI_SHM_NAME);
+    if (processImage == NULL) {
+        perror("Hinweis: Prozessabbild " PI_SHM_NAME " nicht verfügbar");
+    }
+    image.num_sensors = 1;
+    image.sensors[0].pin = SENSOR_PIN;
+    image.num_actuators = 1;
+    image.actuators[0].pin = ACTUATOR_PIN;
+    restoreState();
+    setupMetrics();
+}
+
+// Kennzahlen registrieren; ohne /dev/shm bleiben alle Aktualisierungen wirkungslos
+void setupMetrics() {
+    static const double cycleBounds[] = {1e-6, 5e-6, 1e-5, 5e-5, 1e-4, 5e-4, 1e-3, 5e-3};
+    metricSwitchCount = switchCount; // wiederhergestellte Schaltvorgänge nicht erneut zählen
+    if (metrics_init("controller") != 0) {
+        perror("Hinweis: Kennzahlen nicht verfügbar");
+        return;
+    }
+    metricCycles = metrics_counter("controller_cycles_total", "Abgeschlossene Regelzyklen");
+    metricSwitches = metrics_counter("controller_actuator_switches_total", "Schaltvorgänge des Aktuators");
+    metricSensor = metrics_gauge("controller_sensor_value", "Letzter Sensorwert");
+    metricActuator = metrics_gauge("controller_actuator_state", "Aktuator: 0 = aus, 1 = an");
+    metricCycleTime = metrics_histogram("controller_cycle_seconds", "Rechenzeit eines Regelzyklus (ohne Warten)",
+                                        cycleBounds, sizeof(cycleBounds) / sizeof(cycleBounds[0]));
+}
+
+// Einmal pro Zyklus: nur Speicherzugriffe, keine Sperre
+void updateMetrics(int sensorValue, const struct timespec *cycleStart) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    metrics_inc(metricCycles);
+    metrics_add(metricSwitches, switchCount - metricSwitchCount);
+    metricSwitchCount = switchCount;
+    metrics_set(metricSensor, sensorValue);
+    metrics_set(metricActuator, actuatorState);
+    metrics_observe(metricCycleTime, (double)(now.tv_sec - cycleStart->tv_sec) +
+                                         (double)(now.tv_nsec - cycleStart->tv_nsec) / 1e9);
+}
+
+// Zustand des letzten Laufs laden (Verzeichnis aus CONTROLLER_STATE_DIR, sonst ".")
+void restoreState() {
+    const char *dir = getenv("CONTROLLER_STATE_DIR");
+    int32_t value;
+    struct ckpt_stats stats;
+
+    if (dir == NULL || dir[0] == '\0') {
+        dir = ".";
+    }
+    if (ckpt_open(&checkpoint, dir, NULL) != 0) {
+        perror("Hinweis: Zustandssicherung nicht verfügbar");
+        return;
+    }
+    checkpointOpen = 1;
+    ckpt_set_deadband(&checkpoint, CKPT_SCAN_COUNTER, SCAN_COUNTER_DEADBAND);
+    if (ckpt_get(&checkpoint, CKPT_SWITCH_COUNT, &value)) {
+        switchCount = (uint64_t)(uint32_t)value;
+    }
+    if (ckpt_get(&checkpoint, CKPT_SWITCH_COUNT_HI, &value)) {
+        switchCount |= (uint64_t)(uint32_t)value << 32;
+    }
+    if (ckpt_get(&checkpoint, CKPT_SCAN_COUNTER, &value)) {
+        image.scan_counter = (uint32_t)value;
+    }
+    if (ckpt_get(&checkpoint, CKPT_ACTUATOR, &value) && value) {
+        activateActuator();
+        actuatorState = 1;
+    }
+    ckpt_get_stats(&checkpoint, &stats);
+    printf("Zustand aus %s wiederhergestellt in %.1f µs (%u Änderungen): Aktuator %s, %llu Schaltvorgänge\n",
+           dir, (double)stats.restore_ns / 1000.0, stats.restored_records, actuatorState ? "an" : "aus",
+           (unsigned long long)switchCount);
+}
+
+// Einmal pro Zyklus: nur Änderungen in den Ring, geschrieben wird im Hintergrund
+void saveState() {
+    if (!checkpointOpen) {
+        return;
+    }
+    ckpt_set(&checkpoint, CKPT_ACTUATOR, actuatorState);
+    ckpt_set(&checkpoint, CKPT_SWITCH_COUNT, (int32_t)(uint32_t)switchCount);
+    ckpt_set(&checkpoint, CKPT_SWITCH_COUNT_HI, (int32_t)(uint32_t)(switchCount >> 32));
+    ckpt_set(&checkpoint, CKPT_SCAN_COUNTER, (int32_t)image.scan_counter);
+}
+
+// Zustand am Zyklusende einmal veröffentlichen; blockiert nie, auch nicht bei vielen Lesern
+void publishImage(int sensorValue, const struct timespec *cycleStart) {
+    struct timespec now;
+    if (processImage == NULL) {
+        return;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    image.scan_counter++;
+    image.timestamp_ns = (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+    image.cycle_time_ns = (uint64_t)((now.tv_sec - cycleStart->tv_sec) * 1000000000LL +
+                                     (now.tv_nsec - cycleStart->tv_nsec));
+    image.sensors[0].value = sensorValue;
+    image.actuators[0].value = actuatorState;
+    image.switch_count = switchCount;
+    pi_publish(processImage, &image);
 }
 
 void loop() {
+    struct timespec cycleStart;
+    clock_gettime(CLOCK_MONOTONIC, &cycleStart);
     // Simulierte Leseoperation vom Sensor
     int sensorValue = generateSensorData();
     printf("Sensorwert: %d\n", sensorValue);
     controlActuator(sensorValue);
+    publishImage(sensorValue, &cycleStart);
+    saveState();
+    updateMetrics(sensorValue, &cycleStart);
     sleep(1);
 }
 
@@ -28,13 +180,14 @@ int generateSensorData() {
 }
 
 void controlActuator(int sensorValue) {
-    static int actuatorState = 0; // 0 = aus, 1 = an
     if (sensorValue > UPPER_THRESHOLD && !actuatorState) {
         activateActuator();
         actuatorState = 1;
+        switchCount++;
     } else if (sensorValue < LOWER_THRESHOLD && actuatorState) {
         deactivateActuator();
         actuatorState = 0;
+        switchCount++;
     }
 }
 
@@ -48,9 +201,22 @@ void deactivateActuator() {
 
 // Hauptfunktion
 int main() {
+    signal(SIGINT, handleSignal);
+    signal(SIGTERM, handleSignal);
     setup();
-    while (1) {
+    while (running) {
         loop();
     }
+    pi_close(processImage, PI_SHM_NAME, 1);
+    metrics_shutdown();
+    if (checkpointOpen) {
+        struct ckpt_stats stats;
+        ckpt_close(&checkpoint, &stats);
+        uint64_t bytes = stats.record_bytes + stats.snapshot_bytes;
+        printf("Zustandssicherung: %llu Bytes in %llu Schreibvorgängen (%.0f Bytes/h), %llu Snapshots\n",
+               (unsigned long long)bytes, (unsigned long long)stats.syncs,
+               stats.uptime_ns ? (double)bytes * 3600e9 / (double)stats.uptime_ns : 0.0,
+               (unsigned long long)stats.snapshots);
+    }
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,258 @@
+/*
+Benchmark: Momentaufnahmen des Prozessabbilds mit vielen gleichzeitigen Lesern
+
+Ein Schreiber-Thread veröffentlicht wie die Regelschleife das Prozessabbild (mit -p alle
+periode_us, sonst ohne Pause als schlimmster Fall), während N Leser-Threads ununterbrochen
+pi_snapshot aufrufen. Gemessen werden die Dauer jeder Momentaufnahme und jedes pi_publish
+(mit clock_gettime, enthält dessen Overhead). Jede Aufnahme wird auf Konsistenz geprüft: alle
+Kanäle tragen den Zykluszähler, ein gemischter Stand würde als "zerrissen" gezählt.
+
+Erwartung: Snapshot-Latenz und Schreibzeit bleiben mit steigender Leserzahl nahezu gleich,
+der Schreiber wird nie aufgehalten; zerrissene Aufnahmen gibt es nicht.
+
+Verwendung: ./pi_bench [-r leser,leser,...] [-D sekunden] [-p periode_us]
+*/
+
+#define _GNU_SOURCE
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "process_image.h"
+
+#define HIST_NS 65536          // 1-ns-Auflösung bis hier, darüber nur das Maximum
+#define MAX_READERS 256
+#define BENCH_SHM_NAME "/pi_bench"
+
+struct latency {
+    uint64_t *hist;
+    uint64_t count;
+    uint64_t overflow;
+    uint64_t max_ns;
+};
+
+struct reader {
+    pthread_t tid;
+    struct process_image *pi;
+    struct latency lat;
+    uint64_t retries;
+    uint64_t torn;
+};
+
+static atomic_int running;
+static int period_us;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void record(struct latency *lat, uint64_t ns) {
+    if (ns < HIST_NS) {
+        lat->hist[ns]++;
+    } else {
+        lat->overflow++;
+    }
+    if (ns > lat->max_ns) {
+        lat->max_ns = ns;
+    }
+    lat->count++;
+}
+
+static uint64_t percentile(const struct latency *lat, double p) {
+    uint64_t rank = (uint64_t)(p * (double)lat->count);
+    uint64_t seen = 0;
+    for (uint64_t ns = 0; ns < HIST_NS; ++ns) {
+        seen += lat->hist[ns];
+        if (seen > rank) {
+            return ns;
+        }
+    }
+    return lat->max_ns; // Perzentil liegt im Überlaufbereich
+}
+
+static void latency_init(struct latency *lat) {
+    memset(lat, 0, sizeof(*lat));
+    lat->hist = calloc(HIST_NS, sizeof(uint64_t));
+    if (lat->hist == NULL) {
+        perror("calloc");
+        exit(EXIT_FAILURE);
+    }
+}
+
+static void latency_merge(struct latency *into, const struct latency *from) {
+    for (uint64_t ns = 0; ns < HIST_NS; ++ns) {
+        into->hist[ns] += from->hist[ns];
+    }
+    into->count += from->count;
+    into->overflow += from->overflow;
+    if (from->max_ns > into->max_ns) {
+        into->max_ns = from->max_ns;
+    }
+}
+
+static void *writer_main(void *arg) {
+    struct process_image *pi = arg;
+    struct latency *lat = malloc(sizeof(*lat));
+    struct pi_data data;
+    struct timespec pause = {0, (long)period_us * 1000L};
+
+    latency_init(lat);
+    memset(&data, 0, sizeof(data));
+    data.num_sensors = PI_MAX_SENSORS;
+    data.num_actuators = PI_MAX_ACTUATORS;
+    while (atomic_load_explicit(&running, memory_order_relaxed)) {
+        // Alle Kanäle tragen den Zykluszähler, damit Leser gemischte Stände erkennen
+        data.scan_counter++;
+        for (int i = 0; i < PI_MAX_SENSORS; ++i) {
+            data.sensors[i].value = (int32_t)data.scan_counter;
+        }
+        for (int i = 0; i < PI_MAX_ACTUATORS; ++i) {
+            data.actuators[i].value = (int32_t)(data.scan_counter & 1);
+        }
+        data.switch_count = data.scan_counter;
+
+        uint64_t t0 = now_ns();
+        data.timestamp_ns = t0;
+        pi_publish(pi, &data);
+        record(lat, now_ns() - t0);
+
+        if (period_us > 0) {
+            nanosleep(&pause, NULL);
+        }
+    }
+    return lat;
+}
+
+static int consistent(const struct pi_data *d) {
+    for (int i = 0; i < PI_MAX_SENSORS; ++i) {
+        if (d->sensors[i].value != (int32_t)d->scan_counter) {
+            return 0;
+        }
+    }
+    for (int i = 0; i < PI_MAX_ACTUATORS; ++i) {
+        if (d->actuators[i].value != (int32_t)(d->scan_counter & 1)) {
+            return 0;
+        }
+    }
+    return d->switch_count == d->scan_counter;
+}
+
+static void *reader_main(void *arg) {
+    struct reader *r = arg;
+    struct pi_data data;
+
+    while (atomic_load_explicit(&running, memory_order_relaxed)) {
+        uint64_t t0 = now_ns();
+        r->retries += pi_snapshot(r->pi, &data);
+        record(&r->lat, now_ns() - t0);
+        if (!consistent(&data)) {
+            r->torn++;
+        }
+    }
+    return NULL;
+}
+
+static int run(int num_readers, int seconds) {
+    struct reader *readers = calloc((size_t)num_readers, sizeof(*readers));
+    struct process_image *writer_pi = pi_create(BENCH_SHM_NAME);
+    if (readers == NULL || writer_pi == NULL) {
+        perror("Prozessabbild anlegen");
+        return -1;
+    }
+
+    atomic_store(&running, 1);
+    pthread_t writer;
+    pthread_create(&writer, NULL, writer_main, writer_pi);
+    for (int i = 0; i < num_readers; ++i) {
+        // Jeder Leser blendet das Segment selbst ein, wie ein eigener Prozess
+        readers[i].pi = pi_open(BENCH_SHM_NAME);
+        if (readers[i].pi == NULL) {
+            perror("pi_open");
+            exit(EXIT_FAILURE);
+        }
+        latency_init(&readers[i].lat);
+        pthread_create(&readers[i].tid, NULL, reader_main, &readers[i]);
+    }
+
+    sleep((unsigned int)seconds);
+    atomic_store(&running, 0);
+
+    struct latency *write_lat;
+    pthread_join(writer, (void **)&write_lat);
+    struct latency read_lat;
+    latency_init(&read_lat);
+    uint64_t retries = 0;
+    uint64_t torn = 0;
+    for (int i = 0; i < num_readers; ++i) {
+        pthread_join(readers[i].tid, NULL);
+        latency_merge(&read_lat, &readers[i].lat);
+        retries += readers[i].retries;
+        torn += readers[i].torn;
+        free(readers[i].lat.hist);
+        pi_close(readers[i].pi, NULL, 0);
+    }
+
+    printf("%6d %12.0f %6llu %6llu %8llu %8llu %9.4f %6llu | %6llu %6llu %8llu %8llu\n", num_readers,
+           (double)read_lat.count / seconds, (unsigned long long)percentile(&read_lat, 0.50),
+           (unsigned long long)percentile(&read_lat, 0.99), (unsigned long long)percentile(&read_lat, 0.9999),
+           (unsigned long long)read_lat.max_ns, read_lat.count ? 100.0 * (double)retries / (double)read_lat.count : 0.0,
+           (unsigned long long)torn, (unsigned long long)percentile(write_lat, 0.50),
+           (unsigned long long)percentile(write_lat, 0.99), (unsigned long long)percentile(write_lat, 0.9999),
+           (unsigned long long)write_lat->max_ns);
+    fflush(stdout);
+
+    free(read_lat.hist);
+    free(write_lat->hist);
+    free(write_lat);
+    free(readers);
+    pi_close(writer_pi, BENCH_SHM_NAME, 1);
+    return torn == 0 ? 0 : 1;
+}
+
+int main(int argc, char *argv[]) {
+    char default_list[] = "1,2,4,8,16,32";
+    char *list = default_list;
+    int seconds = 2;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "r:D:p:h")) != -1) {
+        switch (opt) {
+        case 'r': list = optarg; break;
+        case 'D': seconds = atoi(optarg); break;
+        case 'p': period_us = atoi(optarg); break;
+        default:
+            fprintf(stderr, "Verwendung: %s [-r leser,leser,...] [-D sekunden] [-p periode_us]\n", argv[0]);
+            return opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if (seconds < 1 || period_us < 0) {
+        fprintf(stderr, "Ungültige Parameter\n");
+        return EXIT_FAILURE;
+    }
+
+    printf("Schreiber: %s, %d s pro Messung, Abbild %zu Bytes, Latenzen in ns\n",
+           period_us > 0 ? "periodisch" : "ohne Pause", seconds, sizeof(struct pi_data));
+    printf("%6s %12s %6s %6s %8s %8s %9s %6s | %6s %6s %8s %8s\n", "leser", "snapshots/s", "p50", "p99", "p99.99",
+           "max", "wdh. %", "zerr.", "w p50", "w p99", "w p99.99", "w max");
+
+    int status = EXIT_SUCCESS;
+    for (char *tok = strtok(list, ","); tok != NULL; tok = strtok(NULL, ",")) {
+        int n = atoi(tok);
+        if (n < 1 || n > MAX_READERS) {
+            fprintf(stderr, "Leserzahl außerhalb 1..%d: %s\n", MAX_READERS, tok);
+            return EXIT_FAILURE;
+        }
+        if (run(n, seconds) != 0) {
+            status = EXIT_FAILURE;
+        }
+    }
+    return status;
+}
@@ -0,0 +1,108 @@
+/*
+Monitor für das Prozessabbild der Steuerung
+
+Liest das Shared-Memory-Segment des Controllers (nur lesend) und gibt bei jedem neuen Zyklus
+eine Zeile mit Zykluszähler, Sensorwerten, Aktuatorzuständen und dem Alter der Daten aus.
+Der Controller wird dadurch nicht beeinflusst: jede Abfrage ist eine Momentaufnahme ohne Sperre.
+
+Aufruf: pi_monitor [-n name] [-i intervall_ms] [-c anzahl] [-a]
+  -c  nach so vielen Ausgaben beenden (0 = endlos)
+  -a  jede Abfrage ausgeben, auch ohne neuen Zyklus
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "process_image.h"
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void print_image(const struct pi_data *d, unsigned int retries) {
+    double age_ms = d->timestamp_ns ? (double)(now_ns() - d->timestamp_ns) / 1e6 : 0.0;
+
+    printf("Zyklus %8" PRIu64 "  ", d->scan_counter);
+    for (uint32_t i = 0; i < d->num_sensors && i < PI_MAX_SENSORS; ++i) {
+        printf("Sensor[%d]=%3d  ", d->sensors[i].pin, d->sensors[i].value);
+    }
+    for (uint32_t i = 0; i < d->num_actuators && i < PI_MAX_ACTUATORS; ++i) {
+        printf("Aktuator[%d]=%-3s  ", d->actuators[i].pin, d->actuators[i].value ? "an" : "aus");
+    }
+    printf("Schaltvorgänge %" PRIu64 "  Zykluszeit %.1f µs  Alter %.1f ms", d->switch_count,
+           (double)d->cycle_time_ns / 1000.0, age_ms);
+    if (retries > 0) {
+        printf("  (%u Wiederholungen)", retries);
+    }
+    printf("\n");
+}
+
+int main(int argc, char *argv[]) {
+    const char *name = PI_SHM_NAME;
+    int interval_ms = 200;
+    long count = 0;
+    int all = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:i:c:a")) != -1) {
+        switch (opt) {
+        case 'n':
+            name = optarg;
+            break;
+        case 'i':
+            interval_ms = atoi(optarg);
+            break;
+        case 'c':
+            count = atol(optarg);
+            break;
+        case 'a':
+            all = 1;
+            break;
+        default:
+            fprintf(stderr, "Verwendung: %s [-n name] [-i intervall_ms] [-c anzahl] [-a]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (interval_ms < 1) {
+        interval_ms = 1;
+    }
+
+    struct process_image *pi = pi_open(name);
+    if (pi == NULL) {
+        fprintf(stderr, "Prozessabbild %s nicht lesbar: %s (läuft der Controller?)\n", name,
+                errno == EPROTO ? "unbekanntes Format" : strerror(errno));
+        return 1;
+    }
+    printf("Prozessabbild %s, Schreiber PID %d\n", name, (int)pi_writer_pid(pi));
+
+    struct timespec interval = {interval_ms / 1000, (long)(interval_ms % 1000) * 1000000L};
+    uint64_t last_scan = UINT64_MAX;
+    long printed = 0;
+    while (count == 0 || printed < count) {
+        struct pi_data data;
+        unsigned int retries = pi_snapshot(pi, &data);
+        if (all || data.scan_counter != last_scan) {
+            print_image(&data, retries);
+            fflush(stdout);
+            last_scan = data.scan_counter;
+            printed++;
+        }
+        if (!pi_writer_alive(pi)) {
+            fprintf(stderr, "Schreiber (PID %d) läuft nicht mehr\n", (int)pi_writer_pid(pi));
+            break;
+        }
+        nanosleep(&interval, NULL);
+    }
+
+    pi_close(pi, NULL, 0);
+    return 0;
+}
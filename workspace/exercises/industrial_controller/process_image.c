@@ -0,0 +1,131 @@
+#define _GNU_SOURCE // kill, getpid
+
+#include "process_image.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static struct process_image *pi_map(const char *name, int writable) {
+    int fd = shm_open(name, writable ? (O_RDWR | O_CREAT) : O_RDONLY, 0644);
+    if (fd == -1) {
+        return NULL;
+    }
+    if (writable && ftruncate(fd, sizeof(struct pi_segment)) != 0) {
+        close(fd);
+        return NULL;
+    }
+    struct stat st;
+    if (!writable && (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(struct pi_segment))) {
+        close(fd);
+        errno = EPROTO;
+        return NULL;
+    }
+    void *map = mmap(NULL, sizeof(struct pi_segment), writable ? (PROT_READ | PROT_WRITE) : PROT_READ,
+                     MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return NULL;
+    }
+    struct process_image *pi = calloc(1, sizeof(*pi));
+    if (pi == NULL) {
+        munmap(map, sizeof(struct pi_segment));
+        return NULL;
+    }
+    pi->seg = map;
+    pi->writable = writable;
+    return pi;
+}
+
+struct process_image *pi_create(const char *name) {
+    struct process_image *pi = pi_map(name, 1);
+    if (pi == NULL) {
+        return NULL;
+    }
+    struct pi_segment *seg = pi->seg;
+
+    // Neu beginnen: Leser eines alten Schreibers sehen erst nach magic wieder gültige Daten
+    __atomic_store_n(&seg->magic, 0, __ATOMIC_RELAXED);
+    memset(seg->data, 0, sizeof(seg->data));
+    atomic_store_explicit(&seg->seq, 0, memory_order_relaxed);
+    seg->version = PI_VERSION;
+    seg->data_size = sizeof(struct pi_data);
+    seg->writer_pid = getpid();
+    __atomic_store_n(&seg->magic, PI_MAGIC, __ATOMIC_RELEASE);
+
+    // Seitenfehler beim Veröffentlichen vermeiden
+    mlock(seg, sizeof(*seg));
+    return pi;
+}
+
+struct process_image *pi_open(const char *name) {
+    struct process_image *pi = pi_map(name, 0);
+    if (pi == NULL) {
+        return NULL;
+    }
+    const struct pi_segment *seg = pi->seg;
+    if (__atomic_load_n(&seg->magic, __ATOMIC_ACQUIRE) != PI_MAGIC || seg->version != PI_VERSION ||
+        seg->data_size != sizeof(struct pi_data)) {
+        pi_close(pi, NULL, 0);
+        errno = EPROTO;
+        return NULL;
+    }
+    return pi;
+}
+
+void pi_close(struct process_image *pi, const char *name, int unlink) {
+    if (pi == NULL) {
+        return;
+    }
+    munmap(pi->seg, sizeof(struct pi_segment));
+    if (unlink && name != NULL) {
+        shm_unlink(name);
+    }
+    free(pi);
+}
+
+void pi_publish(struct process_image *pi, const struct pi_data *data) {
+    struct pi_segment *seg = pi->seg;
+    uint64_t seq = atomic_load_explicit(&seg->seq, memory_order_relaxed);
+
+    // seq ungerade: Leser weichen auf Kopie 1 aus, während Kopie 0 geschrieben wird
+    atomic_store_explicit(&seg->seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    memcpy(&seg->data[0], data, sizeof(*data));
+
+    // seq gerade: Kopie 0 ist fertig, jetzt wird Kopie 1 nachgezogen
+    // Fence wie oben: die Schreibzugriffe auf Kopie 1 dürfen nicht vor den Store von seq + 2
+    // wandern, sonst liest ein Leser Kopie 1 halb geschrieben, obwohl er seq ungerade sah
+    atomic_store_explicit(&seg->seq, seq + 2, memory_order_release);
+    atomic_thread_fence(memory_order_release);
+    memcpy(&seg->data[1], data, sizeof(*data));
+}
+
+unsigned int pi_snapshot(const struct process_image *pi, struct pi_data *out) {
+    const struct pi_segment *seg = pi->seg;
+    unsigned int retries = 0;
+
+    for (;;) {
+        uint64_t seq = atomic_load_explicit(&seg->seq, memory_order_acquire);
+        memcpy(out, &seg->data[seq & 1], sizeof(*out));
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&seg->seq, memory_order_relaxed) == seq) {
+            return retries;
+        }
+        retries++;
+    }
+}
+
+pid_t pi_writer_pid(const struct process_image *pi) {
+    return pi->seg->writer_pid;
+}
+
+int pi_writer_alive(const struct process_image *pi) {
+    pid_t pid = pi->seg->writer_pid;
+    return pid > 0 && (kill(pid, 0) == 0 || errno == EPERM);
+}
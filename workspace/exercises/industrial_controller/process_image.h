@@ -0,0 +1,86 @@
+#ifndef PROCESS_IMAGE_H
+#define PROCESS_IMAGE_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+/*
+Prozessabbild der Steuerung im POSIX-Shared-Memory.
+
+Die Regelschleife schreibt einmal pro Zyklus Sensorwerte, Aktuatorzustände und Zykluszähler in
+ein Segment; beliebig viele Leser (HMI, Logger, DVFS-Governor) holen sich daraus konsistente
+Momentaufnahmen, ohne die Schleife je zu blockieren.
+
+Synchronisation: Sequenzzähler mit zwei Kopien (Seqlock in der "Latch"-Variante). Der Schreiber
+erhöht seq, aktualisiert Kopie 0, erhöht seq erneut und aktualisiert Kopie 1. Ein Leser nimmt
+die Kopie seq & 1 - das ist immer die, an der gerade nicht geschrieben wird - und prüft danach,
+ob seq sich verändert hat. Anders als beim einfachen Seqlock wartet ein Leser also nie auf einen
+halb fertigen Schreibvorgang; wiederholen muss er nur, wenn genau während seines Kopierens
+(einige 10 ns) ein neuer Zyklus veröffentlicht wird. Der Schreiber wartet auf niemanden und
+macht keine Systemaufrufe.
+
+Es darf nur einen Schreiber geben. Leser blenden das Segment nur lesend ein.
+*/
+
+#define PI_SHM_NAME "/controller_pi"
+#define PI_MAGIC 0x50494d47U // "PIMG"
+#define PI_VERSION 1
+#define PI_MAX_SENSORS 16
+#define PI_MAX_ACTUATORS 16
+
+struct pi_channel {
+    int32_t pin;
+    int32_t value;                     // Sensor: Messwert, Aktuator: 0 = aus, 1 = an
+};
+
+// Inhalt einer Momentaufnahme
+struct pi_data {
+    uint64_t scan_counter;             // abgeschlossene Regelzyklen
+    uint64_t timestamp_ns;             // CLOCK_MONOTONIC beim Veröffentlichen
+    uint64_t cycle_time_ns;            // Rechenzeit des letzten Zyklus (ohne Warten)
+    uint32_t num_sensors;
+    uint32_t num_actuators;
+    struct pi_channel sensors[PI_MAX_SENSORS];
+    struct pi_channel actuators[PI_MAX_ACTUATORS];
+    uint64_t switch_count;             // Schaltvorgänge seit dem Start
+};
+
+struct pi_segment {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t data_size;                // sizeof(struct pi_data) des Schreibers
+    int32_t writer_pid;
+    char pad1[48];
+    _Atomic uint64_t seq;              // eigene Cache-Line: nur der Schreiber ändert sie
+    char pad2[56];
+    struct pi_data data[2] __attribute__((aligned(64)));
+};
+
+struct process_image {
+    struct pi_segment *seg;
+    int writable;
+};
+
+// Schreiber: Segment anlegen, initialisieren und per mlock sperren (Fehler dabei nur als
+// Hinweis). NULL bei Fehler
+struct process_image *pi_create(const char *name);
+
+// Leser: vorhandenes Segment nur lesend einblenden. NULL bei Fehler (errno gesetzt,
+// EPROTO bei fremdem Layout)
+struct process_image *pi_open(const char *name);
+
+// Schreiber entfernt mit unlink != 0 zusätzlich den Namen
+void pi_close(struct process_image *pi, const char *name, int unlink);
+
+// Einmal pro Zyklus: wartet nie, keine Systemaufrufe
+void pi_publish(struct process_image *pi, const struct pi_data *data);
+
+// Konsistente Momentaufnahme; liefert die Zahl der Wiederholversuche (meist 0)
+unsigned int pi_snapshot(const struct process_image *pi, struct pi_data *out);
+
+// PID des Schreibers und ob er noch läuft
+pid_t pi_writer_pid(const struct process_image *pi);
+int pi_writer_alive(const struct process_image *pi);
+
+#endif
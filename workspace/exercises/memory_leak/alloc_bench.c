@@ -0,0 +1,129 @@
+/*
+Allokationslastiger Mikrobenchmark für den Overhead von alloc_profiler.so
+
+Jeder Thread hält einen Arbeitsbestand von Blöcken und ersetzt zufällig gewählte Blöcke durch
+neue mit log-verteilter Größe (16 Bytes bis 8 KiB, gelegentlich realloc/calloc). Ein kleiner
+Anteil wird absichtlich nie freigegeben, damit der Profiler ein Leck findet.
+Ausgabe: CPU-Zeit in Nanosekunden pro Operation (eine Operation = free + malloc/calloc/realloc).
+Gemessen wird die CPU-Zeit des Prozesses statt der Wanduhr, damit Verdrängung durch andere
+Prozesse und mehr Threads als CPUs das Ergebnis nicht verfälschen.
+
+Verwendung: ./alloc_bench [-n operationen_pro_thread] [-w arbeitsbestand] [-t threads] [-l leck_jede_n]
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+struct bench_params {
+    long ops;
+    int working_set;
+    long leak_every;         // 0 = kein Leck
+    unsigned int seed;
+};
+
+static double now_s(clockid_t clock) {
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint64_t next_random(uint64_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+static void *volatile last_leak; // sonst darf der Compiler das ungenutzte malloc entfernen
+
+// Eigene Funktion, damit das Leck im Profil eine eigene Aufrufstelle hat
+__attribute__((noinline))
+static void leaky_allocation(size_t size) {
+    last_leak = malloc(size);
+}
+
+static void *bench_thread(void *arg) {
+    const struct bench_params *params = arg;
+    void **slots = calloc((size_t)params->working_set, sizeof(void *));
+    uint64_t rng = 0x9e3779b97f4a7c15ULL ^ params->seed;
+    if (slots == NULL) {
+        return NULL;
+    }
+    for (long i = 0; i < params->ops; ++i) {
+        uint64_t r = next_random(&rng);
+        int slot = (int)(r % (uint64_t)params->working_set);
+        size_t size = (size_t)16 << ((r >> 32) % 10); // 16 B ... 8 KiB
+        size += (r >> 48) % size;
+        switch ((r >> 40) % 8) {
+        case 0:
+            slots[slot] = realloc(slots[slot], size);
+            break;
+        case 1:
+            free(slots[slot]);
+            slots[slot] = calloc(1, size);
+            break;
+        default:
+            free(slots[slot]);
+            slots[slot] = malloc(size);
+            break;
+        }
+        if (slots[slot] != NULL) {
+            ((char *)slots[slot])[0] = (char)i;
+        }
+        if (params->leak_every > 0 && i % params->leak_every == 0) {
+            leaky_allocation(size);
+        }
+    }
+    for (int i = 0; i < params->working_set; ++i) {
+        free(slots[i]);
+    }
+    free(slots);
+    return NULL;
+}
+
+int main(int argc, char *argv[]) {
+    struct bench_params params = { .ops = 5000000, .working_set = 4096, .leak_every = 10000, .seed = 1 };
+    int threads = 1;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:w:t:l:h")) != -1) {
+        switch (opt) {
+        case 'n': params.ops = atol(optarg); break;
+        case 'w': params.working_set = atoi(optarg); break;
+        case 't': threads = atoi(optarg); break;
+        case 'l': params.leak_every = atol(optarg); break;
+        default:
+            fprintf(stderr, "Verwendung: %s [-n operationen_pro_thread] [-w arbeitsbestand] [-t threads] [-l leck_jede_n]\n", argv[0]);
+            return opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if (params.ops <= 0 || params.working_set <= 0 || threads <= 0 || threads > 256) {
+        fprintf(stderr, "Ungültige Parameter\n");
+        return EXIT_FAILURE;
+    }
+
+    pthread_t tids[256];
+    struct bench_params per_thread[256];
+    double start = now_s(CLOCK_MONOTONIC);
+    double start_cpu = now_s(CLOCK_PROCESS_CPUTIME_ID);
+    for (int t = 0; t < threads; ++t) {
+        per_thread[t] = params;
+        per_thread[t].seed = params.seed + (unsigned int)t;
+        pthread_create(&tids[t], NULL, bench_thread, &per_thread[t]);
+    }
+    for (int t = 0; t < threads; ++t) {
+        pthread_join(tids[t], NULL);
+    }
+    double cpu = now_s(CLOCK_PROCESS_CPUTIME_ID) - start_cpu;
+    double elapsed = now_s(CLOCK_MONOTONIC) - start;
+    printf("%.1f ns/op (%ld Operationen, %d Threads, %.3f s, CPU %.3f s)\n",
+           cpu * 1e9 / ((double)params.ops * threads),
+           params.ops * threads, threads, elapsed, cpu);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,535 @@
+/*
+Stichprobenbasierter Allokations-Profiler (LD_PRELOAD)
+
+Ersetzt malloc/calloc/realloc/free und fasst lebende Bytes und Aufrufzahlen pro Aufrufstelle
+zusammen. Eine Aufrufstelle ist der Hash eines Backtraces über die Frame-Pointer-Kette
+(Programm mit -fno-omit-frame-pointer übersetzen, sonst bleibt nur die direkte Aufrufstelle).
+
+Damit der Overhead klein bleibt, wird nicht jede Allokation erfasst: Jeder Thread zählt die
+angeforderten Bytes herunter und nimmt erst nach im Mittel ALLOC_PROF_SAMPLE Bytes eine
+Stichprobe (zufälliger Abstand, damit periodische Muster nicht immer gleich getroffen werden).
+Eine Stichprobe der Größe s steht für max(s, ALLOC_PROF_SAMPLE) Bytes, so bleibt die
+Hochrechnung erwartungstreu. Der schnelle Pfad ist eine Subtraktion und ein Vergleich auf
+einer Thread-lokalen Variable plus der Sprung zur glibc; der Rekursionsschutz steckt im
+Zähler selbst (im Profiler steht er auf COUNTDOWN_BLOCKED), damit er nichts extra kostet.
+Bei welchem Abstand gemessen wird, ändert am Overhead kaum etwas; er entsteht fast nur durch
+die zusätzliche Aufrufebene.
+
+Stichproben bekommen einen 32-Byte-Kopf vor dem Nutzzeiger (Aufrufstelle, Gewicht, Magic).
+free erkennt sie am Wort direkt vor dem Zeiger: Bei normalen Blöcken liegt dort das
+Größenfeld des glibc-Chunks, das den Magic-Wert nie annehmen kann (Bit 63 gesetzt). Es ist
+also keine Suche in einer Tabelle nötig, und die Cache-Line liest glibc ohnehin.
+
+Beim Programmende und beim Signal ALLOC_PROF_SIGNAL werden die ausstehenden Allokationen nach
+Größe sortiert ausgegeben. Die Ausgabe im Signal-Handler nutzt nur write() und eigene
+Formatierung (async-signal-safe) und zeigt rohe Adressen; am Programmende werden sie per dladdr
+aufgelöst. Rohe Adressen lassen sich mit addr2line -f -e <programm> <adresse - basis> auflösen.
+
+Umgebungsvariablen:
+  ALLOC_PROF_SAMPLE  mittlerer Abstand zwischen Stichproben in Bytes (Standard: 524288,
+                     0 oder 1 = jede Allokation erfassen)
+  ALLOC_PROF_OUT     Ausgabedatei (angehängt; Standard: stderr)
+  ALLOC_PROF_SIGNAL  Signalnummer für eine Zwischenausgabe (Standard: SIGUSR2, 0 = aus)
+  ALLOC_PROF_TOP     Anzahl ausgegebener Aufrufstellen (Standard: 20)
+
+Nutzt die glibc-Einstiegspunkte __libc_malloc & Co., damit kein dlsym-Bootstrap nötig ist.
+
+Kompilieren: gcc -O2 -fno-omit-frame-pointer -fno-plt -shared -fPIC -pthread -o alloc_profiler.so alloc_profiler.c -ldl
+Verwendung:  LD_PRELOAD=./alloc_profiler.so ALLOC_PROF_SAMPLE=1 ./memory_leak
+*/
+
+#define _GNU_SOURCE
+
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define MAX_FRAMES 8
+#define MAX_SITES 4096                 // Zweierpotenz
+#define DEFAULT_SAMPLE 524288
+#define DEFAULT_TOP 20
+#define SAMPLE_MAGIC 0xa110c5a3d1e5a3d1ULL
+#define COUNTDOWN_BLOCKED (LONG_MAX / 2)  // im Profiler: keine Stichprobe, auch nach vielen Allokationen
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void __libc_free(void *ptr);
+
+// Aufrufstelle: Schlüssel ist der Backtrace-Hash, Zähler sind hochgerechnet
+struct alloc_site {
+    _Atomic uint64_t hash;             // 0 = frei
+    _Atomic int ready;                 // frames gültig
+    int depth;
+    uintptr_t frames[MAX_FRAMES];
+    _Atomic int64_t live_bytes;
+    _Atomic int64_t live_allocs;
+    _Atomic uint64_t total_bytes;
+    _Atomic uint64_t total_allocs;
+};
+
+// Kopf vor jeder Stichprobe; magic liegt direkt vor dem Nutzzeiger (16-Byte-Ausrichtung bleibt)
+struct sample_header {
+    uint64_t weight_bytes;
+    uint32_t site;
+    uint32_t weight_allocs;
+    uint64_t size;                     // angeforderte Größe, für realloc
+    uint64_t magic;
+};
+
+static struct alloc_site sites[MAX_SITES];
+static _Atomic uint64_t sampled_total; // Anzahl der Stichproben seit Programmstart
+static long sample_bytes = DEFAULT_SAMPLE;
+static int top_sites = DEFAULT_TOP;
+static const char *out_path;
+static size_t (*real_usable_size)(void *);  // glibc exportiert dafür keinen __libc_-Namen
+
+// initial-exec: kein __tls_get_addr (und damit kein malloc) beim ersten Zugriff
+#define TLS static __thread __attribute__((tls_model("initial-exec")))
+TLS long countdown;                    // Bytes bis zur nächsten Stichprobe; COUNTDOWN_BLOCKED im Profiler
+                                       // (Rekursionsschutz für pthread_getattr_np, dladdr, ...)
+TLS uint64_t rng_state;
+TLS uintptr_t stack_hi;                // obere Grenze des Thread-Stacks für die Frame-Kette
+
+static uint64_t mix64(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+// Gleichverteilt in [1, 2 * sample_bytes): Mittelwert sample_bytes
+static long next_countdown(void) {
+    if (sample_bytes <= 1) {
+        return 0;
+    }
+    if (rng_state == 0) {
+        rng_state = mix64((uint64_t)(uintptr_t)&rng_state ^ (uint64_t)getpid());
+    }
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return 1 + (long)(rng_state % (uint64_t)(2 * sample_bytes));
+}
+
+static void init_stack_bounds(void) {
+    pthread_attr_t attr;
+    void *addr;
+    size_t size;
+    if (pthread_getattr_np(pthread_self(), &attr) == 0) {
+        if (pthread_attr_getstack(&attr, &addr, &size) == 0) {
+            stack_hi = (uintptr_t)addr + size;
+        }
+        pthread_attr_destroy(&attr);
+    }
+    if (stack_hi == 0) {
+        stack_hi = (uintptr_t)__builtin_frame_address(0) + 65536; // Notlösung: nur nahe Frames
+    }
+}
+
+// Frame-Pointer-Kette ablaufen; jeder Zeiger wird gegen die Stack-Grenzen geprüft
+__attribute__((noinline))
+static int capture_backtrace(uintptr_t *frames) {
+    uintptr_t *fp = __builtin_frame_address(0);
+    uintptr_t lo = (uintptr_t)fp;
+    int depth = 0;
+    int skip = 2; // Rücksprünge in sample_alloc und in malloc/calloc/realloc
+    while (depth < MAX_FRAMES) {
+        uintptr_t addr = (uintptr_t)fp;
+        if (addr < lo || addr + 2 * sizeof(uintptr_t) > stack_hi || (addr & (sizeof(uintptr_t) - 1)) != 0) {
+            break;
+        }
+        uintptr_t ret = fp[1];
+        if (ret < 4096) {
+            break;
+        }
+        if (skip > 0) {
+            skip--;
+        } else {
+            frames[depth++] = ret;
+        }
+        uintptr_t *next = (uintptr_t *)fp[0];
+        if (next <= fp) {
+            break;
+        }
+        fp = next;
+    }
+    return depth;
+}
+
+static uint32_t site_lookup(const uintptr_t *frames, int depth) {
+    uint64_t hash = 0x9e3779b97f4a7c15ULL;
+    for (int i = 0; i < depth; ++i) {
+        hash = mix64(hash ^ frames[i]);
+    }
+    if (hash == 0) {
+        hash = 1;
+    }
+    uint32_t idx = (uint32_t)hash & (MAX_SITES - 1);
+    for (int probe = 0; probe < MAX_SITES; ++probe, idx = (idx + 1) & (MAX_SITES - 1)) {
+        struct alloc_site *site = &sites[idx];
+        uint64_t cur = atomic_load_explicit(&site->hash, memory_order_acquire);
+        if (cur == hash) {
+            return idx;
+        }
+        if (cur == 0) {
+            uint64_t expected = 0;
+            if (atomic_compare_exchange_strong(&site->hash, &expected, hash)) {
+                site->depth = depth;
+                memcpy(site->frames, frames, (size_t)depth * sizeof(uintptr_t));
+                atomic_store_explicit(&site->ready, 1, memory_order_release);
+                return idx;
+            }
+            if (expected == hash) {
+                return idx;
+            }
+        }
+    }
+    return 0; // Tabelle voll: alles Weitere landet in der ersten Aufrufstelle
+}
+
+static struct sample_header *sample_header_of(void *ptr) {
+    return (struct sample_header *)ptr - 1;
+}
+
+static int is_sampled(void *ptr) {
+    return ptr != NULL && ((const uint64_t *)ptr)[-1] == SAMPLE_MAGIC;
+}
+
+// Langsamer Pfad: Block mit Kopf anlegen, Backtrace aufnehmen, Aufrufstelle fortschreiben
+__attribute__((noinline))
+static void *sample_alloc(size_t size, int zero) {
+    if (size > SIZE_MAX - sizeof(struct sample_header)) {
+        return NULL;
+    }
+    size_t total = size + sizeof(struct sample_header);
+    struct sample_header *hdr = zero ? __libc_calloc(1, total) : __libc_malloc(total);
+    if (hdr == NULL) {
+        return NULL;
+    }
+    countdown = COUNTDOWN_BLOCKED;
+    if (stack_hi == 0) {
+        init_stack_bounds();
+    }
+    uintptr_t frames[MAX_FRAMES];
+    int depth = capture_backtrace(frames);
+    uint32_t site = site_lookup(frames, depth);
+
+    uint64_t weight_bytes = size;
+    uint32_t weight_allocs = 1;
+    if (sample_bytes > 1 && size < (size_t)sample_bytes) {
+        weight_bytes = (uint64_t)sample_bytes;
+        weight_allocs = (uint32_t)((sample_bytes + (long)size - 1) / (long)(size ? size : 1));
+    }
+    struct alloc_site *s = &sites[site];
+    atomic_fetch_add_explicit(&s->total_bytes, weight_bytes, memory_order_relaxed);
+    atomic_fetch_add_explicit(&s->total_allocs, weight_allocs, memory_order_relaxed);
+    atomic_fetch_add_explicit(&s->live_bytes, (int64_t)weight_bytes, memory_order_relaxed);
+    atomic_fetch_add_explicit(&s->live_allocs, weight_allocs, memory_order_relaxed);
+    atomic_fetch_add_explicit(&sampled_total, 1, memory_order_relaxed);
+
+    hdr->weight_bytes = weight_bytes;
+    hdr->site = site;
+    hdr->weight_allocs = weight_allocs;
+    hdr->size = size;
+    hdr->magic = SAMPLE_MAGIC;
+    countdown = next_countdown();
+    return hdr + 1;
+}
+
+static void sample_free(void *ptr) {
+    struct sample_header *hdr = sample_header_of(ptr);
+    struct alloc_site *s = &sites[hdr->site];
+    atomic_fetch_sub_explicit(&s->live_bytes, (int64_t)hdr->weight_bytes, memory_order_relaxed);
+    atomic_fetch_sub_explicit(&s->live_allocs, hdr->weight_allocs, memory_order_relaxed);
+    hdr->magic = 0;
+    __libc_free(hdr);
+}
+
+// Zählt die Bytes herunter; 1 = diese Allokation wird Stichprobe
+static inline int take_sample(size_t size) {
+    countdown -= (long)size;
+    return __builtin_expect(countdown <= 0, 0);
+}
+
+void *malloc(size_t size) {
+    if (take_sample(size)) {
+        void *ptr = sample_alloc(size, 0);
+        __asm__ volatile("" ::: "memory"); // kein Tail-Call: eigener Frame für den Backtrace
+        return ptr;
+    }
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t nmemb, size_t size) {
+    size_t total;
+    if (__builtin_mul_overflow(nmemb, size, &total)) {
+        return __libc_calloc(nmemb, size); // liefert NULL und setzt errno
+    }
+    if (take_sample(total)) {
+        void *ptr = sample_alloc(total, 1);
+        __asm__ volatile("" ::: "memory");
+        return ptr;
+    }
+    return __libc_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+    int sampled = is_sampled(ptr);
+    int sample = take_sample(size) && (ptr == NULL || sampled || real_usable_size != NULL);
+    if (!sampled && !sample) {
+        return __libc_realloc(ptr, size);
+    }
+    if (ptr != NULL && size == 0) {
+        free(ptr);
+        return NULL;
+    }
+    // Beteiligung einer Stichprobe: umkopieren statt in place vergrößern
+    void *next = sample ? sample_alloc(size, 0) : __libc_malloc(size);
+    if (next == NULL || ptr == NULL) {
+        return next;
+    }
+    size_t old = sampled ? sample_header_of(ptr)->size : real_usable_size(ptr);
+    memcpy(next, ptr, old < size ? old : size);
+    free(ptr);
+    return next;
+}
+
+void free(void *ptr) {
+    if (__builtin_expect(is_sampled(ptr), 0)) {
+        sample_free(ptr);
+        return;
+    }
+    __libc_free(ptr);
+}
+
+size_t malloc_usable_size(void *ptr) {
+    if (is_sampled(ptr)) {
+        return sample_header_of(ptr)->size;
+    }
+    return real_usable_size(ptr);
+}
+
+// ---- Ausgabe (async-signal-safe: nur write und eigene Formatierung) ----
+
+struct out_buf {
+    int fd;
+    size_t len;
+    char data[4096];
+};
+
+static void out_flush(struct out_buf *b) {
+    size_t off = 0;
+    while (off < b->len) {
+        ssize_t n = write(b->fd, b->data + off, b->len - off);
+        if (n <= 0) {
+            break;
+        }
+        off += (size_t)n;
+    }
+    b->len = 0;
+}
+
+static void out_str(struct out_buf *b, const char *s) {
+    while (*s) {
+        if (b->len == sizeof(b->data)) {
+            out_flush(b);
+        }
+        b->data[b->len++] = *s++;
+    }
+}
+
+static void out_u64(struct out_buf *b, uint64_t v, int width) {
+    char tmp[24];
+    int n = 0;
+    do {
+        tmp[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v != 0);
+    char s[48];
+    int pos = 0;
+    for (int pad = width - n; pad > 0; --pad) {
+        s[pos++] = ' ';
+    }
+    while (n > 0) {
+        s[pos++] = tmp[--n];
+    }
+    s[pos] = '\0';
+    out_str(b, s);
+}
+
+static void out_i64(struct out_buf *b, int64_t v, int width) {
+    if (v < 0) {
+        out_str(b, "-");
+        out_u64(b, (uint64_t)-v, width > 0 ? width - 1 : 0);
+    } else {
+        out_u64(b, (uint64_t)v, width);
+    }
+}
+
+static void out_hex(struct out_buf *b, uintptr_t v) {
+    char s[2 + 2 * sizeof(uintptr_t) + 1];
+    int n = 0;
+    char tmp[2 * sizeof(uintptr_t)];
+    do {
+        tmp[n++] = "0123456789abcdef"[v & 0xf];
+        v >>= 4;
+    } while (v != 0);
+    int pos = 0;
+    s[pos++] = '0';
+    s[pos++] = 'x';
+    while (n > 0) {
+        s[pos++] = tmp[--n];
+    }
+    s[pos] = '\0';
+    out_str(b, s);
+}
+
+static void dump(int symbolize, const char *reason) {
+    static uint32_t order[MAX_SITES];
+    static _Atomic int dumping;
+    if (atomic_exchange(&dumping, 1)) {
+        return;
+    }
+    long saved = countdown;
+    countdown = COUNTDOWN_BLOCKED;
+
+    struct out_buf b;
+    b.len = 0;
+    b.fd = out_path ? open(out_path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644) : -1;
+    if (b.fd == -1) {
+        b.fd = STDERR_FILENO;
+    }
+
+    // Aktive Aufrufstellen nach lebenden Bytes absteigend sortieren (Shellsort, ohne malloc)
+    int count = 0;
+    int64_t total_live = 0;
+    int64_t total_allocs = 0;
+    for (uint32_t i = 0; i < MAX_SITES; ++i) {
+        if (!atomic_load_explicit(&sites[i].ready, memory_order_acquire)) {
+            continue;
+        }
+        int64_t live = atomic_load_explicit(&sites[i].live_bytes, memory_order_relaxed);
+        if (live > 0) {
+            order[count++] = i;
+            total_live += live;
+            total_allocs += atomic_load_explicit(&sites[i].live_allocs, memory_order_relaxed);
+        }
+    }
+    for (int gap = count / 2; gap > 0; gap /= 2) {
+        for (int i = gap; i < count; ++i) {
+            uint32_t tmp = order[i];
+            int64_t key = sites[tmp].live_bytes;
+            int j = i;
+            while (j >= gap && sites[order[j - gap]].live_bytes < key) {
+                order[j] = order[j - gap];
+                j -= gap;
+            }
+            order[j] = tmp;
+        }
+    }
+
+    out_str(&b, "=== alloc_profiler: ausstehende Allokationen (");
+    out_str(&b, reason);
+    out_str(&b, ", PID ");
+    out_u64(&b, (uint64_t)getpid(), 0);
+    out_str(&b, ", Stichprobe alle ~");
+    out_u64(&b, sample_bytes > 1 ? (uint64_t)sample_bytes : 1, 0);
+    out_str(&b, " Bytes) ===\n");
+    out_str(&b, "lebend (hochgerechnet): ");
+    out_i64(&b, total_live, 0);
+    out_str(&b, " Bytes in ");
+    out_i64(&b, total_allocs, 0);
+    out_str(&b, " Allokationen an ");
+    out_u64(&b, (uint64_t)count, 0);
+    out_str(&b, " Aufrufstellen, Stichproben gesamt: ");
+    out_u64(&b, atomic_load(&sampled_total), 0);
+    out_str(&b, "\n");
+
+    for (int i = 0; i < count && i < top_sites; ++i) {
+        struct alloc_site *s = &sites[order[i]];
+        out_str(&b, "#");
+        out_u64(&b, (uint64_t)i + 1, 0);
+        out_str(&b, " ");
+        out_i64(&b, s->live_bytes, 12);
+        out_str(&b, " Bytes ");
+        out_i64(&b, s->live_allocs, 8);
+        out_str(&b, " Allok.   gesamt ");
+        out_u64(&b, s->total_bytes, 0);
+        out_str(&b, " Bytes in ");
+        out_u64(&b, s->total_allocs, 0);
+        out_str(&b, " Aufrufen\n");
+        for (int f = 0; f < s->depth; ++f) {
+            out_str(&b, "      ");
+            out_hex(&b, s->frames[f]);
+            Dl_info info;
+            if (symbolize && dladdr((void *)(s->frames[f] - 1), &info) != 0 && info.dli_fname != NULL) {
+                out_str(&b, " ");
+                out_str(&b, info.dli_sname ? info.dli_sname : "??");
+                out_str(&b, "+");
+                out_hex(&b, s->frames[f] - (info.dli_saddr ? (uintptr_t)info.dli_saddr : (uintptr_t)info.dli_fbase));
+                out_str(&b, " (");
+                out_str(&b, info.dli_fname);
+                out_str(&b, " +");
+                out_hex(&b, s->frames[f] - (uintptr_t)info.dli_fbase);
+                out_str(&b, ")");
+            }
+            out_str(&b, "\n");
+        }
+    }
+    out_flush(&b);
+    if (b.fd != STDERR_FILENO) {
+        close(b.fd);
+    }
+    countdown = saved;
+    atomic_store(&dumping, 0);
+}
+
+static void handle_dump_signal(int sig) {
+    (void)sig;
+    dump(0, "Signal");
+}
+
+__attribute__((constructor))
+static void alloc_profiler_init(void) {
+    countdown = COUNTDOWN_BLOCKED;
+    const char *value = getenv("ALLOC_PROF_SAMPLE");
+    if (value != NULL) {
+        sample_bytes = atol(value);
+    }
+    value = getenv("ALLOC_PROF_TOP");
+    if (value != NULL && atoi(value) > 0) {
+        top_sites = atoi(value);
+    }
+    out_path = getenv("ALLOC_PROF_OUT");
+    real_usable_size = (size_t (*)(void *))dlsym(RTLD_NEXT, "malloc_usable_size");
+
+    int sig = SIGUSR2;
+    value = getenv("ALLOC_PROF_SIGNAL");
+    if (value != NULL) {
+        sig = atoi(value);
+    }
+    if (sig > 0) {
+        struct sigaction sa;
+        memset(&sa, 0, sizeof(sa));
+        sa.sa_handler = handle_dump_signal;
+        sa.sa_flags = SA_RESTART;
+        sigemptyset(&sa.sa_mask);
+        sigaction(sig, &sa, NULL);
+    }
+    countdown = next_countdown();
+}
+
+__attribute__((destructor))
+static void alloc_profiler_fini(void) {
+    dump(1, "Programmende");
+}
@@ -0,0 +1,52 @@
+#!/bin/bash
+
+# Misst den Overhead von alloc_profiler.so auf dem Mikrobenchmark alloc_bench
+# Usage: ./bench_profiler.sh [wiederholungen] [threads]
+#
+# Vergleicht den Lauf ohne Profiler mit verschiedenen Stichprobenabständen (ALLOC_PROF_SAMPLE).
+# Jede Wiederholung misst alle Aufbauten direkt nacheinander; der Overhead ist der Median der
+# Verhältnisse innerhalb einer Wiederholung, damit Schwankungen der Maschine (andere Last,
+# Taktfrequenz) zwischen den Wiederholungen herausfallen. ns/op ist der Median über alle Läufe.
+
+RUNS="${1:-9}"
+THREADS="${2:-1}"
+BENCH=./alloc_bench
+PROFILER=./alloc_profiler.so
+SAMPLES="524288 65536 4096 1"
+
+if [ ! -x "$BENCH" ] || [ ! -f "$PROFILER" ]; then
+    echo "Bitte zuerst 'make' ausführen."
+    exit 1
+fi
+
+# ns/op eines Laufs; Profil-Ausgabe nach /dev/null
+run_ns() {
+    env "$@" "$BENCH" -t "$THREADS" 2>/dev/null | awk '{print $1}'
+}
+
+median() {
+    sort -n | awk '{v[NR] = $1} END {print v[int((NR + 1) / 2)]}'
+}
+
+declare -A NS RATIO
+for ((i = 0; i < RUNS; i++)); do
+    base=$(run_ns)
+    NS[base]+="$base "
+    for SAMPLE in $SAMPLES; do
+        ns=$(run_ns LD_PRELOAD="$PROFILER" ALLOC_PROF_SAMPLE="$SAMPLE" ALLOC_PROF_OUT=/dev/null)
+        NS[$SAMPLE]+="$ns "
+        RATIO[$SAMPLE]+="$(echo "$ns $base" | awk '{print ($1 / $2 - 1) * 100}') "
+    done
+done
+
+printf "%-24s %10s %10s\n" "Aufbau" "ns/op" "Overhead"
+printf "%-24s %10s %10s\n" "ohne Profiler" "$(echo ${NS[base]} | tr ' ' '\n' | median)" "-"
+for SAMPLE in $SAMPLES; do
+    printf "%-24s %10s %9.1f%%\n" "Stichprobe $SAMPLE B" "$(echo ${NS[$SAMPLE]} | tr ' ' '\n' | median)" \
+        "$(echo ${RATIO[$SAMPLE]} | tr ' ' '\n' | median)"
+done
+
+# Plausibilität: das absichtliche Leck muss die größte Aufrufstelle sein
+echo
+echo "Profil (Stichprobe 65536 B, Top 3):"
+LD_PRELOAD="$PROFILER" ALLOC_PROF_SAMPLE=65536 ALLOC_PROF_TOP=3 "$BENCH" -n 1000000 -l 1000 -t "$THREADS" 2>&1 >/dev/null
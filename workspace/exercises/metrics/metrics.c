@@ -0,0 +1,317 @@
+#define _GNU_SOURCE // getpid, kill, clock_gettime
+
+#include "metrics.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+_Static_assert(sizeof(struct metrics_slot) % 64 == 0, "Slot muss ganze Cache-Lines belegen");
+
+static struct metrics_segment *segment;
+static char shm_name[64];
+static pthread_mutex_t register_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t next_offset;                    // nächster freier Wert in den Slots
+
+// Slot des aktuellen Threads; shared = 1 für den gemeinsamen Überlauf-Slot
+static __thread struct metrics_slot *thread_slot;
+static __thread int thread_slot_shared;
+
+// Belegte eigene Slots (Bitmaske). Endet ein Thread, gibt der Destruktor seinen Slot frei; der
+// nächste Thread zählt darin einfach weiter, die Summe bleibt dadurch korrekt
+static _Atomic uint32_t slots_in_use;
+static pthread_key_t slot_key;
+static pthread_once_t slot_key_once = PTHREAD_ONCE_INIT;
+
+_Static_assert(METRICS_MAX_SLOTS <= 32, "Bitmaske der Slots hat 32 Bit");
+
+static uint64_t double_bits(double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static double bits_double(uint64_t bits) {
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Segmente früherer, abgebrochener Läufe desselben Programms entfernen (z.B. nach SIGKILL)
+static void remove_stale(const char *clean) {
+    char prefix[64];
+    int len = snprintf(prefix, sizeof(prefix), METRICS_SHM_PREFIX "%s.", clean);
+    DIR *dir = opendir("/dev/shm");
+    if (dir == NULL) {
+        return;
+    }
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (strncmp(entry->d_name, prefix, (size_t)len) != 0) {
+            continue;
+        }
+        char *end;
+        long pid = strtol(entry->d_name + len, &end, 10);
+        if (*end == '\0' && pid > 0 && kill((pid_t)pid, 0) != 0 && errno == ESRCH) {
+            char name[300];
+            snprintf(name, sizeof(name), "/%s", entry->d_name);
+            shm_unlink(name);
+        }
+    }
+    closedir(dir);
+}
+
+int metrics_init(const char *program) {
+    if (segment != NULL) {
+        return 0;
+    }
+    // Nur [A-Za-z0-9_] im Namen, damit der Kollektor Programm und PID sicher trennen kann
+    char clean[METRICS_PROGRAM_LEN];
+    size_t len = 0;
+    for (; program[len] != '\0' && len < sizeof(clean) - 1; ++len) {
+        char c = program[len];
+        int ok = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+        clean[len] = ok ? c : '_';
+    }
+    clean[len] = '\0';
+    remove_stale(clean);
+    snprintf(shm_name, sizeof(shm_name), "/" METRICS_SHM_PREFIX "%s.%d", clean, (int)getpid());
+
+    int fd = shm_open(shm_name, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1) {
+        return -1;
+    }
+    if (ftruncate(fd, sizeof(struct metrics_segment)) != 0) {
+        int err = errno;
+        close(fd);
+        shm_unlink(shm_name);
+        errno = err;
+        return -1;
+    }
+    void *map = mmap(NULL, sizeof(struct metrics_segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        int err = errno;
+        shm_unlink(shm_name);
+        errno = err;
+        return -1;
+    }
+    struct metrics_segment *seg = map;
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    seg->version = METRICS_VERSION;
+    seg->pid = getpid();
+    seg->slot_values = METRICS_SLOT_VALUES;
+    memcpy(seg->program, clean, len + 1);
+    seg->start_time_ns = (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+    // Seitenfehler beim ersten Zugriff aus einer RT-Schleife vermeiden (Fehler nur Nachteil)
+    mlock(seg, sizeof(*seg));
+    __atomic_store_n(&seg->magic, METRICS_MAGIC, __ATOMIC_RELEASE);
+    segment = seg;
+    return 0;
+}
+
+void metrics_shutdown(void) {
+    if (segment == NULL) {
+        return;
+    }
+    shm_unlink(shm_name);
+    munmap(segment, sizeof(*segment));
+    segment = NULL;
+    next_offset = 0;
+}
+
+static struct metric *register_metric(const char *name, const char *labels, const char *help, uint32_t type,
+                                      const double *bounds, unsigned int num_bounds) {
+    if (segment == NULL || name == NULL) {
+        return NULL;
+    }
+    if (labels != NULL && strlen(labels) >= METRICS_LABELS_LEN) {
+        return NULL; // abgeschnittene Labels wären ungültig
+    }
+    uint32_t values = type == METRICS_HISTOGRAM ? num_bounds + 2 : type == METRICS_COUNTER ? 1 : 0;
+    struct metric *m = NULL;
+
+    pthread_mutex_lock(&register_lock);
+    uint32_t index = atomic_load_explicit(&segment->num_metrics, memory_order_relaxed);
+    if (index < METRICS_MAX && next_offset + values <= METRICS_SLOT_VALUES) {
+        m = &segment->metrics[index];
+        snprintf(m->name, sizeof(m->name), "%s", name);
+        snprintf(m->help, sizeof(m->help), "%s", help != NULL ? help : "");
+        snprintf(m->labels, sizeof(m->labels), "%s", labels != NULL ? labels : "");
+        m->type = type;
+        m->num_buckets = type == METRICS_HISTOGRAM ? num_bounds : 0;
+        m->offset = type == METRICS_GAUGE ? index : next_offset;
+        for (unsigned int i = 0; i < m->num_buckets; ++i) {
+            m->bounds[i] = bounds[i];
+        }
+        next_offset += values;
+        // Kollektor sieht die Kennzahl erst, wenn die Beschreibung vollständig ist
+        atomic_store_explicit(&segment->num_metrics, index + 1, memory_order_release);
+    }
+    pthread_mutex_unlock(&register_lock);
+    return m;
+}
+
+struct metric *metrics_counter(const char *name, const char *help) {
+    return metrics_counter_labeled(name, NULL, help);
+}
+
+struct metric *metrics_gauge(const char *name, const char *help) {
+    return metrics_gauge_labeled(name, NULL, help);
+}
+
+struct metric *metrics_histogram(const char *name, const char *help, const double *bounds, unsigned int num_bounds) {
+    return metrics_histogram_labeled(name, NULL, help, bounds, num_bounds);
+}
+
+struct metric *metrics_counter_labeled(const char *name, const char *labels, const char *help) {
+    return register_metric(name, labels, help, METRICS_COUNTER, NULL, 0);
+}
+
+struct metric *metrics_gauge_labeled(const char *name, const char *labels, const char *help) {
+    return register_metric(name, labels, help, METRICS_GAUGE, NULL, 0);
+}
+
+struct metric *metrics_histogram_labeled(const char *name, const char *labels, const char *help,
+                                         const double *bounds, unsigned int num_bounds) {
+    if (num_bounds == 0 || num_bounds > METRICS_MAX_BUCKETS) {
+        return NULL;
+    }
+    for (unsigned int i = 1; i < num_bounds; ++i) {
+        if (!(bounds[i] > bounds[i - 1])) {
+            return NULL;
+        }
+    }
+    return register_metric(name, labels, help, METRICS_HISTOGRAM, bounds, num_bounds);
+}
+
+static void release_slot(void *value) {
+    uint32_t n = (uint32_t)(uintptr_t)value - 1;
+    // release: die letzten Werte dieses Threads sind sichtbar, bevor ein anderer den Slot belegt
+    atomic_fetch_and_explicit(&slots_in_use, ~(1U << n), memory_order_release);
+}
+
+static void create_slot_key(void) {
+    pthread_key_create(&slot_key, release_slot);
+}
+
+// Slot beim ersten Zugriff des Threads belegen; selten, daher nicht inline
+static __attribute__((noinline)) struct metrics_slot *claim_slot(void) {
+    uint32_t mask = atomic_load_explicit(&slots_in_use, memory_order_acquire);
+    uint32_t n;
+    do {
+        for (n = 0; n < METRICS_MAX_SLOTS - 1 && (mask & (1U << n)); ++n) {
+        }
+    } while (n < METRICS_MAX_SLOTS - 1 &&
+             !atomic_compare_exchange_weak_explicit(&slots_in_use, &mask, mask | (1U << n), memory_order_acq_rel,
+                                                    memory_order_acquire));
+
+    if (n < METRICS_MAX_SLOTS - 1) {
+        pthread_once(&slot_key_once, create_slot_key);
+        pthread_setspecific(slot_key, (void *)(uintptr_t)(n + 1));
+    } else {
+        // Alle eigenen Slots vergeben: den geteilten letzten Slot verwenden
+        thread_slot_shared = 1;
+    }
+    // Kollektor liest die Slots 0 .. num_slots - 1
+    uint32_t used = atomic_load_explicit(&segment->num_slots, memory_order_relaxed);
+    while (used < n + 1 &&
+           !atomic_compare_exchange_weak_explicit(&segment->num_slots, &used, n + 1, memory_order_relaxed,
+                                                  memory_order_relaxed)) {
+    }
+    thread_slot = &segment->slots[n];
+    return thread_slot;
+}
+
+static inline struct metrics_slot *get_slot(void) {
+    struct metrics_slot *slot = thread_slot;
+    return slot != NULL ? slot : claim_slot();
+}
+
+// Eigener Slot: nur dieser Thread schreibt, Laden + Speichern genügt (kein LOCK-Präfix)
+static inline void slot_add(_Atomic uint64_t *value, uint64_t n) {
+    if (thread_slot_shared) {
+        atomic_fetch_add_explicit(value, n, memory_order_relaxed);
+    } else {
+        atomic_store_explicit(value, atomic_load_explicit(value, memory_order_relaxed) + n, memory_order_relaxed);
+    }
+}
+
+static inline void slot_add_double(_Atomic uint64_t *value, double x) {
+    uint64_t old = atomic_load_explicit(value, memory_order_relaxed);
+    if (!thread_slot_shared) {
+        atomic_store_explicit(value, double_bits(bits_double(old) + x), memory_order_relaxed);
+        return;
+    }
+    while (!atomic_compare_exchange_weak_explicit(value, &old, double_bits(bits_double(old) + x),
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+void metrics_add(struct metric *m, uint64_t n) {
+    if (m == NULL) {
+        return;
+    }
+    slot_add(&get_slot()->values[m->offset], n);
+}
+
+void metrics_set(struct metric *m, double value) {
+    if (m == NULL) {
+        return;
+    }
+    atomic_store_explicit(&segment->gauges[m->offset], double_bits(value), memory_order_relaxed);
+}
+
+void metrics_observe(struct metric *m, double value) {
+    if (m == NULL) {
+        return;
+    }
+    // Lineare Suche: bei höchstens 16 Grenzen schneller als binäre Suche mit Sprüngen
+    uint32_t bucket = 0;
+    while (bucket < m->num_buckets && value > m->bounds[bucket]) {
+        bucket++;
+    }
+    struct metrics_slot *slot = get_slot();
+    slot_add(&slot->values[m->offset + bucket], 1);
+    slot_add_double(&slot->values[m->offset + m->num_buckets + 1], value);
+}
+
+const struct metrics_segment *metrics_open(const char *path) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(struct metrics_segment)) {
+        close(fd);
+        errno = EPROTO;
+        return NULL;
+    }
+    void *map = mmap(NULL, sizeof(struct metrics_segment), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return NULL;
+    }
+    const struct metrics_segment *seg = map;
+    if (__atomic_load_n(&seg->magic, __ATOMIC_ACQUIRE) != METRICS_MAGIC || seg->version != METRICS_VERSION ||
+        seg->slot_values != METRICS_SLOT_VALUES) {
+        munmap(map, sizeof(struct metrics_segment));
+        errno = EPROTO;
+        return NULL;
+    }
+    return seg;
+}
+
+void metrics_close(const struct metrics_segment *seg) {
+    munmap((void *)seg, sizeof(*seg));
+}
@@ -0,0 +1,120 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+/*
+Kennzahlen (Zähler, Messwerte, Histogramme) für alle Programme im Workspace.
+
+Jeder Prozess legt mit metrics_init ein eigenes Segment /dev/shm/metrics.<programm>.<pid> an
+und registriert darin beim Start seine Kennzahlen. Aktualisierungen auf dem heißen Pfad sind
+einzelne atomare Zugriffe mit memory_order_relaxed, ohne Sperre und ohne Systemaufruf:
+
+- Zähler und Histogramme sind pro Thread aufgeteilt. Jeder Thread belegt beim ersten Zugriff
+  einen eigenen, auf Cache-Lines ausgerichteten Slot, in den nur er schreibt - Laden und
+  Speichern genügen, es gibt weder LOCK-Präfix noch False Sharing. Endet ein Thread, übernimmt
+  der nächste seinen Slot samt Werten. Sind alle Slots vergeben, teilen sich weitere Threads
+  den letzten Slot über atomare Additionen.
+- Messwerte (Gauges) gibt es nur einmal pro Prozess; metrics_set ist ein atomares Speichern.
+
+Der Kollektor (metrics_collector) findet alle Segmente, summiert die Slots und liefert das
+Ergebnis im Prometheus-Textformat, auf Wunsch über einen lokalen Unix-Socket. Er blendet die
+Segmente nur lesend ein und beeinflusst die Programme nicht.
+
+Gleichartige Größen mehrerer Instanzen (z.B. pro cpufreq-Policy) werden unter einem Namen mit
+festen Labels registriert (metrics_*_labeled, etwa policy="0"), nicht mit der Instanz im Namen:
+so bleiben sie eine Familie, die Prometheus zusammenfassen kann.
+
+Werden metrics_init oder eine Registrierung nicht ausgeführt bzw. schlagen sie fehl, liefern
+die Registrierungsfunktionen NULL; alle Aktualisierungen mit NULL sind wirkungslos. Ein
+Programm läuft also auch ohne /dev/shm unverändert weiter.
+*/
+
+#define METRICS_SHM_PREFIX "metrics."          // Dateiname unter /dev/shm: metrics.<programm>.<pid>
+#define METRICS_MAGIC 0x4352544dU               // "MTRC"
+#define METRICS_VERSION 2
+#define METRICS_MAX 32                          // Kennzahlen pro Prozess
+#define METRICS_MAX_SLOTS 16                    // Thread-Slots; der letzte ist geteilt
+#define METRICS_SLOT_VALUES 248                 // 64-Bit-Werte pro Slot
+#define METRICS_MAX_BUCKETS 16                  // Obergrenzen eines Histogramms (ohne +Inf)
+#define METRICS_NAME_LEN 48
+#define METRICS_HELP_LEN 96
+#define METRICS_LABELS_LEN 32                   // feste Labels, z.B. policy="0"
+#define METRICS_PROGRAM_LEN 32
+#define METRICS_SOCKET "/tmp/workspace_metrics.sock"
+
+enum metrics_type {
+    METRICS_COUNTER = 1,
+    METRICS_GAUGE,
+    METRICS_HISTOGRAM,
+};
+
+// Beschreibung einer Kennzahl; wird bei der Registrierung geschrieben und danach nur gelesen
+struct metric {
+    char name[METRICS_NAME_LEN];
+    char help[METRICS_HELP_LEN];
+    char labels[METRICS_LABELS_LEN];            // leer oder name="wert"[,name="wert"...]
+    uint32_t type;
+    uint32_t num_buckets;
+    uint32_t offset;                            // Zähler/Histogramm: erster Wert im Slot, Gauge: Index
+    uint32_t reserved;
+    double bounds[METRICS_MAX_BUCKETS];         // aufsteigende Obergrenzen (le)
+};
+
+// Slot eines Threads: Zähler = 1 Wert, Histogramm = Buckets + Überlauf (+Inf) + Summe (double)
+struct metrics_slot {
+    _Atomic uint64_t values[METRICS_SLOT_VALUES];
+} __attribute__((aligned(64)));
+
+struct metrics_segment {
+    uint32_t magic;
+    uint32_t version;
+    int32_t pid;
+    uint32_t slot_values;                       // METRICS_SLOT_VALUES des Schreibers
+    char program[METRICS_PROGRAM_LEN];
+    uint64_t start_time_ns;                     // CLOCK_REALTIME beim Anlegen
+    _Atomic uint32_t num_metrics;               // erst nach der Beschreibung erhöht (release)
+    _Atomic uint32_t num_slots;                 // vergebene Thread-Slots
+    char pad[48];
+    struct metric metrics[METRICS_MAX];
+    _Atomic uint64_t gauges[METRICS_MAX] __attribute__((aligned(64))); // double-Bitmuster
+    struct metrics_slot slots[METRICS_MAX_SLOTS];
+};
+
+// Segment für dieses Programm anlegen (einmal pro Prozess, vor dem Start weiterer Threads).
+// 0 bei Erfolg, sonst -1 (errno)
+int metrics_init(const char *program);
+
+// Segment entfernen; danach registrierte Kennzahlen sind ungültig
+void metrics_shutdown(void);
+
+// Registrierung beim Start (nimmt eine Sperre, nicht für den heißen Pfad). bounds: aufsteigend,
+// höchstens METRICS_MAX_BUCKETS. NULL bei Fehler oder ohne metrics_init
+struct metric *metrics_counter(const char *name, const char *help);
+struct metric *metrics_gauge(const char *name, const char *help);
+struct metric *metrics_histogram(const char *name, const char *help, const double *bounds, unsigned int num_bounds);
+
+// Wie oben, mit festen Labels (name="wert", mehrere durch Komma getrennt); jede Kombination aus
+// Name und Labels nur einmal registrieren
+struct metric *metrics_counter_labeled(const char *name, const char *labels, const char *help);
+struct metric *metrics_gauge_labeled(const char *name, const char *labels, const char *help);
+struct metric *metrics_histogram_labeled(const char *name, const char *labels, const char *help,
+                                         const double *bounds, unsigned int num_bounds);
+
+// Heißer Pfad: keine Sperre, kein Systemaufruf
+void metrics_add(struct metric *m, uint64_t n);
+void metrics_set(struct metric *m, double value);
+void metrics_observe(struct metric *m, double value);
+
+static inline void metrics_inc(struct metric *m) {
+    metrics_add(m, 1);
+}
+
+// Für den Kollektor: fremdes Segment nur lesend einblenden bzw. freigeben. NULL bei Fehler
+// (EPROTO bei fremdem Layout)
+const struct metrics_segment *metrics_open(const char *path);
+void metrics_close(const struct metrics_segment *seg);
+
+#endif
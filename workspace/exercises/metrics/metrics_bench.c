@@ -0,0 +1,178 @@
+/*
+Benchmark: Kosten einer Aktualisierung auf dem heißen Pfad
+
+N Threads aktualisieren gleichzeitig dieselbe Kennzahl, so schnell sie können. Verglichen
+werden:
+  slot       metrics_inc (Zähler mit eigenem Slot pro Thread)
+  observe    metrics_observe (Histogramm mit 8 Grenzen, eigener Slot)
+  gauge      metrics_set (ein Wert pro Prozess, atomares Speichern)
+  atomic     ein gemeinsamer Zähler mit atomic_fetch_add (eine Cache-Line für alle Threads)
+  mutex      ein gemeinsamer Zähler hinter pthread_mutex
+Ausgegeben wird die mittlere CPU-Zeit pro Aktualisierung (CLOCK_THREAD_CPUTIME_ID, damit
+das Ergebnis auch mit mehr Threads als CPUs stimmt). Erwartung: slot und observe
+bleiben mit steigender Threadzahl konstant, atomic und mutex werden durch die Cache-Line, um die
+alle Threads konkurrieren, deutlich teurer. Zum Schluss wird geprüft, dass der Kollektor die
+Summe über alle Slots exakt sieht.
+
+Verwendung: ./metrics_bench [-t threads,threads,...] [-n millionen_pro_thread]
+*/
+
+#define _GNU_SOURCE
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "metrics.h"
+
+#define MAX_THREADS 64
+
+enum mode { MODE_SLOT, MODE_OBSERVE, MODE_GAUGE, MODE_ATOMIC, MODE_MUTEX, NUM_MODES };
+
+static const char *mode_names[NUM_MODES] = {"slot", "observe", "gauge", "atomic", "mutex"};
+
+struct worker {
+    pthread_t tid;
+    enum mode mode;
+    long iterations;
+    pthread_barrier_t *start;
+    uint64_t cpu_ns;
+};
+
+static struct metric *counter;
+static struct metric *histogram;
+static struct metric *gauge;
+static _Atomic uint64_t shared_counter __attribute__((aligned(64)));
+static pthread_mutex_t shared_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint64_t locked_counter;
+
+static uint64_t cpu_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void *worker_main(void *arg) {
+    struct worker *w = arg;
+    pthread_barrier_wait(w->start);
+    uint64_t t0 = cpu_ns();
+    for (long i = 0; i < w->iterations; ++i) {
+        switch (w->mode) {
+        case MODE_SLOT: metrics_inc(counter); break;
+        case MODE_OBSERVE: metrics_observe(histogram, (double)(i & 1023) * 1e-6); break;
+        case MODE_GAUGE: metrics_set(gauge, (double)i); break;
+        case MODE_ATOMIC: atomic_fetch_add_explicit(&shared_counter, 1, memory_order_relaxed); break;
+        case MODE_MUTEX:
+            pthread_mutex_lock(&shared_lock);
+            locked_counter++;
+            pthread_mutex_unlock(&shared_lock);
+            break;
+        default: break;
+        }
+    }
+    w->cpu_ns = cpu_ns() - t0;
+    return NULL;
+}
+
+// Mittlere CPU-Zeit in ns pro Aktualisierung
+static double run(enum mode mode, int threads, long iterations) {
+    struct worker workers[MAX_THREADS];
+    pthread_barrier_t start;
+    pthread_barrier_init(&start, NULL, (unsigned int)threads + 1);
+    for (int i = 0; i < threads; ++i) {
+        workers[i] = (struct worker){.mode = mode, .iterations = iterations, .start = &start};
+        pthread_create(&workers[i].tid, NULL, worker_main, &workers[i]);
+    }
+    pthread_barrier_wait(&start);
+    uint64_t total = 0;
+    for (int i = 0; i < threads; ++i) {
+        pthread_join(workers[i].tid, NULL);
+        total += workers[i].cpu_ns;
+    }
+    pthread_barrier_destroy(&start);
+    return (double)total / ((double)iterations * threads);
+}
+
+// Summe des Zählers so, wie der Kollektor sie bildet
+static uint64_t collected_count(uint32_t *slots) {
+    char path[128];
+    snprintf(path, sizeof(path), "/dev/shm/" METRICS_SHM_PREFIX "metrics_bench.%d", (int)getpid());
+    const struct metrics_segment *seg = metrics_open(path);
+    if (seg == NULL) {
+        return 0;
+    }
+    uint64_t sum = 0;
+    *slots = atomic_load(&seg->num_slots);
+    for (uint32_t s = 0; s < *slots && s < METRICS_MAX_SLOTS; ++s) {
+        sum += atomic_load(&seg->slots[s].values[counter->offset]);
+    }
+    metrics_close(seg);
+    return sum;
+}
+
+int main(int argc, char *argv[]) {
+    char default_list[] = "1,2,4,8";
+    char *list = default_list;
+    long millions = 20;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "t:n:h")) != -1) {
+        switch (opt) {
+        case 't': list = optarg; break;
+        case 'n': millions = atol(optarg); break;
+        default:
+            fprintf(stderr, "Verwendung: %s [-t threads,threads,...] [-n millionen_pro_thread]\n", argv[0]);
+            return opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if (millions < 1) {
+        fprintf(stderr, "Ungültige Parameter\n");
+        return EXIT_FAILURE;
+    }
+    if (metrics_init("metrics_bench") != 0) {
+        perror("metrics_init");
+        return EXIT_FAILURE;
+    }
+    static const double bounds[] = {1e-6, 5e-6, 1e-5, 5e-5, 1e-4, 2e-4, 5e-4, 1e-3};
+    counter = metrics_counter("bench_updates_total", "Aktualisierungen im Benchmark");
+    histogram = metrics_histogram("bench_observe_seconds", "Beobachtungen im Benchmark", bounds, 8);
+    gauge = metrics_gauge("bench_gauge", "Messwert im Benchmark");
+
+    long iterations = millions * 1000000L;
+    printf("%ld Mio. Aktualisierungen pro Thread, %ld CPUs, CPU-Zeit in ns pro Aktualisierung\n", millions,
+           sysconf(_SC_NPROCESSORS_ONLN));
+    printf("%8s", "threads");
+    for (int m = 0; m < NUM_MODES; ++m) {
+        printf(" %9s", mode_names[m]);
+    }
+    printf("\n");
+
+    uint64_t expected = 0;
+    for (char *tok = strtok(list, ","); tok != NULL; tok = strtok(NULL, ",")) {
+        int threads = atoi(tok);
+        if (threads < 1 || threads > MAX_THREADS) {
+            fprintf(stderr, "Threadzahl außerhalb 1..%d: %s\n", MAX_THREADS, tok);
+            metrics_shutdown();
+            return EXIT_FAILURE;
+        }
+        printf("%8d", threads);
+        for (int m = 0; m < NUM_MODES; ++m) {
+            printf(" %9.2f", run((enum mode)m, threads, iterations));
+            fflush(stdout);
+        }
+        printf("\n");
+        expected += (uint64_t)threads * (uint64_t)iterations;
+    }
+
+    uint32_t slots = 0;
+    uint64_t seen = collected_count(&slots);
+    printf("Kollektor-Summe des Zählers: %llu (erwartet %llu, %u Slots belegt) - %s\n", (unsigned long long)seen,
+           (unsigned long long)expected, slots, seen == expected ? "ok" : "FEHLER");
+    metrics_shutdown();
+    return seen == expected ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,477 @@
+/*
+Kollektor für die Kennzahlen aller Workspace-Programme
+
+Sucht in /dev/shm nach Segmenten metrics.<programm>.<pid>, blendet sie nur lesend ein,
+summiert die Thread-Slots und gibt alles im Prometheus-Textformat (Version 0.0.4) aus. Jede
+Zeitreihe trägt die Labels program und pid sowie die festen Labels der Kennzahl (z.B. policy);
+Kennzahlen gleichen Namens aus mehreren Prozessen oder mit verschiedenen festen Labels stehen
+unter einem gemeinsamen HELP/TYPE-Block.
+
+Ohne -l einmalig auf stdout. Mit -l (bzw. -s socket) lauscht der Kollektor auf einem lokalen
+Unix-Socket und liefert bei jeder Verbindung eine frische Abfrage: auf eine HTTP-Anfrage (GET)
+mit HTTP-Kopf, sonst nur den Text. Segmente beendeter Prozesse werden übersprungen, mit -g entfernt.
+
+Aufruf: metrics_collector [-l] [-s socket] [-d verzeichnis] [-g]
+  curl --unix-socket /tmp/workspace_metrics.sock http://localhost/metrics
+  socat - UNIX-CONNECT:/tmp/workspace_metrics.sock
+*/
+
+#define _GNU_SOURCE
+
+#include <dirent.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "metrics.h"
+
+#define MAX_PROCESSES 256
+
+struct process {
+    const struct metrics_segment *seg;
+    char program[METRICS_PROGRAM_LEN];
+    int pid;
+    uint32_t num_metrics;
+};
+
+static volatile sig_atomic_t running = 1;
+
+static void handle_signal(int sig) {
+    (void)sig;
+    running = 0;
+}
+
+static double now_s(clockid_t clock) {
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static double bits_double(uint64_t bits) {
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Kürzeste Darstellung, die beim Einlesen wieder denselben Wert ergibt (0.001 statt 0.00100000000000000002)
+static const char *format_double(char *buf, size_t size, double value) {
+    for (int precision = 6; precision < 17; ++precision) {
+        snprintf(buf, size, "%.*g", precision, value);
+        if (strtod(buf, NULL) == value) {
+            return buf;
+        }
+    }
+    snprintf(buf, size, "%.17g", value);
+    return buf;
+}
+
+static int valid_name(const char *name) {
+    if (!((*name >= 'a' && *name <= 'z') || (*name >= 'A' && *name <= 'Z') || *name == '_' || *name == ':')) {
+        return 0;
+    }
+    for (const char *p = name + 1; *p; ++p) {
+        if (!((*p >= 'a' && *p <= 'z') || (*p >= 'A' && *p <= 'Z') || (*p >= '0' && *p <= '9') || *p == '_' ||
+              *p == ':')) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static int label_char(char c, int first) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || (!first && c >= '0' && c <= '9');
+}
+
+// Feste Labels einer Kennzahl: leer oder name="wert"[,name="wert"...]. Werte ohne Anführungszeichen,
+// Backslash und Zeilenumbruch; program, pid und le vergibt der Kollektor selbst
+static int valid_labels(const char *labels) {
+    const char *p = labels;
+    while (*p != '\0') {
+        const char *key = p;
+        if (!label_char(*p, 1)) {
+            return 0;
+        }
+        while (label_char(*p, 0)) {
+            p++;
+        }
+        size_t key_len = (size_t)(p - key);
+        if ((key_len == 7 && strncmp(key, "program", 7) == 0) || (key_len == 3 && strncmp(key, "pid", 3) == 0) ||
+            (key_len == 2 && strncmp(key, "le", 2) == 0)) {
+            return 0;
+        }
+        if (p[0] != '=' || p[1] != '"') {
+            return 0;
+        }
+        for (p += 2; *p != '\0' && *p != '"' && *p != '\\' && *p != '\n'; ++p) {
+        }
+        if (*p != '"') {
+            return 0;
+        }
+        p++;
+        if (*p == ',' && p[1] != '\0') {
+            p++;
+        } else if (*p != '\0') {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// HELP-Text: Backslash und Zeilenumbruch maskieren
+static void print_help(FILE *out, const char *name, const char *help) {
+    fprintf(out, "# HELP %s ", name);
+    for (const char *p = help; *p; ++p) {
+        if (*p == '\\') {
+            fputs("\\\\", out);
+        } else if (*p == '\n') {
+            fputs("\\n", out);
+        } else {
+            fputc(*p, out);
+        }
+    }
+    fputc('\n', out);
+}
+
+static const char *type_name(uint32_t type) {
+    switch (type) {
+    case METRICS_COUNTER: return "counter";
+    case METRICS_GAUGE: return "gauge";
+    case METRICS_HISTOGRAM: return "histogram";
+    default: return NULL;
+    }
+}
+
+// Summe eines Werts über alle vergebenen Slots
+static uint64_t sum_u64(const struct metrics_segment *seg, uint32_t offset) {
+    uint32_t slots = atomic_load_explicit(&seg->num_slots, memory_order_relaxed);
+    uint64_t sum = 0;
+    for (uint32_t s = 0; s < slots && s < METRICS_MAX_SLOTS; ++s) {
+        sum += atomic_load_explicit(&seg->slots[s].values[offset], memory_order_relaxed);
+    }
+    return sum;
+}
+
+static double sum_double(const struct metrics_segment *seg, uint32_t offset) {
+    uint32_t slots = atomic_load_explicit(&seg->num_slots, memory_order_relaxed);
+    double sum = 0.0;
+    for (uint32_t s = 0; s < slots && s < METRICS_MAX_SLOTS; ++s) {
+        sum += bits_double(atomic_load_explicit(&seg->slots[s].values[offset], memory_order_relaxed));
+    }
+    return sum;
+}
+
+// Passt die Kennzahl in das Slot-Layout? Schützt vor Lesezugriffen hinter dem Segment
+static int valid_layout(const struct metric *m) {
+    switch (m->type) {
+    case METRICS_COUNTER: return m->offset < METRICS_SLOT_VALUES;
+    case METRICS_GAUGE: return m->offset < METRICS_MAX;
+    case METRICS_HISTOGRAM:
+        return m->num_buckets >= 1 && m->num_buckets <= METRICS_MAX_BUCKETS &&
+               m->offset + m->num_buckets + 2 <= METRICS_SLOT_VALUES;
+    default: return 0;
+    }
+}
+
+// Feste Labels in buf kopieren (das Segment gehört einem fremden Prozess); NULL wenn ungültig
+static const char *metric_labels(const struct metric *m, char *buf) {
+    memcpy(buf, m->labels, METRICS_LABELS_LEN);
+    buf[METRICS_LABELS_LEN - 1] = '\0';
+    return valid_labels(buf) ? buf : NULL;
+}
+
+// Kann die Kennzahl ausgegeben werden? Nur solche eröffnen eine Familie (HELP/TYPE)
+static int printable(const struct metric *m) {
+    char fixed[METRICS_LABELS_LEN];
+    return type_name(m->type) != NULL && valid_layout(m) && metric_labels(m, fixed) != NULL;
+}
+
+static void print_series(FILE *out, const struct process *p, const char *name, const struct metric *m,
+                         const char *fixed) {
+    char labels[160];
+    char number[32];
+    snprintf(labels, sizeof(labels), "program=\"%s\",pid=\"%d\"%s%s", p->program, p->pid, fixed[0] ? "," : "", fixed);
+
+    if (m->type == METRICS_COUNTER) {
+        fprintf(out, "%s{%s} %" PRIu64 "\n", name, labels, sum_u64(p->seg, m->offset));
+    } else if (m->type == METRICS_GAUGE) {
+        double value = bits_double(atomic_load_explicit(&p->seg->gauges[m->offset], memory_order_relaxed));
+        fprintf(out, "%s{%s} %s\n", name, labels, format_double(number, sizeof(number), value));
+    } else {
+        // Slots enthalten Einzel-Buckets; Prometheus erwartet kumulierte Werte
+        uint32_t buckets = m->num_buckets;
+        uint64_t cumulative = 0;
+        for (uint32_t b = 0; b < buckets; ++b) {
+            cumulative += sum_u64(p->seg, m->offset + b);
+            fprintf(out, "%s_bucket{%s,le=\"%s\"} %" PRIu64 "\n", name, labels,
+                    format_double(number, sizeof(number), m->bounds[b]), cumulative);
+        }
+        cumulative += sum_u64(p->seg, m->offset + buckets);
+        fprintf(out, "%s_bucket{%s,le=\"+Inf\"} %" PRIu64 "\n", name, labels, cumulative);
+        fprintf(out, "%s_sum{%s} %s\n", name, labels,
+                format_double(number, sizeof(number), sum_double(p->seg, m->offset + buckets + 1)));
+        fprintf(out, "%s_count{%s} %" PRIu64 "\n", name, labels, cumulative);
+    }
+}
+
+// Lebt der Prozess noch? EPERM heißt: ja, gehört nur einem anderen Benutzer
+static int process_alive(int pid) {
+    return pid > 0 && (kill(pid, 0) == 0 || errno == EPERM);
+}
+
+static int discover(const char *dir, int remove_stale, struct process *procs) {
+    DIR *d = opendir(dir);
+    if (d == NULL) {
+        return 0;
+    }
+    int n = 0;
+    struct dirent *entry;
+    while ((entry = readdir(d)) != NULL && n < MAX_PROCESSES) {
+        if (strncmp(entry->d_name, METRICS_SHM_PREFIX, strlen(METRICS_SHM_PREFIX)) != 0) {
+            continue;
+        }
+        // Nur metrics.<programm>.<pid> mit rein numerischer PID > 0, wie remove_stale in metrics.c;
+        // alles andere gehört nicht zu uns und wird auch mit -g nicht angefasst
+        const char *dot = strrchr(entry->d_name, '.');
+        if (dot < entry->d_name + strlen(METRICS_SHM_PREFIX) || !(dot[1] >= '0' && dot[1] <= '9')) {
+            continue;
+        }
+        char *end;
+        errno = 0;
+        long pid = strtol(dot + 1, &end, 10);
+        if (*end != '\0' || errno != 0 || pid <= 0 || pid > INT32_MAX) {
+            continue;
+        }
+        char path[512];
+        snprintf(path, sizeof(path), "%s/%s", dir, entry->d_name);
+        if (!process_alive((int)pid)) {
+            if (remove_stale && unlink(path) == 0) {
+                fprintf(stderr, "Verwaistes Segment entfernt: %s\n", path);
+            }
+            continue;
+        }
+        const struct metrics_segment *seg = metrics_open(path);
+        if (seg == NULL) {
+            continue; // fremdes Layout oder noch nicht initialisiert
+        }
+        procs[n].seg = seg;
+        procs[n].pid = seg->pid;
+        // Label-Wert ohne Anführungszeichen o.ä., auch bei fremden Segmenten
+        for (size_t c = 0; c < sizeof(procs[n].program); ++c) {
+            char ch = seg->program[c];
+            int ok = (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9') || ch == '_';
+            procs[n].program[c] = ch == '\0' || ok ? ch : '_';
+        }
+        procs[n].program[sizeof(procs[n].program) - 1] = '\0';
+        uint32_t count = atomic_load_explicit(&seg->num_metrics, memory_order_acquire);
+        procs[n].num_metrics = count > METRICS_MAX ? METRICS_MAX : count;
+        n++;
+    }
+    closedir(d);
+    return n;
+}
+
+// Eine vollständige Abfrage im Textformat
+static void collect(FILE *out, const char *dir, int remove_stale) {
+    static struct process procs[MAX_PROCESSES];
+    double t0 = now_s(CLOCK_MONOTONIC);
+    int n = discover(dir, remove_stale, procs);
+
+    // Je Name ein HELP/TYPE-Block mit den Zeitreihen aller Prozesse
+    for (int i = 0; i < n; ++i) {
+        for (uint32_t k = 0; k < procs[i].num_metrics; ++k) {
+            const struct metric *m = &procs[i].seg->metrics[k];
+            char name[METRICS_NAME_LEN];
+            memcpy(name, m->name, sizeof(name));
+            name[sizeof(name) - 1] = '\0';
+            const char *type = type_name(m->type);
+            if (type == NULL || !valid_name(name) || !printable(m)) {
+                continue;
+            }
+            // Schon in einem früheren Prozess ausgegeben?
+            int seen = 0;
+            for (int j = 0; j < i && !seen; ++j) {
+                for (uint32_t l = 0; l < procs[j].num_metrics && !seen; ++l) {
+                    seen = strncmp(procs[j].seg->metrics[l].name, name, sizeof(name)) == 0 &&
+                           printable(&procs[j].seg->metrics[l]);
+                }
+            }
+            for (uint32_t l = 0; l < k && !seen; ++l) {
+                seen = strncmp(procs[i].seg->metrics[l].name, name, sizeof(name)) == 0 &&
+                       printable(&procs[i].seg->metrics[l]);
+            }
+            if (seen) {
+                continue;
+            }
+            print_help(out, name, m->help);
+            fprintf(out, "# TYPE %s %s\n", name, type);
+            // Alle Zeitreihen der Familie: pro Prozess jede Kombination fester Labels einmal
+            for (int j = i; j < n; ++j) {
+                for (uint32_t l = 0; l < procs[j].num_metrics; ++l) {
+                    const struct metric *other = &procs[j].seg->metrics[l];
+                    char fixed[METRICS_LABELS_LEN];
+                    // Gleicher Name mit anderem Typ wäre ungültig: überspringen
+                    if (strncmp(other->name, name, sizeof(name)) != 0 || other->type != m->type ||
+                        !valid_layout(other) || metric_labels(other, fixed) == NULL) {
+                        continue;
+                    }
+                    int duplicate = 0;
+                    for (uint32_t e = 0; e < l && !duplicate; ++e) {
+                        const struct metric *earlier = &procs[j].seg->metrics[e];
+                        duplicate = strncmp(earlier->name, name, sizeof(name)) == 0 && earlier->type == m->type &&
+                                    strncmp(earlier->labels, fixed, sizeof(fixed)) == 0;
+                    }
+                    if (!duplicate) {
+                        print_series(out, &procs[j], name, other, fixed);
+                    }
+                }
+            }
+        }
+    }
+
+    fprintf(out, "# HELP workspace_process_start_time_seconds Startzeit des Prozesses (Unix-Zeit)\n");
+    fprintf(out, "# TYPE workspace_process_start_time_seconds gauge\n");
+    for (int i = 0; i < n; ++i) {
+        fprintf(out, "workspace_process_start_time_seconds{program=\"%s\",pid=\"%d\"} %.3f\n", procs[i].program,
+                procs[i].pid, (double)procs[i].seg->start_time_ns / 1e9);
+    }
+    fprintf(out, "# HELP metrics_collector_processes Gefundene Prozesse mit Kennzahlen\n");
+    fprintf(out, "# TYPE metrics_collector_processes gauge\n");
+    fprintf(out, "metrics_collector_processes %d\n", n);
+    fprintf(out, "# HELP metrics_collector_scrape_duration_seconds Dauer dieser Abfrage\n");
+    fprintf(out, "# TYPE metrics_collector_scrape_duration_seconds gauge\n");
+    fprintf(out, "metrics_collector_scrape_duration_seconds %.6f\n", now_s(CLOCK_MONOTONIC) - t0);
+
+    for (int i = 0; i < n; ++i) {
+        metrics_close(procs[i].seg);
+    }
+}
+
+static int write_all(int fd, const char *buf, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, buf, len);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        buf += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static void serve_client(int fd, const char *dir, int remove_stale) {
+    // Kurz auf eine Anfrage warten; ohne Anfrage (socat, nc) nur den Text senden
+    char request[1024];
+    size_t len = 0;
+    struct pollfd pfd = {fd, POLLIN, 0};
+    while (len < sizeof(request) - 1 && poll(&pfd, 1, 200) > 0) {
+        ssize_t n = read(fd, request + len, sizeof(request) - 1 - len);
+        if (n <= 0) {
+            break;
+        }
+        len += (size_t)n;
+        request[len] = '\0';
+        if (strstr(request, "\r\n\r\n") != NULL || strstr(request, "\n\n") != NULL) {
+            break;
+        }
+    }
+    request[len] = '\0';
+    int http = strncmp(request, "GET ", 4) == 0;
+
+    char *body = NULL;
+    size_t body_len = 0;
+    FILE *out = open_memstream(&body, &body_len);
+    if (out == NULL) {
+        return;
+    }
+    collect(out, dir, remove_stale);
+    fclose(out);
+
+    if (http) {
+        char header[160];
+        int n = snprintf(header, sizeof(header),
+                         "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: %zu\r\n\r\n",
+                         body_len);
+        write_all(fd, header, (size_t)n);
+    }
+    write_all(fd, body, body_len);
+    free(body);
+}
+
+static int serve(const char *socket_path, const char *dir, int remove_stale) {
+    struct sockaddr_un addr = {.sun_family = AF_UNIX};
+    if (strlen(socket_path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "Socket-Pfad zu lang: %s\n", socket_path);
+        return -1;
+    }
+    strcpy(addr.sun_path, socket_path);
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0) {
+        perror("socket");
+        return -1;
+    }
+    unlink(socket_path); // Überbleibsel eines früheren Laufs
+    if (bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(listen_fd, 16) != 0) {
+        perror(socket_path);
+        close(listen_fd);
+        return -1;
+    }
+    printf("Kennzahlen auf %s (Segmente in %s)\n", socket_path, dir);
+    fflush(stdout);
+
+    while (running) {
+        int fd = accept4(listen_fd, NULL, NULL, SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno != EINTR) {
+                perror("accept");
+            }
+            continue;
+        }
+        serve_client(fd, dir, remove_stale);
+        close(fd);
+    }
+    close(listen_fd);
+    unlink(socket_path);
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    const char *socket_path = NULL;
+    const char *dir = "/dev/shm";
+    int remove_stale = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "ls:d:gh")) != -1) {
+        switch (opt) {
+        case 'l': socket_path = socket_path != NULL ? socket_path : METRICS_SOCKET; break;
+        case 's': socket_path = optarg; break;
+        case 'd': dir = optarg; break;
+        case 'g': remove_stale = 1; break;
+        default:
+            fprintf(stderr, "Verwendung: %s [-l] [-s socket] [-d verzeichnis] [-g]\n", argv[0]);
+            return opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    if (socket_path == NULL) {
+        collect(stdout, dir, remove_stale);
+        return EXIT_SUCCESS;
+    }
+    // Ohne SA_RESTART, damit accept bei SIGINT/SIGTERM zurückkehrt
+    struct sigaction sa = {0};
+    sa.sa_handler = handle_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN); // Client hat die Verbindung vorzeitig geschlossen
+    return serve(socket_path, dir, remove_stale) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
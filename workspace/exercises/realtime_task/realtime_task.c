@@ -15,14 +15,19 @@ Anforderung:
 - Stelle sicher, dass der Code korrekt kompiliert und ausgeführt werden kann.
 */
 
-#define _POSIX_C_SOURCE 199309L
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE // syscall (Futex in rt_slack.h)
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <pthread.h> // Für pthreads
 #include <sched.h> // Für SCHED_FIFO und SCHED_RR
+#include <signal.h> // Für sauberes Beenden mit SIGINT/SIGTERM
 #include <unistd.h> // Für sleep
 #include <time.h> // Für clock_gettime und clock_nanosleep
+#include "rt_slack.h" // Schlupf-Veröffentlichung für den DVFS-Governor (../dvfs)
+#include "metrics.h" // Kennzahlen für metrics_collector (../metrics)
 #ifndef TIMER_ABSTIME
 #define TIMER_ABSTIME 1
 #endif
@@ -30,30 +35,131 @@ Anforderung:
 #define PERIOD_SEC 1
 #define PERIOD_NSEC 0
 
+// Verwendung: ./realtime_task [periode_us] [arbeit_kiloiterationen]
+// Ohne Argumente: Periode 1 s ohne zusätzliche Last.
+// Die Arbeit ist in Iterationen statt in Zeit angegeben, damit ihre Laufzeit mit der
+// CPU-Frequenz skaliert - so wird sichtbar, wie der DVFS-Governor (dvfs -b) den Schlupf verändert.
+struct task_config {
+    long period_nsec;
+    long work_kiloiterations;
+};
+
+static volatile sig_atomic_t running = 1;
+static volatile uint64_t work_sink;
+
+// Kennzahlen; NULL (wirkungslos), wenn /dev/shm nicht verfügbar ist
+static struct metric *metric_jobs;
+static struct metric *metric_overruns;
+static struct metric *metric_slack;
+static const double slack_bounds[] = {0, 1e-5, 5e-5, 1e-4, 5e-4, 1e-3, 5e-3, 1e-2, 5e-2, 1e-1, 5e-1, 1};
+
+static void handle_signal(int sig) {
+    (void)sig;
+    running = 0;
+}
+
+static int64_t timespec_ns(const struct timespec *ts) {
+    return (int64_t)ts->tv_sec * 1000000000LL + ts->tv_nsec;
+}
+
+// Synthetische, frequenzabhängige Rechenlast
+static void do_work(long kiloiterations) {
+    uint64_t x = 88172645463325252ULL;
+    for (long i = 0; i < kiloiterations * 1000; ++i) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+    }
+    work_sink = x;
+}
+
 void *realtime_task(void *arg) {
+    const struct task_config *config = arg;
     struct timespec next_activation;
+    struct timespec now;
+
+    // Schlupf-Slot belegen; ohne Shared Memory läuft die Aufgabe unverändert weiter
+    struct rt_slack_segment *slack = rt_slack_attach(RT_SLACK_SHM_NAME, 1);
+    int slot = slack ? rt_slack_register(slack, (int32_t)getpid(), -1, (uint64_t)config->period_nsec) : -1;
+    if (slot < 0) {
+        fprintf(stderr, "Hinweis: Schlupf wird nicht veröffentlicht (%s nicht verfügbar)\n", RT_SLACK_SHM_NAME);
+    }
+    // Bei kurzen Perioden nur etwa einmal pro Sekunde ausgeben
+    long print_every = config->period_nsec >= 1000000000L ? 1 : 1000000000L / config->period_nsec;
+
     clock_gettime(CLOCK_MONOTONIC, &next_activation);
-    while (1) {
-        // Periodische Ausgabe auf die Konsole
-        printf("Echtzeit-Aufgabe läuft\n");
-        fflush(stdout);
-        // Nächste Aktivierungszeit berechnen
-        next_activation.tv_sec += PERIOD_SEC;
-        next_activation.tv_nsec += PERIOD_NSEC;
+    for (long job = 0; running; ++job) {
+        do_work(config->work_kiloiterations);
+        // Nächste Aktivierungszeit berechnen; sie ist zugleich die Deadline dieses Jobs
+        next_activation.tv_sec += config->period_nsec / 1000000000L;
+        next_activation.tv_nsec += config->period_nsec % 1000000000L;
         if (next_activation.tv_nsec >= 1000000000) {
             next_activation.tv_sec += 1;
             next_activation.tv_nsec -= 1000000000;
         }
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        int64_t slack_ns = timespec_ns(&next_activation) - timespec_ns(&now);
+        if (slot >= 0) {
+            rt_slack_publish(slack, slot, slack_ns, (uint64_t)timespec_ns(&now));
+        }
+        metrics_inc(metric_jobs);
+        metrics_observe(metric_slack, (double)slack_ns / 1e9);
+        if (slack_ns < 0) {
+            metrics_inc(metric_overruns);
+        }
+        // Periodische Ausgabe auf die Konsole; Zeile auf dem Stack formatieren, ohne stdio-Puffer
+        if (job % print_every == 0) {
+            char line[96];
+            int len = snprintf(line, sizeof(line), "Echtzeit-Aufgabe läuft (Schlupf %lld us)\n", (long long)(slack_ns / 1000));
+            ssize_t written = write(STDOUT_FILENO, line, len < (int)sizeof(line) ? (size_t)len : sizeof(line) - 1);
+            (void)written; // Ausgabe ist nur informativ
+        }
         // Warten bis zur nächsten Aktivierung (deterministisch)
         clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next_activation, NULL);
     }
+    if (slot >= 0) {
+        rt_slack_unregister(slack, slot);
+    }
+    if (slack != NULL) {
+        rt_slack_detach(slack);
+    }
     return NULL;
 }
 
-int main() {
+int main(int argc, char *argv[]) {
     pthread_t thread;
     struct sched_param param;
     pthread_attr_t attr;
+    struct task_config config = {
+        .period_nsec = PERIOD_SEC * 1000000000L + PERIOD_NSEC,
+        .work_kiloiterations = 0,
+    };
+
+    if (argc > 1) {
+        config.period_nsec = atol(argv[1]) * 1000L;
+    }
+    if (argc > 2) {
+        config.work_kiloiterations = atol(argv[2]);
+    }
+    if (config.period_nsec <= 0 || config.work_kiloiterations < 0) {
+        fprintf(stderr, "Verwendung: %s [periode_us] [arbeit_kiloiterationen]\n", argv[0]);
+        return 1;
+    }
+
+    struct sigaction sa = {0};
+    sa.sa_handler = handle_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    if (metrics_init("realtime_task") != 0) {
+        perror("Hinweis: Kennzahlen nicht verfügbar");
+    }
+    metric_jobs = metrics_counter("realtime_task_jobs_total", "Abgeschlossene Jobs");
+    metric_overruns = metrics_counter("realtime_task_deadline_misses_total", "Jobs mit negativem Schlupf");
+    metric_slack = metrics_histogram("realtime_task_slack_seconds", "Schlupf bis zur Deadline", slack_bounds,
+                                     sizeof(slack_bounds) / sizeof(slack_bounds[0]));
+    metrics_set(metrics_gauge("realtime_task_period_seconds", "Periode der Echtzeit-Aufgabe"),
+                (double)config.period_nsec / 1e9);
 
     // Echtzeit-Thread-Attribute initialisieren
     pthread_attr_init(&attr);
@@ -63,18 +169,20 @@ int main() {
     pthread_attr_setschedparam(&attr, &param);
 
     // Echtzeit-Thread erstellen
-    if (pthread_create(&thread, &attr, realtime_task, NULL) != 0) {
+    if (pthread_create(&thread, &attr, realtime_task, &config) != 0) {
         perror("Fehler beim Erstellen des Echtzeit-Threads");
         fprintf(stderr, "Hinweis: Für SCHED_FIFO ist Root-Rechte nötig (sudo).\n");
+        metrics_shutdown();
         return 1;
     }
     // Haupt-Thread schlafen lassen, um Echtzeit-Thread laufen zu lassen
-    while (1) {
+    while (running) {
         sleep(1);
     }
 
-    // Haupt-Thread wartet auf Beenden (optional: Signal-Handling für sauberes Beenden)
+    // Haupt-Thread wartet auf Beenden (Signal-Handling für sauberes Beenden)
     pthread_join(thread, NULL);
     pthread_attr_destroy(&attr);
+    metrics_shutdown();
     return 0;
 }
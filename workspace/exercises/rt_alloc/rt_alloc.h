@@ -0,0 +1,80 @@
+#ifndef RT_ALLOC_H
+#define RT_ALLOC_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+Echtzeitfähige Speicherverwaltung für SCHED_FIFO-Schleifen.
+
+malloc kann in einer Echtzeit-Schleife Sperren nehmen, per brk/mmap in den Kernel gehen und
+beim ersten Zugriff auf neue Seiten Page-Faults auslösen. Beide Allokatoren hier holen ihren
+gesamten Speicher bei der Initialisierung, berühren jede Seite und sperren sie per mlock im
+RAM. Danach macht keine Allokation mehr einen Systemaufruf.
+
+rt_pool   Blöcke fester Größe. Eine gemeinsame, lock-freie Freiliste (Treiber-Stack mit
+          Versionszähler gegen ABA) plus ein Cache pro Thread: Allokation und Freigabe greifen
+          meist nur auf den eigenen Cache zu, die Freiliste wird stapelweise nachgefüllt bzw.
+          entlastet. Blöcke dürfen in einem anderen Thread freigegeben werden.
+
+rt_arena  Bump-Allokator für Puffer, die nur einen Zyklus leben: Allokation = Zeiger
+          verschieben, am Zyklusende rt_arena_reset. Kein free einzelner Blöcke, nicht
+          threadsicher (eine Arena pro Schleife).
+
+Schlägt mlock fehl (RLIMIT_MEMLOCK, ohne CAP_IPC_LOCK), wird der Speicher trotzdem
+vorbelegt und locked bleibt 0; der Aufrufer entscheidet, ob das genügt.
+*/
+
+#define RT_ALLOC_ALIGN 16
+#define RT_POOL_CACHE_SIZE 32              // Blöcke pro Thread-Cache
+#define RT_POOL_BATCH (RT_POOL_CACHE_SIZE / 2)
+
+struct rt_pool {
+    char *memory;
+    size_t mapped_bytes;
+    size_t block_size;                     // aufgerundet auf RT_ALLOC_ALIGN
+    uint32_t num_blocks;
+    _Atomic uint32_t *next;                // Nachfolger in der Freiliste, Index + 1 (0 = Ende)
+    _Atomic uint64_t head;                 // (Version << 32) | (Index + 1)
+    _Atomic uint32_t free_blocks;          // Blöcke in der gemeinsamen Freiliste (Statistik)
+    int locked;
+};
+
+// Pro Thread und Pool; liegt beim Thread (z.B. auf dessen Stack oder in seinem Kontext)
+struct rt_pool_cache {
+    struct rt_pool *pool;
+    uint32_t count;
+    uint32_t blocks[RT_POOL_CACHE_SIZE];
+};
+
+struct rt_arena {
+    char *base;
+    size_t size;
+    size_t used;
+    size_t high_water;                     // größter Verbrauch eines Zyklus
+    unsigned long failed;                  // Allokationen ohne Platz
+    int locked;
+};
+
+// Vorbelegter, gesperrter Speicher; locked = 1 wenn mlock erfolgreich. NULL bei Fehler
+void *rt_alloc_map(size_t bytes, int *locked);
+void rt_alloc_unmap(void *memory, size_t bytes);
+
+// 0 bei Erfolg, -1 bei Fehler (errno gesetzt)
+int rt_pool_init(struct rt_pool *pool, size_t block_size, uint32_t num_blocks);
+void rt_pool_destroy(struct rt_pool *pool);
+void rt_pool_cache_init(struct rt_pool_cache *cache, struct rt_pool *pool);
+// Gibt die Blöcke des Caches an die gemeinsame Freiliste zurück (vor Thread-Ende aufrufen)
+void rt_pool_cache_flush(struct rt_pool_cache *cache);
+// NULL wenn der Pool erschöpft ist
+void *rt_pool_alloc(struct rt_pool_cache *cache);
+void rt_pool_free(struct rt_pool_cache *cache, void *block);
+
+int rt_arena_init(struct rt_arena *arena, size_t size);
+void rt_arena_destroy(struct rt_arena *arena);
+// NULL wenn die Arena für diesen Zyklus voll ist
+void *rt_arena_alloc(struct rt_arena *arena, size_t size);
+void rt_arena_reset(struct rt_arena *arena);
+
+#endif
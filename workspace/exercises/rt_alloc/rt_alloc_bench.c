@@ -0,0 +1,322 @@
+/*
+Benchmark: Allokationslatenz von glibc malloc, rt_pool und rt_arena unter Konkurrenz
+
+Alle Threads laufen gleichzeitig Zyklen ab, wie eine Regelschleife: pro Zyklus werden k Blöcke
+angefordert, beschrieben und wieder freigegeben (Arena: rt_arena_reset). Gemessen wird jede
+einzelne Allokation mit clock_gettime (enthält dessen Overhead von einigen 10 ns).
+Mit -x gibt jeder Thread die Hälfte seiner Blöcke über einen Ring an den Nachbar-Thread, der sie
+freigibt - das trifft malloc-Arenen und die gemeinsame Freiliste des Pools.
+
+Ausgabe: p50, p99, p99.99 und Maximum in ns pro Allokator. Das Maximum enthält auch
+Verdrängungen und Interrupts zwischen den beiden Zeitstempeln; aussagekräftig ist es nur mit
+-f und höchstens so vielen Threads wie CPUs.
+
+Verwendung: ./rt_alloc_bench [-t threads] [-c zyklen] [-k blöcke_pro_zyklus] [-s blockgröße]
+                             [-x] [-f (SCHED_FIFO)]
+*/
+
+#define _GNU_SOURCE
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "rt_alloc.h"
+
+#define HIST_NS 65536          // 1-ns-Auflösung bis hier, darüber nur das Maximum
+#define MAX_THREADS 64
+#define MAX_BLOCKS 256
+#define RING_SIZE 1024          // Zweierpotenz
+
+enum allocator { ALLOC_MALLOC, ALLOC_POOL, ALLOC_ARENA };
+static const char *const allocator_names[] = { "malloc", "rt_pool", "rt_arena" };
+
+// Einfacher SPSC-Ring für Blöcke, die ein anderer Thread freigibt
+struct handoff_ring {
+    _Atomic uint32_t head;
+    char pad1[60];
+    _Atomic uint32_t tail;
+    char pad2[60];
+    void *slots[RING_SIZE];
+};
+
+struct bench_config {
+    int threads;
+    long cycles;
+    int blocks;
+    size_t block_size;
+    int cross;
+    int fifo;
+};
+
+struct bench_thread {
+    pthread_t tid;
+    int id;
+    enum allocator kind;
+    const struct bench_config *config;
+    struct rt_pool *pool;
+    struct handoff_ring *out;   // an Thread id + 1
+    struct handoff_ring *in;    // von Thread id - 1
+    uint64_t *hist;
+    uint64_t overflow;
+    uint64_t max_ns;
+    uint64_t failed;
+};
+
+static pthread_barrier_t start_barrier;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int ring_push(struct handoff_ring *ring, void *block) {
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    if (head - tail == RING_SIZE) {
+        return 0;
+    }
+    ring->slots[head & (RING_SIZE - 1)] = block;
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+    return 1;
+}
+
+static void *ring_pop(struct handoff_ring *ring) {
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    if (tail == head) {
+        return NULL;
+    }
+    void *block = ring->slots[tail & (RING_SIZE - 1)];
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+    return block;
+}
+
+static void record(struct bench_thread *t, uint64_t ns) {
+    if (ns < HIST_NS) {
+        t->hist[ns]++;
+    } else {
+        t->overflow++;
+    }
+    if (ns > t->max_ns) {
+        t->max_ns = ns;
+    }
+}
+
+static void release(struct bench_thread *t, struct rt_pool_cache *cache, void *block) {
+    if (t->kind == ALLOC_MALLOC) {
+        free(block);
+    } else if (t->kind == ALLOC_POOL) {
+        rt_pool_free(cache, block);
+    }
+}
+
+static void *bench_thread_main(void *arg) {
+    struct bench_thread *t = arg;
+    const struct bench_config *config = t->config;
+    struct rt_pool_cache cache;
+    struct rt_arena arena;
+    void *blocks[MAX_BLOCKS];
+
+    if (t->kind == ALLOC_POOL) {
+        rt_pool_cache_init(&cache, t->pool);
+    }
+    if (t->kind == ALLOC_ARENA && rt_arena_init(&arena, (size_t)config->blocks * (config->block_size + RT_ALLOC_ALIGN)) != 0) {
+        perror("rt_arena_init");
+        return NULL;
+    }
+    if (config->fifo) {
+        struct sched_param param = { .sched_priority = 80 };
+        if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0 && t->id == 0) {
+            fprintf(stderr, "Hinweis: SCHED_FIFO nicht erlaubt, laufe mit SCHED_OTHER\n");
+        }
+    }
+    pthread_barrier_wait(&start_barrier);
+
+    for (long cycle = 0; cycle < config->cycles; ++cycle) {
+        for (int i = 0; i < config->blocks; ++i) {
+            uint64_t t0 = now_ns();
+            void *block;
+            switch (t->kind) {
+            case ALLOC_MALLOC: block = malloc(config->block_size); break;
+            case ALLOC_POOL: block = rt_pool_alloc(&cache); break;
+            default: block = rt_arena_alloc(&arena, config->block_size); break;
+            }
+            record(t, now_ns() - t0);
+            if (block == NULL) {
+                t->failed++;
+            } else {
+                memset(block, (int)i, config->block_size);
+            }
+            blocks[i] = block;
+        }
+        // Blöcke des Nachbarn freigeben, eigene abgeben oder selbst freigeben
+        if (config->cross && t->kind != ALLOC_ARENA) {
+            void *foreign;
+            while ((foreign = ring_pop(t->in)) != NULL) {
+                release(t, &cache, foreign);
+            }
+        }
+        for (int i = 0; i < config->blocks; ++i) {
+            if (blocks[i] == NULL) {
+                continue;
+            }
+            if (config->cross && t->kind != ALLOC_ARENA && (i & 1) && ring_push(t->out, blocks[i])) {
+                continue;
+            }
+            release(t, &cache, blocks[i]);
+        }
+        if (t->kind == ALLOC_ARENA) {
+            rt_arena_reset(&arena);
+        }
+    }
+
+    pthread_barrier_wait(&start_barrier);
+    // Nachzügler aus dem Ring freigeben, erst wenn alle Produzenten fertig sind
+    if (config->cross && t->kind != ALLOC_ARENA) {
+        void *foreign;
+        while ((foreign = ring_pop(t->in)) != NULL) {
+            release(t, &cache, foreign);
+        }
+    }
+    if (t->kind == ALLOC_POOL) {
+        rt_pool_cache_flush(&cache);
+    }
+    if (t->kind == ALLOC_ARENA) {
+        rt_arena_destroy(&arena);
+    }
+    return NULL;
+}
+
+static uint64_t percentile(const uint64_t *hist, uint64_t total, uint64_t max_ns, double p) {
+    uint64_t rank = (uint64_t)(p * (double)total);
+    uint64_t seen = 0;
+    for (uint64_t ns = 0; ns < HIST_NS; ++ns) {
+        seen += hist[ns];
+        if (seen > rank) {
+            return ns;
+        }
+    }
+    return max_ns; // Perzentil liegt im Überlaufbereich
+}
+
+static int run(enum allocator kind, const struct bench_config *config) {
+    struct bench_thread threads[MAX_THREADS];
+    struct handoff_ring *rings = calloc((size_t)config->threads, sizeof(struct handoff_ring));
+    struct rt_pool pool;
+    int have_pool = 0;
+
+    if (rings == NULL) {
+        perror("calloc");
+        return -1;
+    }
+    if (kind == ALLOC_POOL) {
+        // Pro Thread: ein Zyklus, voller Cache und voller Ring, plus Reserve
+        uint32_t blocks = (uint32_t)config->threads * (uint32_t)(config->blocks + RT_POOL_CACHE_SIZE + RING_SIZE) * 2;
+        if (rt_pool_init(&pool, config->block_size, blocks) != 0) {
+            perror("rt_pool_init");
+            free(rings);
+            return -1;
+        }
+        have_pool = 1;
+        if (!pool.locked) {
+            fprintf(stderr, "Hinweis: mlock fehlgeschlagen (ulimit -l), Pool ist nur vorbelegt\n");
+        }
+    }
+
+    pthread_barrier_init(&start_barrier, NULL, (unsigned)config->threads);
+    for (int i = 0; i < config->threads; ++i) {
+        struct bench_thread *t = &threads[i];
+        memset(t, 0, sizeof(*t));
+        t->id = i;
+        t->kind = kind;
+        t->config = config;
+        t->pool = &pool;
+        t->out = &rings[(i + 1) % config->threads];
+        t->in = &rings[i];
+        t->hist = calloc(HIST_NS, sizeof(uint64_t));
+        if (t->hist == NULL) {
+            perror("calloc");
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (int i = 0; i < config->threads; ++i) {
+        pthread_create(&threads[i].tid, NULL, bench_thread_main, &threads[i]);
+    }
+
+    uint64_t *hist = calloc(HIST_NS, sizeof(uint64_t));
+    uint64_t overflow = 0;
+    uint64_t max_ns = 0;
+    uint64_t failed = 0;
+    uint64_t total = 0;
+    for (int i = 0; i < config->threads; ++i) {
+        pthread_join(threads[i].tid, NULL);
+        for (uint64_t ns = 0; ns < HIST_NS; ++ns) {
+            hist[ns] += threads[i].hist[ns];
+            total += threads[i].hist[ns];
+        }
+        overflow += threads[i].overflow;
+        total += threads[i].overflow;
+        failed += threads[i].failed;
+        if (threads[i].max_ns > max_ns) {
+            max_ns = threads[i].max_ns;
+        }
+        free(threads[i].hist);
+    }
+    pthread_barrier_destroy(&start_barrier);
+
+    printf("%-10s %10llu %8llu %8llu %10llu %10llu %8llu\n", allocator_names[kind], (unsigned long long)total,
+           (unsigned long long)percentile(hist, total, max_ns, 0.50),
+           (unsigned long long)percentile(hist, total, max_ns, 0.99),
+           (unsigned long long)percentile(hist, total, max_ns, 0.9999),
+           (unsigned long long)max_ns, (unsigned long long)failed);
+    fflush(stdout);
+
+    free(hist);
+    free(rings);
+    if (have_pool) {
+        rt_pool_destroy(&pool);
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    struct bench_config config = { .threads = 4, .cycles = 200000, .blocks = 16, .block_size = 256, .cross = 0, .fifo = 0 };
+    int opt;
+
+    while ((opt = getopt(argc, argv, "t:c:k:s:xfh")) != -1) {
+        switch (opt) {
+        case 't': config.threads = atoi(optarg); break;
+        case 'c': config.cycles = atol(optarg); break;
+        case 'k': config.blocks = atoi(optarg); break;
+        case 's': config.block_size = (size_t)atol(optarg); break;
+        case 'x': config.cross = 1; break;
+        case 'f': config.fifo = 1; break;
+        default:
+            fprintf(stderr, "Verwendung: %s [-t threads] [-c zyklen] [-k blöcke_pro_zyklus] [-s blockgröße] [-x] [-f]\n", argv[0]);
+            return opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if (config.threads < 1 || config.threads > MAX_THREADS || config.cycles < 1 ||
+        config.blocks < 1 || config.blocks > MAX_BLOCKS || config.block_size == 0) {
+        fprintf(stderr, "Ungültige Parameter\n");
+        return EXIT_FAILURE;
+    }
+
+    printf("Threads: %d, Zyklen: %ld, Blöcke/Zyklus: %d, Blockgröße: %zu, Übergabe an Nachbar: %s\n\n",
+           config.threads, config.cycles, config.blocks, config.block_size, config.cross ? "ja" : "nein");
+    printf("%-10s %10s %8s %8s %10s %10s %8s\n", "Allokator", "Anzahl", "p50", "p99", "p99.99", "max [ns]", "Fehler");
+    for (int kind = ALLOC_MALLOC; kind <= ALLOC_ARENA; ++kind) {
+        if (run((enum allocator)kind, &config) != 0) {
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
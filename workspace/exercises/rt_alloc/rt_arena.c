@@ -0,0 +1,68 @@
+// Bump-Arena und gemeinsame Vorbelegung (siehe rt_alloc.h)
+
+#define _DEFAULT_SOURCE
+
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "rt_alloc.h"
+
+void *rt_alloc_map(size_t bytes, int *locked) {
+    long page = sysconf(_SC_PAGESIZE);
+    bytes = (bytes + (size_t)page - 1) & ~((size_t)page - 1);
+    void *memory = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+    if (memory == MAP_FAILED) {
+        return NULL;
+    }
+    // Jede Seite beschreiben, falls MAP_POPULATE nicht gegriffen hat
+    memset(memory, 0, bytes);
+    *locked = mlock(memory, bytes) == 0;
+    return memory;
+}
+
+void rt_alloc_unmap(void *memory, size_t bytes) {
+    long page = sysconf(_SC_PAGESIZE);
+    bytes = (bytes + (size_t)page - 1) & ~((size_t)page - 1);
+    munlock(memory, bytes);
+    munmap(memory, bytes);
+}
+
+int rt_arena_init(struct rt_arena *arena, size_t size) {
+    memset(arena, 0, sizeof(*arena));
+    if (size == 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    arena->base = rt_alloc_map(size, &arena->locked);
+    if (arena->base == NULL) {
+        return -1;
+    }
+    arena->size = size;
+    return 0;
+}
+
+void rt_arena_destroy(struct rt_arena *arena) {
+    if (arena->base != NULL) {
+        rt_alloc_unmap(arena->base, arena->size);
+    }
+    memset(arena, 0, sizeof(*arena));
+}
+
+void *rt_arena_alloc(struct rt_arena *arena, size_t size) {
+    size_t offset = (arena->used + RT_ALLOC_ALIGN - 1) & ~(size_t)(RT_ALLOC_ALIGN - 1);
+    if (offset > arena->size || size > arena->size - offset) {
+        arena->failed++;
+        return NULL;
+    }
+    arena->used = offset + size;
+    return arena->base + offset;
+}
+
+void rt_arena_reset(struct rt_arena *arena) {
+    if (arena->used > arena->high_water) {
+        arena->high_water = arena->used;
+    }
+    arena->used = 0;
+}
@@ -0,0 +1,134 @@
+// Lock-freier Block-Pool mit Thread-Caches (siehe rt_alloc.h)
+
+#define _DEFAULT_SOURCE
+
+#include <errno.h>
+#include <string.h>
+
+#include "rt_alloc.h"
+
+#define HEAD_INDEX(h) ((uint32_t)(h))
+#define HEAD_VERSION(h) ((uint32_t)((h) >> 32))
+#define MAKE_HEAD(version, index) (((uint64_t)(version) << 32) | (index))
+
+static size_t next_array_bytes(uint32_t num_blocks) {
+    size_t bytes = (size_t)num_blocks * sizeof(uint32_t);
+    return (bytes + RT_ALLOC_ALIGN - 1) & ~(size_t)(RT_ALLOC_ALIGN - 1);
+}
+
+// Verkettete Liste first..last (Indizes + 1) mit einem CAS auf die Freiliste legen
+static void push_chain(struct rt_pool *pool, uint32_t first, uint32_t last, uint32_t count) {
+    uint64_t head = atomic_load_explicit(&pool->head, memory_order_relaxed);
+    do {
+        atomic_store_explicit(&pool->next[last - 1], HEAD_INDEX(head), memory_order_relaxed);
+    } while (!atomic_compare_exchange_weak_explicit(&pool->head, &head,
+                                                    MAKE_HEAD(HEAD_VERSION(head) + 1, first),
+                                                    memory_order_release, memory_order_relaxed));
+    atomic_fetch_add_explicit(&pool->free_blocks, count, memory_order_relaxed);
+}
+
+// Einen Block von der Freiliste nehmen; 0 wenn leer, sonst Index + 1
+static uint32_t pop_one(struct rt_pool *pool) {
+    uint64_t head = atomic_load_explicit(&pool->head, memory_order_acquire);
+    for (;;) {
+        uint32_t index = HEAD_INDEX(head);
+        if (index == 0) {
+            return 0;
+        }
+        // next eines schon entnommenen Blocks kann veraltet sein; dann scheitert das CAS an der Version
+        uint32_t next = atomic_load_explicit(&pool->next[index - 1], memory_order_relaxed);
+        if (atomic_compare_exchange_weak_explicit(&pool->head, &head, MAKE_HEAD(HEAD_VERSION(head) + 1, next),
+                                                  memory_order_acquire, memory_order_acquire)) {
+            atomic_fetch_sub_explicit(&pool->free_blocks, 1, memory_order_relaxed);
+            return index;
+        }
+    }
+}
+
+int rt_pool_init(struct rt_pool *pool, size_t block_size, uint32_t num_blocks) {
+    memset(pool, 0, sizeof(*pool));
+    if (block_size == 0 || num_blocks == 0 || num_blocks == UINT32_MAX) {
+        errno = EINVAL;
+        return -1;
+    }
+    pool->block_size = (block_size + RT_ALLOC_ALIGN - 1) & ~(size_t)(RT_ALLOC_ALIGN - 1);
+    pool->num_blocks = num_blocks;
+    // Nachfolger-Tabelle und Blöcke in einer gesperrten Abbildung
+    size_t next_bytes = next_array_bytes(num_blocks);
+    pool->mapped_bytes = next_bytes + pool->block_size * num_blocks;
+    char *memory = rt_alloc_map(pool->mapped_bytes, &pool->locked);
+    if (memory == NULL) {
+        return -1;
+    }
+    pool->next = (_Atomic uint32_t *)memory;
+    pool->memory = memory + next_bytes;
+
+    for (uint32_t i = 0; i < num_blocks; ++i) {
+        atomic_init(&pool->next[i], i + 1 < num_blocks ? i + 2 : 0);
+    }
+    atomic_init(&pool->head, MAKE_HEAD(0, 1));
+    atomic_init(&pool->free_blocks, num_blocks);
+    return 0;
+}
+
+void rt_pool_destroy(struct rt_pool *pool) {
+    if (pool->next != NULL) {
+        rt_alloc_unmap((void *)pool->next, pool->mapped_bytes);
+    }
+    memset(pool, 0, sizeof(*pool));
+}
+
+void rt_pool_cache_init(struct rt_pool_cache *cache, struct rt_pool *pool) {
+    cache->pool = pool;
+    cache->count = 0;
+}
+
+void rt_pool_cache_flush(struct rt_pool_cache *cache) {
+    if (cache->count == 0) {
+        return;
+    }
+    struct rt_pool *pool = cache->pool;
+    for (uint32_t i = 0; i + 1 < cache->count; ++i) {
+        atomic_store_explicit(&pool->next[cache->blocks[i] - 1], cache->blocks[i + 1], memory_order_relaxed);
+    }
+    push_chain(pool, cache->blocks[0], cache->blocks[cache->count - 1], cache->count);
+    cache->count = 0;
+}
+
+void *rt_pool_alloc(struct rt_pool_cache *cache) {
+    struct rt_pool *pool = cache->pool;
+    if (cache->count == 0) {
+        // Halben Cache nachfüllen, damit der nächste Wechsel nicht sofort wieder die Freiliste braucht
+        while (cache->count < RT_POOL_BATCH) {
+            uint32_t index = pop_one(pool);
+            if (index == 0) {
+                break;
+            }
+            cache->blocks[cache->count++] = index;
+        }
+        if (cache->count == 0) {
+            return NULL;
+        }
+    }
+    uint32_t index = cache->blocks[--cache->count];
+    return pool->memory + (size_t)(index - 1) * pool->block_size;
+}
+
+void rt_pool_free(struct rt_pool_cache *cache, void *block) {
+    struct rt_pool *pool = cache->pool;
+    if (block == NULL) {
+        return;
+    }
+    if (cache->count == RT_POOL_CACHE_SIZE) {
+        // Älteste Hälfte als Kette zurückgeben
+        uint32_t *blocks = cache->blocks;
+        for (uint32_t i = 0; i + 1 < RT_POOL_BATCH; ++i) {
+            atomic_store_explicit(&pool->next[blocks[i] - 1], blocks[i + 1], memory_order_relaxed);
+        }
+        push_chain(pool, blocks[0], blocks[RT_POOL_BATCH - 1], RT_POOL_BATCH);
+        memmove(blocks, blocks + RT_POOL_BATCH, (RT_POOL_CACHE_SIZE - RT_POOL_BATCH) * sizeof(uint32_t));
+        cache->count -= RT_POOL_BATCH;
+    }
+    uint32_t index = (uint32_t)(((char *)block - pool->memory) / pool->block_size) + 1;
+    cache->blocks[cache->count++] = index;
+}
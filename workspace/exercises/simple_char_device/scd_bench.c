@@ -0,0 +1,141 @@
+/*
+Durchsatzmessung für simple_char_device
+
+Startet mehrere Threads, die abwechselnd eine Nachricht schreiben und wieder lesen. Thread i
+verwendet Gerät i % geräte, sodass sich mit -d 1 alle Threads eine Instanz (und deren Mutex)
+teilen und mit -d N die Last auf N Instanzen verteilt wird. Ausgegeben wird der summierte
+Durchsatz aller Threads:
+
+  scd_bench devices <n> threads <n> ops <n> ops_per_s <x> mb_per_s <x>
+
+Aufruf: scd_bench [-d geräte] [-t threads] [-s bytes] [-D sekunden] [-p präfix]
+*/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_MSG 1023 // BUF_LEN - 1 im Treiber
+
+struct bench_thread {
+    pthread_t thread;
+    int fd;
+    uint64_t ops;
+    int failed;
+};
+
+static int msg_size = 64;
+static int duration_s = 5;
+static volatile int running = 1;
+
+static void *bench_main(void *arg) {
+    struct bench_thread *t = arg;
+    char out[MAX_MSG];
+    char in[MAX_MSG + 1];
+
+    memset(out, 'x', sizeof(out));
+    while (running) {
+        if (write(t->fd, out, (size_t)msg_size) != msg_size) {
+            t->failed = errno;
+            break;
+        }
+        // Lesen ab Offset 0, ohne Seek: pread ändert die Dateiposition nicht
+        if (pread(t->fd, in, sizeof(in), 0) < 0) {
+            t->failed = errno;
+            break;
+        }
+        t->ops++;
+    }
+    return NULL;
+}
+
+int main(int argc, char *argv[]) {
+    const char *prefix = "/dev/simple_char_device";
+    int num_devices = 1;
+    int num_threads = 4;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "d:t:s:D:p:")) != -1) {
+        switch (opt) {
+        case 'd':
+            num_devices = atoi(optarg);
+            break;
+        case 't':
+            num_threads = atoi(optarg);
+            break;
+        case 's':
+            msg_size = atoi(optarg);
+            break;
+        case 'D':
+            duration_s = atoi(optarg);
+            break;
+        case 'p':
+            prefix = optarg;
+            break;
+        default:
+            fprintf(stderr, "Verwendung: %s [-d geräte] [-t threads] [-s bytes] [-D sekunden] [-p präfix]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+    if (num_devices < 1 || num_threads < 1 || msg_size < 1 || msg_size > MAX_MSG || duration_s < 1) {
+        fprintf(stderr, "Ungültige Parameter (1 <= bytes <= %d)\n", MAX_MSG);
+        return 1;
+    }
+
+    struct bench_thread *threads = calloc((size_t)num_threads, sizeof(*threads));
+    if (threads == NULL) {
+        perror("calloc");
+        return 1;
+    }
+    for (int i = 0; i < num_threads; ++i) {
+        char path[256];
+        snprintf(path, sizeof(path), "%s%d", prefix, i % num_devices);
+        threads[i].fd = open(path, O_RDWR);
+        if (threads[i].fd < 0) {
+            perror(path);
+            return 1;
+        }
+    }
+
+    struct timespec start;
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < num_threads; ++i) {
+        int err = pthread_create(&threads[i].thread, NULL, bench_main, &threads[i]);
+        if (err != 0) {
+            fprintf(stderr, "pthread_create: %s\n", strerror(err));
+            return 1;
+        }
+    }
+    sleep((unsigned int)duration_s);
+    running = 0;
+
+    uint64_t total = 0;
+    int failed = 0;
+    for (int i = 0; i < num_threads; ++i) {
+        pthread_join(threads[i].thread, NULL);
+        total += threads[i].ops;
+        if (threads[i].failed != 0) {
+            fprintf(stderr, "Thread %d: %s\n", i, strerror(threads[i].failed));
+            failed = 1;
+        }
+        close(threads[i].fd);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    free(threads);
+
+    double elapsed = (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) / 1e9;
+    double ops_per_s = (double)total / elapsed;
+    // Pro Operation ein Schreiben und ein Lesen der Nachricht
+    double mb_per_s = ops_per_s * 2.0 * msg_size / (1024.0 * 1024.0);
+    printf("scd_bench devices %d threads %d ops %llu ops_per_s %.0f mb_per_s %.1f\n", num_devices, num_threads,
+           (unsigned long long)total, ops_per_s, mb_per_s);
+    return failed;
+}
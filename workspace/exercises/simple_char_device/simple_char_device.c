@@ -10,28 +10,67 @@ Vervollständige den bereitgestellten Code für den einfachen Zeichengerätetrei
 sowie die Geräteoperationen implementierst.
 Stelle sicher, dass der Treiber korrekt kompiliert und als Kernel-Modul geladen werden kann.
 Teste den Treiber, indem du ihn lädst, eine Datei schreibst, liest und anschließend den Treiber entlädst.
+
+Erweiterung: mehrere Instanzen
+Der Treiber legt num_devices Geräte /dev/simple_char_device0..N-1 an (dynamische Minor-Nummern
+über alloc_chrdev_region, cdev und eine Geräteklasse). Jede Instanz hat eigenen Puffer, eigene
+Sperre und eigene Statistik (/sys/class/simple_char_device/simple_char_deviceN/stats), damit
+unabhängige Erzeuger sich nicht mehr an einem globalen Mutex blockieren. Mit per_open=1 erhält
+jedes open() einen privaten Puffer.
+
+Laden: insmod simple_char_device.ko [num_devices=4] [per_open=0]
 */
 
 #include <linux/module.h>
 #include <linux/kernel.h>
 #include <linux/fs.h>
+#include <linux/cdev.h>
+#include <linux/device.h>
 #include <linux/uaccess.h>
 #include <linux/slab.h>
 #include <linux/mutex.h>
+#include <linux/atomic.h>
+#include <linux/version.h>
 
 #define DEVICE_NAME "simple_char_device"
 #define BUF_LEN 1024
+#define MAX_DEVICES 64
+
+static unsigned int num_devices = 4;
+module_param(num_devices, uint, 0444);
+MODULE_PARM_DESC(num_devices, "Anzahl der Geräteinstanzen (1-64, Standard 4)");
+
+static bool per_open;
+module_param(per_open, bool, 0444);
+MODULE_PARM_DESC(per_open, "Eigener Puffer pro open() statt eines Puffers pro Gerät");
+
+/* Puffer mit eigener Sperre: einer pro Gerät oder, mit per_open, einer pro geöffneter Datei */
+struct scd_buffer {
+    struct mutex lock;
+    char data[BUF_LEN];
+    size_t size;
+};
+
+struct scd_device {
+    struct cdev cdev;
+    struct device *dev;
+    struct scd_buffer buffer;
+    atomic64_t opens;
+    atomic64_t reads;
+    atomic64_t writes;
+    atomic64_t bytes_read;
+    atomic64_t bytes_written;
+};
 
-static int major;
-static char *device_buffer;
-static int device_buffer_size = 0;
-static DEFINE_MUTEX(device_mutex);
+static dev_t first_devt;
+static struct class *scd_class;
+static struct scd_device *devices;
 
 // Funktionsprototypen
 static int device_open(struct inode *, struct file *);
 static int device_release(struct inode *, struct file *);
-static ssize_t device_read(struct file *, char *, size_t, loff_t *);
-static ssize_t device_write(struct file *, const char *, size_t, loff_t *);
+static ssize_t device_read(struct file *, char __user *, size_t, loff_t *);
+static ssize_t device_write(struct file *, const char __user *, size_t, loff_t *);
 
 /* File-Operationsstruktur*/
 static struct file_operations fops = {
@@ -42,129 +81,255 @@ static struct file_operations fops = {
     .release = device_release
 };
 
+/* Statistik je Gerät: cat /sys/class/simple_char_device/simple_char_device0/stats */
+static ssize_t stats_show(struct device *dev, struct device_attribute *attr, char *buf) {
+    struct scd_device *scd = dev_get_drvdata(dev);
+
+    return sysfs_emit(buf, "opens %lld\nreads %lld\nwrites %lld\nbytes_read %lld\nbytes_written %lld\n",
+                      atomic64_read(&scd->opens), atomic64_read(&scd->reads), atomic64_read(&scd->writes),
+                      atomic64_read(&scd->bytes_read), atomic64_read(&scd->bytes_written));
+}
+
+/* Schreiben setzt die Statistik zurück */
+static ssize_t stats_store(struct device *dev, struct device_attribute *attr, const char *buf, size_t count) {
+    struct scd_device *scd = dev_get_drvdata(dev);
+
+    atomic64_set(&scd->opens, 0);
+    atomic64_set(&scd->reads, 0);
+    atomic64_set(&scd->writes, 0);
+    atomic64_set(&scd->bytes_read, 0);
+    atomic64_set(&scd->bytes_written, 0);
+    return count;
+}
+static DEVICE_ATTR_RW(stats);
+
+static struct attribute *scd_attrs[] = {
+    &dev_attr_stats.attr,
+    NULL
+};
+ATTRIBUTE_GROUPS(scd);
+
+/* Jede Instanz über die Geräteklasse lesbar für alle anlegen (wie zuvor chmod 666) */
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 2, 0)
+static char *scd_devnode(const struct device *dev, umode_t *mode)
+#else
+static char *scd_devnode(struct device *dev, umode_t *mode)
+#endif
+{
+    if (mode) {
+        *mode = 0666;
+    }
+    return NULL;
+}
+
+static void scd_buffer_init(struct scd_buffer *buf) {
+    mutex_init(&buf->lock);
+    memset(buf->data, 0, BUF_LEN);
+    buf->size = 0;
+}
+
+/* Bereits angelegte Instanzen in umgekehrter Reihenfolge entfernen */
+static void scd_destroy_devices(unsigned int count) {
+    while (count > 0) {
+        count--;
+        device_destroy(scd_class, MKDEV(MAJOR(first_devt), count));
+        cdev_del(&devices[count].cdev);
+    }
+}
+
 /* Initialisierungsfunktion */
 static int __init simple_char_init(void) {
-    printk(KERN_INFO "Simple Char Device: Initializing...\n");
-    
-    /* Speicher für den Puffer allokieren */
-    device_buffer = kmalloc(BUF_LEN, GFP_KERNEL);
-    if (!device_buffer) {
+    unsigned int i;
+    int ret;
+
+    printk(KERN_INFO "Simple Char Device: Initializing %u devices...\n", num_devices);
+
+    if (num_devices < 1 || num_devices > MAX_DEVICES) {
+        printk(KERN_ALERT "Simple Char Device: num_devices must be between 1 and %d\n", MAX_DEVICES);
+        return -EINVAL;
+    }
+
+    /* Speicher für die Instanzen allokieren */
+    devices = kcalloc(num_devices, sizeof(*devices), GFP_KERNEL);
+    if (!devices) {
         printk(KERN_ALERT "Simple Char Device: Failed to allocate memory\n");
         return -ENOMEM;
     }
-    
-    /* Puffer initialisieren */
-    memset(device_buffer, 0, BUF_LEN);
-    device_buffer_size = 0;
-    
-    /* Character Device registrieren */
-    major = register_chrdev(0, DEVICE_NAME, &fops);
-    if (major < 0) {
-        printk(KERN_ALERT "Simple Char Device: Failed to register device with %d\n", major);
-        kfree(device_buffer);
-        return major;
+
+    /* Major- und Minor-Nummern dynamisch reservieren */
+    ret = alloc_chrdev_region(&first_devt, 0, num_devices, DEVICE_NAME);
+    if (ret < 0) {
+        printk(KERN_ALERT "Simple Char Device: Failed to allocate device numbers with %d\n", ret);
+        goto err_free;
+    }
+
+    /* Geräteklasse: udev/devtmpfs legen die /dev-Knoten automatisch an */
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 4, 0)
+    scd_class = class_create(DEVICE_NAME);
+#else
+    scd_class = class_create(THIS_MODULE, DEVICE_NAME);
+#endif
+    if (IS_ERR(scd_class)) {
+        ret = PTR_ERR(scd_class);
+        printk(KERN_ALERT "Simple Char Device: Failed to create device class with %d\n", ret);
+        goto err_region;
     }
-    
-    printk(KERN_INFO "Simple Char Device: Registered with major number %d\n", major);
-    printk(KERN_INFO "To create device file, run: mknod /dev/%s c %d 0\n", DEVICE_NAME, major);
-    
+    scd_class->devnode = scd_devnode;
+
+    for (i = 0; i < num_devices; i++) {
+        struct scd_device *scd = &devices[i];
+        dev_t devt = MKDEV(MAJOR(first_devt), i);
+
+        scd_buffer_init(&scd->buffer);
+        cdev_init(&scd->cdev, &fops);
+        scd->cdev.owner = THIS_MODULE;
+        ret = cdev_add(&scd->cdev, devt, 1);
+        if (ret < 0) {
+            printk(KERN_ALERT "Simple Char Device: Failed to add device %u with %d\n", i, ret);
+            goto err_devices;
+        }
+
+        scd->dev = device_create_with_groups(scd_class, NULL, devt, scd, scd_groups, DEVICE_NAME "%u", i);
+        if (IS_ERR(scd->dev)) {
+            ret = PTR_ERR(scd->dev);
+            printk(KERN_ALERT "Simple Char Device: Failed to create device %u with %d\n", i, ret);
+            cdev_del(&scd->cdev);
+            goto err_devices;
+        }
+    }
+
+    printk(KERN_INFO "Simple Char Device: Registered with major number %d\n", MAJOR(first_devt));
+    printk(KERN_INFO "Simple Char Device: Devices /dev/%s0../dev/%s%u, %s buffers\n", DEVICE_NAME, DEVICE_NAME,
+           num_devices - 1, per_open ? "per-open" : "per-device");
+
     return 0;
+
+err_devices:
+    scd_destroy_devices(i);
+    class_destroy(scd_class);
+err_region:
+    unregister_chrdev_region(first_devt, num_devices);
+err_free:
+    kfree(devices);
+    devices = NULL;
+    return ret;
 }
 
 /* Aufräumfunktion */
 static void __exit simple_char_exit(void) {
-    /* Character Device deregistrieren */
-    unregister_chrdev(major, DEVICE_NAME);
-    
+    /* Geräte, Klasse und Gerätenummern freigeben */
+    scd_destroy_devices(num_devices);
+    class_destroy(scd_class);
+    unregister_chrdev_region(first_devt, num_devices);
+
     /* Speicher freigeben */
-    if (device_buffer) {
-        kfree(device_buffer);
-        device_buffer = NULL;
-    }
-    
+    kfree(devices);
+    devices = NULL;
+
     printk(KERN_INFO "Simple Char Device: Unregistered and cleaned up\n");
 }
 
 /* Gerät öffnen */
 static int device_open(struct inode *inode, struct file *file) {
-    printk(KERN_INFO "Simple Char Device: Device opened\n");
-    
-    /* Referenzzähler erhöhen */
-    try_module_get(THIS_MODULE);
-    
+    struct scd_device *scd = container_of(inode->i_cdev, struct scd_device, cdev);
+    struct scd_buffer *buf = &scd->buffer;
+
+    if (per_open) {
+        buf = kmalloc(sizeof(*buf), GFP_KERNEL);
+        if (!buf) {
+            return -ENOMEM;
+        }
+        scd_buffer_init(buf);
+    }
+    file->private_data = buf;
+    atomic64_inc(&scd->opens);
+
+    /* Kein Log pro Operation: printk würde parallele Zugriffe wieder serialisieren */
+    pr_debug("Simple Char Device: Device %u opened\n", iminor(inode));
+
     return 0;
 }
 
 /* Gerät schließen */
 static int device_release(struct inode *inode, struct file *file) {
-    printk(KERN_INFO "Simple Char Device: Device closed\n");
-    
-    /* Referenzzähler verringern */
-    module_put(THIS_MODULE);
-    
+    struct scd_device *scd = container_of(inode->i_cdev, struct scd_device, cdev);
+
+    if (file->private_data != &scd->buffer) {
+        kfree(file->private_data);
+    }
+    pr_debug("Simple Char Device: Device %u closed\n", iminor(inode));
+
     return 0;
 }
 
 /* Vom Gerät lesen */
 static ssize_t device_read(struct file *filp, char __user *buffer, size_t length, loff_t *offset) {
-    int bytes_read = 0;
-    
-    /* Mutex für Thread-Sicherheit */
-    if (mutex_lock_interruptible(&device_mutex)) {
+    struct scd_device *scd = container_of(file_inode(filp)->i_cdev, struct scd_device, cdev);
+    struct scd_buffer *buf = filp->private_data;
+    size_t bytes_read;
+
+    /* Mutex der Instanz für Thread-Sicherheit */
+    if (mutex_lock_interruptible(&buf->lock)) {
         return -ERESTARTSYS;
     }
-    
+
     /* Überprüfen, ob noch Daten zu lesen sind */
-    if (*offset >= device_buffer_size) {
-        mutex_unlock(&device_mutex);
+    if (*offset >= buf->size) {
+        mutex_unlock(&buf->lock);
         return 0; /* EOF */
     }
-    
+
     /* Anzahl der zu lesenden Bytes berechnen */
-    bytes_read = min(length, (size_t)(device_buffer_size - *offset));
-    
+    bytes_read = min(length, (size_t)(buf->size - *offset));
+
     /* Daten in den Benutzerpuffer kopieren */
-    if (copy_to_user(buffer, device_buffer + *offset, bytes_read)) {
-        mutex_unlock(&device_mutex);
+    if (copy_to_user(buffer, buf->data + *offset, bytes_read)) {
+        mutex_unlock(&buf->lock);
         return -EFAULT;
     }
-    
+
     /* Offset aktualisieren */
     *offset += bytes_read;
-    
-    mutex_unlock(&device_mutex);
-    
-    printk(KERN_INFO "Simple Char Device: Read %d bytes\n", bytes_read);
-    
+
+    mutex_unlock(&buf->lock);
+
+    atomic64_inc(&scd->reads);
+    atomic64_add(bytes_read, &scd->bytes_read);
+    pr_debug("Simple Char Device: Read %zu bytes\n", bytes_read);
+
     return bytes_read;
 }
 
 /* Ins Gerät schreiben */
 static ssize_t device_write(struct file *filp, const char __user *buff, size_t len, loff_t *off) {
-    int bytes_to_write;
-    
-    /* Mutex für Thread-Sicherheit */
-    if (mutex_lock_interruptible(&device_mutex)) {
+    struct scd_device *scd = container_of(file_inode(filp)->i_cdev, struct scd_device, cdev);
+    struct scd_buffer *buf = filp->private_data;
+    size_t bytes_to_write;
+
+    /* Mutex der Instanz für Thread-Sicherheit */
+    if (mutex_lock_interruptible(&buf->lock)) {
         return -ERESTARTSYS;
     }
-    
+
     /* Anzahl der zu schreibenden Bytes berechnen */
     bytes_to_write = min(len, (size_t)(BUF_LEN - 1));
-    
+
     /* Daten vom Benutzerpuffer kopieren */
-    if (copy_from_user(device_buffer, buff, bytes_to_write)) {
-        mutex_unlock(&device_mutex);
+    if (copy_from_user(buf->data, buff, bytes_to_write)) {
+        mutex_unlock(&buf->lock);
         return -EFAULT;
     }
-    
+
     /* Null-Terminierung sicherstellen */
-    device_buffer[bytes_to_write] = '\0';
-    device_buffer_size = bytes_to_write;
-    
-    mutex_unlock(&device_mutex);
-    
-    printk(KERN_INFO "Simple Char Device: Written %d bytes\n", bytes_to_write);
-    
+    buf->data[bytes_to_write] = '\0';
+    buf->size = bytes_to_write;
+
+    mutex_unlock(&buf->lock);
+
+    atomic64_inc(&scd->writes);
+    atomic64_add(bytes_to_write, &scd->bytes_written);
+    pr_debug("Simple Char Device: Written %zu bytes\n", bytes_to_write);
+
     return bytes_to_write;
 }
 
@@ -173,6 +338,6 @@ module_init(simple_char_init);
 module_exit(simple_char_exit);
 
 MODULE_LICENSE("GPL");
-MODULE_DESCRIPTION("A simple character device driver");
+MODULE_DESCRIPTION("A simple character device driver with multiple instances");
 MODULE_AUTHOR("Linux Driver Developer");
-MODULE_VERSION("1.0");
\ No newline at end of file
+MODULE_VERSION("2.0");
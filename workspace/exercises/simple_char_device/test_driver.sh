@@ -24,9 +24,27 @@ if [ $? -ne 0 ]; then
 fi
 echo -e "${GREEN}Kompilierung erfolgreich!${NC}"
 
+NUM_DEVICES=4
+DEV=/dev/simple_char_device0
+
+# Legt fehlende /dev-Knoten aus /sys/class an (ohne udev, z.B. im Container)
+create_nodes() {
+    udevadm settle 2>/dev/null
+    for dev in /sys/class/simple_char_device/simple_char_device*; do
+        name=$(basename "$dev")
+        if [ ! -e "/dev/$name" ]; then
+            mknod -m 666 "/dev/$name" c "$(cut -d: -f1 "$dev/dev")" "$(cut -d: -f2 "$dev/dev")"
+        fi
+    done
+}
+
+remove_nodes() {
+    rm -f /dev/simple_char_device[0-9]*
+}
+
 # Schritt 2: Treiber laden
-echo -e "${YELLOW}Schritt 2: Treiber laden${NC}"
-insmod simple_char_device.ko
+echo -e "${YELLOW}Schritt 2: Treiber laden ($NUM_DEVICES Instanzen)${NC}"
+insmod simple_char_device.ko num_devices=$NUM_DEVICES
 if [ $? -ne 0 ]; then
     echo -e "${RED}Treiber konnte nicht geladen werden!${NC}"
     exit 1
@@ -34,7 +52,7 @@ fi
 echo -e "${GREEN}Treiber erfolgreich geladen!${NC}"
 
 # Major-Nummer aus dmesg extrahieren
-MAJOR=$(dmesg | grep "Simple Char Device: Registered with major number" | tail -1 | grep -o '[0-9]\+')
+MAJOR=$(dmesg | grep "Simple Char Device: Registered with major number" | tail -1 | grep -o '[0-9]\+$')
 if [ -z "$MAJOR" ]; then
     echo -e "${RED}Konnte Major-Nummer nicht ermitteln!${NC}"
     rmmod simple_char_device
@@ -42,24 +60,26 @@ if [ -z "$MAJOR" ]; then
 fi
 echo -e "${GREEN}Major-Nummer: $MAJOR${NC}"
 
-# Schritt 3: Device-Datei erstellen
-echo -e "${YELLOW}Schritt 3: Device-Datei erstellen${NC}"
-mknod /dev/simple_char_device c $MAJOR 0
-chmod 666 /dev/simple_char_device
-if [ ! -e /dev/simple_char_device ]; then
-    echo -e "${RED}Device-Datei konnte nicht erstellt werden!${NC}"
-    rmmod simple_char_device
-    exit 1
-fi
-echo -e "${GREEN}Device-Datei erfolgreich erstellt!${NC}"
+# Schritt 3: Device-Dateien prüfen (angelegt über die Geräteklasse)
+echo -e "${YELLOW}Schritt 3: Device-Dateien prüfen${NC}"
+create_nodes
+for i in $(seq 0 $((NUM_DEVICES - 1))); do
+    if [ ! -c /dev/simple_char_device$i ]; then
+        echo -e "${RED}Device-Datei /dev/simple_char_device$i fehlt!${NC}"
+        remove_nodes
+        rmmod simple_char_device
+        exit 1
+    fi
+done
+echo -e "${GREEN}Device-Dateien vorhanden: $(ls /dev/simple_char_device[0-9]* | tr '\n' ' ')${NC}"
 
 # Schritt 4: Schreibtest
 echo -e "${YELLOW}Schritt 4: Schreibtest${NC}"
 TEST_STRING="Hello, Linux Kernel Module!"
-echo "$TEST_STRING" > /dev/simple_char_device
+echo "$TEST_STRING" > $DEV
 if [ $? -ne 0 ]; then
     echo -e "${RED}Schreibtest fehlgeschlagen!${NC}"
-    rm -f /dev/simple_char_device
+    remove_nodes
     rmmod simple_char_device
     exit 1
 fi
@@ -67,7 +87,7 @@ echo -e "${GREEN}Schreibtest erfolgreich!${NC}"
 
 # Schritt 5: Lesetest
 echo -e "${YELLOW}Schritt 5: Lesetest${NC}"
-READ_STRING=$(cat /dev/simple_char_device)
+READ_STRING=$(cat $DEV)
 if [ "$READ_STRING" = "$TEST_STRING" ]; then
     echo -e "${GREEN}Lesetest erfolgreich!${NC}"
     echo -e "${GREEN}Geschrieben: '$TEST_STRING'${NC}"
@@ -81,8 +101,8 @@ fi
 # Schritt 6: Mehrfache Lese-/Schreibtests
 echo -e "${YELLOW}Schritt 6: Mehrfache Tests${NC}"
 for i in {1..3}; do
-    echo "Test $i" > /dev/simple_char_device
-    RESULT=$(cat /dev/simple_char_device)
+    echo "Test $i" > $DEV
+    RESULT=$(cat $DEV)
     if [ "$RESULT" = "Test $i" ]; then
         echo -e "${GREEN}Test $i: OK${NC}"
     else
@@ -90,13 +110,53 @@ for i in {1..3}; do
     fi
 done
 
-# Schritt 7: Kernel-Logs anzeigen
-echo -e "${YELLOW}Schritt 7: Kernel-Logs (letzte 10 Zeilen)${NC}"
+# Schritt 7: Instanzen sind unabhängig
+echo -e "${YELLOW}Schritt 7: Unabhängige Instanzen${NC}"
+for i in $(seq 0 $((NUM_DEVICES - 1))); do
+    echo "Instanz $i" > /dev/simple_char_device$i
+done
+for i in $(seq 0 $((NUM_DEVICES - 1))); do
+    RESULT=$(cat /dev/simple_char_device$i)
+    if [ "$RESULT" = "Instanz $i" ]; then
+        echo -e "${GREEN}Gerät $i: OK${NC}"
+    else
+        echo -e "${RED}Gerät $i: FEHLER (erhalten: '$RESULT')${NC}"
+    fi
+done
+echo "Statistik Gerät 0:"
+sed 's/^/  /' /sys/class/simple_char_device/simple_char_device0/stats
+
+# Schritt 8: Durchsatz bei steigender Instanzanzahl
+echo -e "${YELLOW}Schritt 8: Durchsatz mit $NUM_DEVICES Threads auf 1..$NUM_DEVICES Instanzen${NC}"
+for n in 1 2 4; do
+    [ $n -le $NUM_DEVICES ] && ./scd_bench -d $n -t $NUM_DEVICES -D 2
+done
+
+# Schritt 9: Private Puffer pro open()
+echo -e "${YELLOW}Schritt 9: Private Puffer pro open() (per_open=1)${NC}"
+remove_nodes
+rmmod simple_char_device
+insmod simple_char_device.ko num_devices=1 per_open=1
+create_nodes
+exec 3<>$DEV 4<>$DEV
+echo "Puffer A" >&3
+echo "Puffer B" >&4
+RESULT_A=$(cat <&3)
+RESULT_B=$(cat <&4)
+exec 3>&- 4>&-
+if [ "$RESULT_A" = "Puffer A" ] && [ "$RESULT_B" = "Puffer B" ]; then
+    echo -e "${GREEN}Getrennte Puffer: OK${NC}"
+else
+    echo -e "${RED}Getrennte Puffer: FEHLER ('$RESULT_A', '$RESULT_B')${NC}"
+fi
+
+# Schritt 10: Kernel-Logs anzeigen
+echo -e "${YELLOW}Schritt 10: Kernel-Logs (letzte 10 Zeilen)${NC}"
 dmesg | grep "Simple Char Device" | tail -10
 
-# Schritt 8: Aufräumen
-echo -e "${YELLOW}Schritt 8: Aufräumen${NC}"
-rm -f /dev/simple_char_device
+# Schritt 11: Aufräumen
+echo -e "${YELLOW}Schritt 11: Aufräumen${NC}"
+remove_nodes
 rmmod simple_char_device
 if [ $? -eq 0 ]; then
     echo -e "${GREEN}Treiber erfolgreich entladen!${NC}"
@@ -0,0 +1,242 @@
+#!/bin/bash
+# Inhaltsadressierter Build-Cache für Kernel, Module und Device Trees
+#
+# Jede Konfiguration wird out-of-tree (O=) in einem eigenen Verzeichnis gebaut, dessen Name ein
+# Hash aus Kernel-Version, Architektur und normalisierter .config ist. Ein bereits gebauter Hash
+# wird sofort aus den gespeicherten Artefakten wiederhergestellt; geänderte Konfigurationen
+# profitieren über ccache von allen vorherigen Builds. Mehrere Builds können parallel laufen,
+# gleiche Hashes werden per flock serialisiert.
+#
+# Verwendung:
+#   ./kernel_build_cache.sh build <config> [install_dir] [label]
+#   ./kernel_build_cache.sh hash <config>
+#   ./kernel_build_cache.sh stats
+#   ./kernel_build_cache.sh prune [anzahl]   behält die zuletzt benutzten Builds
+#
+# Umgebungsvariablen: JOBS (Standard nproc), CACHE_DIR, CCACHE_DIR, USE_CCACHE=0 zum Abschalten
+
+set -e
+
+KERNEL_VERSION="6.15.6"
+WORK_DIR="/home/developer/workspace/kernel_build"
+KERNEL_DIR="$WORK_DIR/linux-$KERNEL_VERSION"
+CACHE_DIR="${CACHE_DIR:-$WORK_DIR/build_cache}"
+STATS_FILE="$CACHE_DIR/stats.csv"
+JOBS="${JOBS:-$(nproc)}"
+USE_CCACHE="${USE_CCACHE:-1}"
+
+export ARCH="arm64"
+export CROSS_COMPILE="${CROSS_COMPILE:-aarch64-linux-gnu-}"
+
+# Reproduzierbare Build-Metadaten: sonst ändert sich init/version.c bei jedem Build
+export KBUILD_BUILD_TIMESTAMP="kernel_build_cache"
+export KBUILD_BUILD_USER="developer"
+export KBUILD_BUILD_HOST="linux-dev-env"
+
+# ccache: Pfade relativ zu WORK_DIR hashen, damit alle O=-Verzeichnisse Treffer teilen.
+# ccache wird über CC vor den Cross-Compiler gesetzt; CROSS_COMPILE selbst bleibt unverändert,
+# weil ld, objcopy usw. ebenfalls davon abgeleitet werden.
+MAKE_CC=()
+if [ "$USE_CCACHE" = "1" ] && command -v ccache >/dev/null 2>&1; then
+    export CCACHE_DIR="${CCACHE_DIR:-$WORK_DIR/ccache}"
+    export CCACHE_BASEDIR="$WORK_DIR"
+    export CCACHE_NOHASHDIR=1
+    export CCACHE_COMPILERCHECK=content
+    MAKE_CC=(CC="ccache ${CROSS_COMPILE}gcc")
+fi
+
+# Normalisierte Konfiguration: Kommentare und Leerzeilen raus, sortiert
+normalize_config() {
+    grep -v -e '^#' -e '^$' "$1" | LC_ALL=C sort
+}
+
+config_hash() {
+    {
+        echo "version=$KERNEL_VERSION"
+        echo "arch=$ARCH"
+        normalize_config "$1"
+    } | sha256sum | cut -c1-16
+}
+
+# O=-Builds verlangen einen sauberen Quellbaum (keine In-Tree-.config)
+prepare_srctree() {
+    exec 8> "$CACHE_DIR/srctree.lock"
+    flock 8
+    if [ -f "$KERNEL_DIR/.config" ] || [ -d "$KERNEL_DIR/include/config" ]; then
+        echo "Quellbaum enthält einen In-Tree-Build, sichere .config und räume auf (mrproper)..."
+        [ -f "$KERNEL_DIR/.config" ] && cp "$KERNEL_DIR/.config" "$WORK_DIR/intree.config.backup"
+        make -C "$KERNEL_DIR" mrproper > /dev/null
+    fi
+    flock -u 8
+}
+
+# Zählt Ergebnisse im Stats-Log eines einzelnen Builds (CCACHE_STATSLOG, ccache >= 4).
+# Die globalen Zähler aus ccache --print-stats mischen parallel laufende Builds.
+ccache_log_count() {
+    local log="$1"
+    shift
+    local key args=()
+    for key in "$@"; do
+        args+=(-e "$key")
+    done
+    if [ -f "$log" ]; then
+        grep -c -x "${args[@]}" "$log" || true
+    else
+        echo 0
+    fi
+}
+
+cmd_build() {
+    local config="$1"
+    local install_dir="$2"
+    local label="${3:-$(basename "$config")}"
+
+    if [ ! -f "$config" ]; then
+        echo "Fehler: Konfiguration nicht gefunden: $config"
+        exit 1
+    fi
+    mkdir -p "$CACHE_DIR/builds"
+    [ -f "$STATS_FILE" ] || echo "datum,label,hash,ergebnis,sekunden,ccache_treffer,ccache_fehler" > "$STATS_FILE"
+    prepare_srctree
+
+    # Konfiguration zuerst normalisieren (olddefconfig), damit gleiche Inhalte gleich hashen
+    local staging
+    staging="$(mktemp -d "$CACHE_DIR/staging.XXXXXX")"
+    cp "$config" "$staging/.config"
+    make -C "$KERNEL_DIR" O="$staging" "${MAKE_CC[@]}" olddefconfig > /dev/null
+    local hash
+    hash="$(config_hash "$staging/.config")"
+    local build_dir="$CACHE_DIR/builds/$hash"
+
+    # Pro Hash nur ein Build gleichzeitig; andere Hashes laufen parallel weiter
+    exec 9> "$CACHE_DIR/builds/$hash.lock"
+    flock 9
+
+    local start=$SECONDS
+    local result
+    if [ -f "$build_dir/artifacts/.complete" ]; then
+        result="hit"
+        rm -rf "$staging"
+        echo "[$label] Cache-Treffer $hash"
+    else
+        result="miss"
+
+        if [ -d "$build_dir" ]; then
+            # Abgebrochener Build: Objekte weiterverwenden
+            cp "$staging/.config" "$build_dir/.config"
+            rm -rf "$staging"
+        else
+            mv "$staging" "$build_dir"
+        fi
+        echo "[$label] Cache-Fehlschlag $hash, baue in $build_dir"
+
+        local statslog="$build_dir/ccache_stats.log"
+        rm -f "$statslog"
+        CCACHE_STATSLOG="$statslog" make -C "$KERNEL_DIR" O="$build_dir" "${MAKE_CC[@]}" -j"$JOBS" Image modules dtbs \
+            > "$build_dir/build.log" 2>&1 || {
+            echo "[$label] ✗ Build fehlgeschlagen, siehe $build_dir/build.log"
+            exit 1
+        }
+
+        local artifacts="$build_dir/artifacts"
+        rm -rf "$artifacts"
+        mkdir -p "$artifacts/boot"
+        cp "$build_dir/arch/arm64/boot/Image" "$artifacts/boot/"
+        make -C "$KERNEL_DIR" O="$build_dir" INSTALL_MOD_PATH="$artifacts" modules_install > /dev/null
+        make -C "$KERNEL_DIR" O="$build_dir" INSTALL_DTBS_PATH="$artifacts/dtbs" dtbs_install > /dev/null
+        cp "$build_dir/.config" "$artifacts/config"
+        make -s -C "$KERNEL_DIR" O="$build_dir" kernelrelease > "$artifacts/kernelrelease"
+
+        local cc_hits cc_miss
+        cc_hits=$(ccache_log_count "$statslog" direct_cache_hit preprocessed_cache_hit)
+        cc_miss=$(ccache_log_count "$statslog" cache_miss)
+        echo "$((SECONDS - start))" > "$artifacts/.complete"
+    fi
+    local elapsed=$((SECONDS - start))
+    touch "$build_dir"
+
+    if [ -n "$install_dir" ]; then
+        # Wiederherstellen: nur kopieren, kein Compiler-Aufruf
+        mkdir -p "$install_dir/boot" "$install_dir/lib"
+        cp "$build_dir/artifacts/boot/Image" "$install_dir/boot/"
+        find "$build_dir/artifacts/dtbs" -name "bcm2712*.dtb" -exec cp {} "$install_dir/boot/" \; 2>/dev/null || true
+        rm -rf "$install_dir/lib/modules/$(cat "$build_dir/artifacts/kernelrelease")"
+        cp -a "$build_dir/artifacts/lib/modules" "$install_dir/lib/"
+        cp "$build_dir/artifacts/config" "$install_dir/boot/config"
+    fi
+    flock -u 9
+
+    echo "$(date +%Y-%m-%dT%H:%M:%S),$label,$hash,$result,$elapsed,${cc_hits:-0},${cc_miss:-0}" >> "$STATS_FILE"
+    if [ "$result" = "hit" ]; then
+        echo "[$label] ✓ In $elapsed s wiederhergestellt"
+    else
+        local total=$((cc_hits + cc_miss))
+        if [ "$total" -gt 0 ]; then
+            echo "[$label] ✓ Gebaut in $elapsed s (ccache: $cc_hits Treffer, $cc_miss Fehlschläge, $((cc_hits * 100 / total)) %)"
+        else
+            echo "[$label] ✓ Gebaut in $elapsed s (keine ccache-Statistik)"
+        fi
+    fi
+    echo "[$label] Artefakte: $build_dir/artifacts"
+}
+
+cmd_stats() {
+    if [ ! -f "$STATS_FILE" ]; then
+        echo "Noch keine Builds im Cache: $CACHE_DIR"
+        return
+    fi
+    echo "=== Build-Cache: $CACHE_DIR ==="
+    awk -F, 'NR > 1 {
+        runs++; if ($4 == "hit") hits++
+        n[$2]++; t[$2] += $5; if ($4 == "hit") h[$2]++
+        if ($4 == "miss") { mt[$2] += $5; mn[$2]++; ch[$2] += $6; cm[$2] += $7 }
+        last[$2] = $3
+    }
+    END {
+        printf "%-28s %6s %8s %12s %12s %10s  %s\n", "Konfiguration", "Anzahl", "Treffer", "Mittel (s)", "Build (s)", "ccache %", "Hash"
+        for (k in n) {
+            cc = ch[k] + cm[k]
+            printf "%-28s %6d %7.0f%% %12.1f %12s %10s  %s\n", k, n[k], 100 * h[k] / n[k], t[k] / n[k], \
+                mn[k] ? sprintf("%.1f", mt[k] / mn[k]) : "-", cc ? sprintf("%.0f%%", 100 * ch[k] / cc) : "-", last[k]
+        }
+        printf "\nGesamt: %d Läufe, Trefferquote %.0f%%\n", runs, runs ? 100 * hits / runs : 0
+    }' "$STATS_FILE"
+    echo "Belegung: $(du -sh "$CACHE_DIR/builds" 2>/dev/null | cut -f1) in $(ls -d "$CACHE_DIR"/builds/*/ 2>/dev/null | wc -l) Builds"
+    if [ ${#MAKE_CC[@]} -gt 0 ]; then
+        echo "ccache: $(ccache -s 2>/dev/null | grep -iE 'hits:|cache size' | head -2 | tr -s ' ' | tr '\n' ' ')"
+    fi
+}
+
+cmd_prune() {
+    local keep="${1:-5}"
+    ls -dt "$CACHE_DIR"/builds/*/ 2>/dev/null | tail -n +$((keep + 1)) | while read -r dir; do
+        echo "Entferne $dir"
+        rm -rf "$dir" "${dir%/}.lock"
+    done
+}
+
+case "$1" in
+    build)
+        shift
+        cmd_build "$@"
+        ;;
+    hash)
+        mkdir -p "$CACHE_DIR"
+        prepare_srctree
+        staging="$(mktemp -d "$CACHE_DIR/staging.XXXXXX")"
+        cp "$2" "$staging/.config"
+        make -C "$KERNEL_DIR" O="$staging" "${MAKE_CC[@]}" olddefconfig > /dev/null
+        config_hash "$staging/.config"
+        rm -rf "$staging"
+        ;;
+    stats)
+        cmd_stats
+        ;;
+    prune)
+        cmd_prune "$2"
+        ;;
+    *)
+        echo "Verwendung: $0 build <config> [install_dir] [label] | hash <config> | stats | prune [anzahl]"
+        exit 1
+        ;;
+esac
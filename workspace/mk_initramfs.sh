@@ -0,0 +1,53 @@
+#!/bin/bash
+# Erstellt ein minimales Initramfs für den QEMU-Gast (aarch64)
+# Inhalt: statisches busybox, das angegebene Init-Skript als /init und zusätzliche Binaries in /bin
+#
+# Verwendung: ./mk_initramfs.sh <ausgabe.cpio.gz> <init-skript> [binary...]
+#   BUSYBOX=<pfad> statisches aarch64-busybox (sonst Suche an den üblichen Stellen)
+
+set -e
+
+if [ $# -lt 2 ]; then
+    echo "Verwendung: $0 <ausgabe.cpio.gz> <init-skript> [binary...]"
+    exit 1
+fi
+
+OUTPUT="$(realpath -m "$1")"
+INIT_SCRIPT="$2"
+shift 2
+
+WORK_DIR="/home/developer/workspace/kernel_build"
+
+if [ -z "$BUSYBOX" ]; then
+    for candidate in "$WORK_DIR/busybox-aarch64" /usr/aarch64-linux-gnu/bin/busybox /usr/lib/aarch64-linux-gnu/busybox; do
+        if [ -f "$candidate" ]; then
+            BUSYBOX="$candidate"
+            break
+        fi
+    done
+fi
+if [ -z "$BUSYBOX" ] || ! file "$BUSYBOX" 2>/dev/null | grep -q "aarch64.*statically"; then
+    echo "✗ Kein statisches aarch64-busybox gefunden (BUSYBOX=<pfad> setzen)"
+    echo "  z.B. einmalig: apt-get download busybox-static:arm64 && dpkg -x busybox-static_*.deb bb"
+    exit 1
+fi
+
+INITRAMFS_DIR="$(mktemp -d)"
+trap 'rm -rf "$INITRAMFS_DIR"' EXIT
+
+mkdir -p "$INITRAMFS_DIR"/{bin,sbin,proc,sys,dev,tmp}
+cp "$BUSYBOX" "$INITRAMFS_DIR/bin/busybox"
+# Applets als Symlinks anlegen: busybox --install ist auf dem x86-Host nicht ausführbar und
+# kostet im Gast Bootzeit
+for applet in sh mount umount cat echo dmesg poweroff sleep grep tr kill ls mkdir uname sync wc; do
+    ln -s busybox "$INITRAMFS_DIR/bin/$applet"
+done
+for binary in "$@"; do
+    cp "$binary" "$INITRAMFS_DIR/bin/"
+done
+cp "$INIT_SCRIPT" "$INITRAMFS_DIR/init"
+chmod +x "$INITRAMFS_DIR/init"
+
+mkdir -p "$(dirname "$OUTPUT")"
+(cd "$INITRAMFS_DIR" && find . | cpio -o -H newc 2>/dev/null | gzip -1 > "$OUTPUT")
+echo "✓ Initramfs: $OUTPUT ($(du -h "$OUTPUT" | cut -f1))"
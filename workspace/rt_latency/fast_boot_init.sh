@@ -0,0 +1,23 @@
+#!/bin/sh
+# /init für den Schnellstart (start_qemu_rt.sh --fast-boot)
+# Keine Dienste, nur Zeitmarken im Kernel-Log und die erste RT-Aufgabe. Am Ende wird das
+# Kernel-Log (inkl. initcall_debug) auf die Konsole ausgegeben und der Gast ausgeschaltet.
+
+mount -t devtmpfs none /dev
+echo "fastboot: stage init" > /dev/kmsg
+echo "fastboot marker init"
+
+mount -t proc none /proc
+mount -t sysfs none /sys
+echo "fastboot: stage mounts" > /dev/kmsg
+
+# Erste RT-Aufgabe: eine Sekunde Latenzmessung, die erste Aufweckung landet im Kernel-Log
+echo "fastboot: stage rt_start" > /dev/kmsg
+/bin/rt_latency -n first -t 1 -p 95 -i 1000 -D 1 -k
+echo "fastboot: stage rt_done" > /dev/kmsg
+echo "fastboot marker rt_done"
+
+echo "fastboot dmesg begin"
+dmesg
+echo "fastboot dmesg end"
+poweroff -f
@@ -0,0 +1,59 @@
+#!/bin/sh
+# /init im Initramfs der Latenz-Suite (läuft im QEMU-Gast)
+# Parameter kommen über die Kernel-Kommandozeile:
+#   rtbench.duration=<s> rtbench.interval=<us> rtbench.prio=<prio> rtbench.loads=idle,cpu,...
+
+/bin/busybox --install -s
+
+mount -t proc none /proc
+mount -t sysfs none /sys
+mount -t devtmpfs none /dev
+mount -t tmpfs none /tmp
+
+DURATION=30
+INTERVAL=200
+PRIO=95
+LOADS="idle cpu mem io irq all"
+
+for arg in $(cat /proc/cmdline); do
+    case "$arg" in
+        rtbench.duration=*) DURATION="${arg#*=}" ;;
+        rtbench.interval=*) INTERVAL="${arg#*=}" ;;
+        rtbench.prio=*) PRIO="${arg#*=}" ;;
+        rtbench.loads=*) LOADS=$(echo "${arg#*=}" | tr ',' ' ') ;;
+    esac
+done
+
+CPUS=$(grep -c ^processor /proc/cpuinfo)
+# Scratch-Disk für I/O-Last, sonst tmpfs
+IO_TARGET=/tmp/rt_stress.dat
+[ -b /dev/vda ] && IO_TARGET=/dev/vda
+
+echo "rtlat info kernel $(uname -r)"
+echo "rtlat info version $(uname -v)"
+echo "rtlat info realtime $(cat /sys/kernel/realtime 2>/dev/null || echo 0)"
+echo "rtlat info cpus $CPUS"
+echo "rtlat info io_target $IO_TARGET"
+
+# RT-Throttling aus (wie bei cyclictest-Läufen üblich)
+echo -1 > /proc/sys/kernel/sched_rt_runtime_us 2>/dev/null
+
+for load in $LOADS; do
+    echo "rtlat info phase $load"
+    STRESS_PID=""
+    if [ "$load" != "idle" ]; then
+        # Last läuft etwas länger als die Messung, damit sie die ganze Messung abdeckt
+        /bin/rt_stress -m "$load" -d $((DURATION + 2)) -f "$IO_TARGET" &
+        STRESS_PID=$!
+        sleep 1
+    fi
+    /bin/rt_latency -n "$load" -t "$CPUS" -p "$PRIO" -i "$INTERVAL" -D "$DURATION" -H 10000
+    if [ -n "$STRESS_PID" ]; then
+        kill "$STRESS_PID" 2>/dev/null
+        wait "$STRESS_PID" 2>/dev/null
+    fi
+done
+
+echo "rtlat info done"
+sync
+poweroff -f
@@ -0,0 +1,247 @@
+/*
+Latenzmessung im Stil von cyclictest
+
+Pro Thread ein SCHED_FIFO-Thread, der mit clock_nanosleep(TIMER_ABSTIME) periodisch aufwacht
+und die Differenz zwischen Soll- und Ist-Weckzeit in ein Histogramm (1 µs Auflösung) einträgt.
+Am Ende werden Zusammenfassung und Histogramm in einem einfach zu parsenden Format ausgegeben:
+
+  rtlat begin <name>
+  rtlat thread <nr> min <us> avg <us> max <us> samples <n> overflow <n>
+  rtlat hist <us> <anzahl>        (nur belegte Buckets, alle Threads summiert)
+  rtlat end <name>
+
+Aufruf: rt_latency [-n name] [-t threads] [-p prio] [-i intervall_us] [-D sekunden] [-H buckets] [-k]
+  -k  erste RT-Aufweckung ins Kernel-Log schreiben (/dev/kmsg), für die Boot-Zeitmessung
+*/
+
+#define _GNU_SOURCE // CPU_SET, pthread_setaffinity_np
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+#define NSEC_PER_SEC 1000000000LL
+
+struct lat_thread {
+    pthread_t thread;
+    int nr;
+    int cpu;
+    uint64_t *hist;
+    uint64_t samples;
+    uint64_t overflow;
+    int64_t min_ns;
+    int64_t max_ns;
+    int64_t sum_ns;
+};
+
+static int interval_us = 1000;
+static int duration_s = 10;
+static int priority = 95;
+static int buckets = 1000;
+static volatile sig_atomic_t running = 1;
+static int kmsg_fd = -1;
+
+static void handle_signal(int sig) {
+    (void)sig;
+    running = 0;
+}
+
+static int64_t ts_ns(const struct timespec *ts) {
+    return (int64_t)ts->tv_sec * NSEC_PER_SEC + ts->tv_nsec;
+}
+
+static void ts_add_ns(struct timespec *ts, int64_t ns) {
+    ts->tv_nsec += ns;
+    while (ts->tv_nsec >= NSEC_PER_SEC) {
+        ts->tv_nsec -= NSEC_PER_SEC;
+        ts->tv_sec++;
+    }
+}
+
+static void *lat_thread_main(void *arg) {
+    struct lat_thread *t = arg;
+    struct timespec next;
+    struct timespec now;
+
+    if (t->cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(t->cpu, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    int64_t end = ts_ns(&next) + (int64_t)duration_s * NSEC_PER_SEC;
+    ts_add_ns(&next, (int64_t)interval_us * 1000);
+
+    while (running) {
+        if (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL) != 0) {
+            continue; // EINTR: Signal, Schleifenbedingung prüfen
+        }
+        clock_gettime(CLOCK_MONOTONIC, &now);
+
+        int64_t latency = ts_ns(&now) - ts_ns(&next);
+        if (latency < 0) {
+            latency = 0;
+        }
+        int64_t us = latency / 1000;
+        if (us < buckets) {
+            t->hist[us]++;
+        } else {
+            t->overflow++;
+        }
+        if (t->samples == 0 || latency < t->min_ns) {
+            t->min_ns = latency;
+        }
+        if (latency > t->max_ns) {
+            t->max_ns = latency;
+        }
+        t->sum_ns += latency;
+        t->samples++;
+        if (t->samples == 1 && t->nr == 0 && kmsg_fd >= 0) {
+            static const char msg[] = "rt_latency: first RT wakeup\n";
+            ssize_t written = write(kmsg_fd, msg, sizeof(msg) - 1);
+            (void)written;
+        }
+
+        if (ts_ns(&now) >= end) {
+            break;
+        }
+        // Verpasste Perioden überspringen statt nachzuholen
+        do {
+            ts_add_ns(&next, (int64_t)interval_us * 1000);
+        } while (ts_ns(&next) <= ts_ns(&now));
+    }
+    return NULL;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Verwendung: %s [-n name] [-t threads] [-p prio] [-i intervall_us] [-D sekunden] [-H buckets] [-k]\n",
+            prog);
+}
+
+int main(int argc, char *argv[]) {
+    const char *name = "messung";
+    int num_threads = 1;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:t:p:i:D:H:k")) != -1) {
+        switch (opt) {
+        case 'n':
+            name = optarg;
+            break;
+        case 't':
+            num_threads = atoi(optarg);
+            break;
+        case 'p':
+            priority = atoi(optarg);
+            break;
+        case 'i':
+            interval_us = atoi(optarg);
+            break;
+        case 'D':
+            duration_s = atoi(optarg);
+            break;
+        case 'H':
+            buckets = atoi(optarg);
+            break;
+        case 'k':
+            kmsg_fd = open("/dev/kmsg", O_WRONLY);
+            if (kmsg_fd < 0) {
+                perror("/dev/kmsg");
+            }
+            break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (num_threads < 1 || interval_us < 1 || duration_s < 1 || buckets < 1) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    signal(SIGINT, handle_signal);
+    signal(SIGTERM, handle_signal);
+
+    // Seitenfehler während der Messung vermeiden
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        perror("mlockall (Messung läuft ohne)");
+    }
+
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    struct lat_thread *threads = calloc((size_t)num_threads, sizeof(*threads));
+    if (threads == NULL) {
+        perror("calloc");
+        return 1;
+    }
+
+    pthread_attr_t attr;
+    struct sched_param param = {.sched_priority = priority};
+    pthread_attr_init(&attr);
+    pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+    pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+    pthread_attr_setschedparam(&attr, &param);
+
+    for (int i = 0; i < num_threads; ++i) {
+        struct lat_thread *t = &threads[i];
+        t->nr = i;
+        t->cpu = cpus > 1 ? (int)(i % cpus) : -1;
+        t->hist = calloc((size_t)buckets, sizeof(uint64_t));
+        if (t->hist == NULL) {
+            perror("calloc");
+            return 1;
+        }
+        int err = pthread_create(&t->thread, &attr, lat_thread_main, t);
+        if (err == EPERM) {
+            // Ohne RT-Rechte trotzdem messen (Werte dann nur bedingt aussagekräftig)
+            fprintf(stderr, "Keine Berechtigung für SCHED_FIFO, messe mit SCHED_OTHER\n");
+            err = pthread_create(&t->thread, NULL, lat_thread_main, t);
+        }
+        if (err != 0) {
+            fprintf(stderr, "pthread_create: %s\n", strerror(err));
+            return 1;
+        }
+    }
+    pthread_attr_destroy(&attr);
+
+    for (int i = 0; i < num_threads; ++i) {
+        pthread_join(threads[i].thread, NULL);
+    }
+
+    printf("rtlat begin %s\n", name);
+    for (int i = 0; i < num_threads; ++i) {
+        struct lat_thread *t = &threads[i];
+        double avg = t->samples > 0 ? (double)t->sum_ns / (double)t->samples / 1000.0 : 0.0;
+        printf("rtlat thread %d min %lld avg %.1f max %lld samples %llu overflow %llu\n", t->nr,
+               (long long)(t->min_ns / 1000), avg, (long long)(t->max_ns / 1000), (unsigned long long)t->samples,
+               (unsigned long long)t->overflow);
+    }
+    for (int us = 0; us < buckets; ++us) {
+        uint64_t count = 0;
+        for (int i = 0; i < num_threads; ++i) {
+            count += threads[i].hist[us];
+        }
+        if (count > 0) {
+            printf("rtlat hist %d %llu\n", us, (unsigned long long)count);
+        }
+    }
+    printf("rtlat end %s\n", name);
+    fflush(stdout);
+
+    for (int i = 0; i < num_threads; ++i) {
+        free(threads[i].hist);
+    }
+    free(threads);
+    return 0;
+}
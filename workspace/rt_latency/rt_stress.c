@@ -0,0 +1,267 @@
+/*
+Lastgenerator für die Latenzmessung unter Last
+
+Lastarten (mehrfach angebbar, Kommas trennen):
+  cpu  - Rechenschleife pro Worker
+  mem  - Schreiben/Lesen eines großen Puffers mit Cache-unfreundlichem Zugriffsmuster
+  io   - Blockweises Schreiben mit fdatasync (Datei oder Blockgerät, z.B. virtio-Scratch-Disk)
+  irq  - Timer-Interrupts (kurze Schlafintervalle) und Reschedule-IPIs (Pipe-Pingpong über CPUs)
+  all  - alles zusammen
+
+Aufruf: rt_stress -m cpu,mem [-w worker] [-d sekunden] [-f io_pfad]
+*/
+
+#define _GNU_SOURCE // CPU_SET, pthread_setaffinity_np
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MEM_BUFFER_SIZE (64UL * 1024 * 1024)
+#define IO_BLOCK_SIZE (64 * 1024)
+#define IO_FILE_SIZE (64LL * 1024 * 1024)
+
+enum {
+    LOAD_CPU = 1 << 0,
+    LOAD_MEM = 1 << 1,
+    LOAD_IO = 1 << 2,
+    LOAD_IRQ = 1 << 3,
+};
+
+static volatile sig_atomic_t running = 1;
+static const char *io_path = "/tmp/rt_stress.dat";
+static long num_cpus = 1;
+
+static void handle_signal(int sig) {
+    (void)sig;
+    running = 0;
+}
+
+static void pin_to_cpu(int nr) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(nr % num_cpus, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+static void *cpu_worker(void *arg) {
+    pin_to_cpu((int)(intptr_t)arg);
+    volatile double x = 1.0;
+    while (running) {
+        for (int i = 0; i < 100000; ++i) {
+            x = x * 1.0000001 + 0.0000001;
+        }
+    }
+    return NULL;
+}
+
+static void *mem_worker(void *arg) {
+    pin_to_cpu((int)(intptr_t)arg);
+    unsigned char *buffer = malloc(MEM_BUFFER_SIZE);
+    if (buffer == NULL) {
+        perror("mem: malloc");
+        return NULL;
+    }
+    size_t stride = 4096 + 64; // jede Seite, versetzte Cache-Line
+    unsigned char value = 0;
+    while (running) {
+        memset(buffer, value++, MEM_BUFFER_SIZE);
+        for (size_t off = 0; off < MEM_BUFFER_SIZE && running; off += stride) {
+            buffer[off] ^= buffer[(off * 7) % MEM_BUFFER_SIZE];
+        }
+    }
+    free(buffer);
+    return NULL;
+}
+
+static void *io_worker(void *arg) {
+    pin_to_cpu((int)(intptr_t)arg);
+    int fd = open(io_path, O_WRONLY | O_CREAT, 0644);
+    if (fd < 0) {
+        perror("io: open");
+        return NULL;
+    }
+    char *block = malloc(IO_BLOCK_SIZE);
+    if (block == NULL) {
+        close(fd);
+        return NULL;
+    }
+    memset(block, 0x5a, IO_BLOCK_SIZE);
+    // Jeder Worker schreibt in seinen eigenen Bereich
+    off_t base = (off_t)(intptr_t)arg * IO_FILE_SIZE;
+    off_t off = 0;
+    while (running) {
+        if (pwrite(fd, block, IO_BLOCK_SIZE, base + off) != IO_BLOCK_SIZE) {
+            perror("io: pwrite");
+            break;
+        }
+        off = (off + IO_BLOCK_SIZE) % IO_FILE_SIZE;
+        if (off % (1024 * 1024) == 0) {
+            fdatasync(fd);
+        }
+    }
+    free(block);
+    close(fd);
+    return NULL;
+}
+
+// Timer-Interrupts: viele kurze Schlafphasen
+static void *timer_worker(void *arg) {
+    pin_to_cpu((int)(intptr_t)arg);
+    struct timespec pause = {.tv_sec = 0, .tv_nsec = 20000};
+    while (running) {
+        nanosleep(&pause, NULL);
+    }
+    return NULL;
+}
+
+struct pingpong {
+    int to_peer[2];
+    int from_peer[2];
+    int cpu;
+};
+
+// Reschedule-IPIs: zwei Threads auf verschiedenen CPUs wecken sich gegenseitig
+static void *pong_worker(void *arg) {
+    struct pingpong *pp = arg;
+    pin_to_cpu(pp->cpu + 1);
+    char c;
+    while (read(pp->to_peer[0], &c, 1) == 1) {
+        if (write(pp->from_peer[1], &c, 1) != 1) {
+            break;
+        }
+    }
+    return NULL;
+}
+
+static void *ping_worker(void *arg) {
+    struct pingpong *pp = arg;
+    pin_to_cpu(pp->cpu);
+    char c = 'x';
+    while (running) {
+        if (write(pp->to_peer[1], &c, 1) != 1 || read(pp->from_peer[0], &c, 1) != 1) {
+            break;
+        }
+    }
+    close(pp->to_peer[1]); // beendet pong_worker
+    return NULL;
+}
+
+static int parse_loads(const char *arg) {
+    int loads = 0;
+    char *copy = strdup(arg);
+    for (char *tok = strtok(copy, ","); tok != NULL; tok = strtok(NULL, ",")) {
+        if (strcmp(tok, "cpu") == 0) {
+            loads |= LOAD_CPU;
+        } else if (strcmp(tok, "mem") == 0) {
+            loads |= LOAD_MEM;
+        } else if (strcmp(tok, "io") == 0) {
+            loads |= LOAD_IO;
+        } else if (strcmp(tok, "irq") == 0) {
+            loads |= LOAD_IRQ;
+        } else if (strcmp(tok, "all") == 0) {
+            loads |= LOAD_CPU | LOAD_MEM | LOAD_IO | LOAD_IRQ;
+        } else if (strcmp(tok, "none") != 0) {
+            fprintf(stderr, "Unbekannte Lastart: %s\n", tok);
+            loads = -1;
+            break;
+        }
+    }
+    free(copy);
+    return loads;
+}
+
+int main(int argc, char *argv[]) {
+    int loads = LOAD_CPU;
+    int workers = 0;
+    int duration_s = 10;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "m:w:d:f:")) != -1) {
+        switch (opt) {
+        case 'm':
+            loads = parse_loads(optarg);
+            break;
+        case 'w':
+            workers = atoi(optarg);
+            break;
+        case 'd':
+            duration_s = atoi(optarg);
+            break;
+        case 'f':
+            io_path = optarg;
+            break;
+        default:
+            fprintf(stderr, "Verwendung: %s -m cpu,mem,io,irq|all [-w worker] [-d sekunden] [-f io_pfad]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+    if (loads < 0) {
+        return 1;
+    }
+
+    num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (num_cpus < 1) {
+        num_cpus = 1;
+    }
+    if (workers < 1) {
+        workers = (int)num_cpus;
+    }
+
+    signal(SIGINT, handle_signal);
+    signal(SIGTERM, handle_signal);
+    signal(SIGPIPE, SIG_IGN);
+
+    pthread_t threads[256];
+    int count = 0;
+    struct pingpong *pairs = calloc((size_t)workers, sizeof(*pairs));
+
+    for (int i = 0; i < workers && count < 250; ++i) {
+        void *nr = (void *)(intptr_t)i;
+        if (loads & LOAD_CPU) {
+            pthread_create(&threads[count++], NULL, cpu_worker, nr);
+        }
+        if (loads & LOAD_MEM) {
+            pthread_create(&threads[count++], NULL, mem_worker, nr);
+        }
+        if (loads & LOAD_IO) {
+            pthread_create(&threads[count++], NULL, io_worker, nr);
+        }
+        if (loads & LOAD_IRQ) {
+            pthread_create(&threads[count++], NULL, timer_worker, nr);
+            if (pipe(pairs[i].to_peer) == 0 && pipe(pairs[i].from_peer) == 0) {
+                pairs[i].cpu = i;
+                pthread_create(&threads[count++], NULL, ping_worker, &pairs[i]);
+                pthread_create(&threads[count++], NULL, pong_worker, &pairs[i]);
+            }
+        }
+    }
+    printf("rt_stress: %d Threads, Last 0x%x, %d s\n", count, loads, duration_s);
+    fflush(stdout);
+
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    end.tv_sec += duration_s;
+    while (running && clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &end, NULL) != 0) {
+    }
+    running = 0;
+
+    for (int i = 0; i < count; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+    free(pairs);
+    struct stat st;
+    if ((loads & LOAD_IO) && stat(io_path, &st) == 0 && S_ISREG(st.st_mode)) {
+        unlink(io_path);
+    }
+    return 0;
+}
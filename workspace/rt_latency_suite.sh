@@ -0,0 +1,194 @@
+#!/bin/bash
+# Latenz-Suite für PREEMPT_RT-Kernel im QEMU-Gast
+# Bootet jedes Kernel-Image über start_qemu_rt.sh mit einem eigenen Initramfs, misst die
+# Weck-Latenz (cyclictest-Stil) im Leerlauf sowie unter CPU-, Speicher-, I/O- und IRQ-Last
+# und erstellt einen Vergleichsbericht über alle Images.
+#
+# Verwendung: ./rt_latency_suite.sh [Image...]
+#   Ohne Argumente: alle Images aus "BUILD_IMAGES=1 ./test_kernel_configs.sh",
+#   falls keine vorhanden, das installierte Image aus build_rt_kernel.sh.
+#
+# Umgebungsvariablen:
+#   DURATION=30        Messdauer pro Lastphase in Sekunden
+#   INTERVAL=200       Weckintervall in µs
+#   LOADS=idle,cpu,mem,io,irq,all
+#   BUSYBOX=<pfad>     statisches aarch64-busybox (z.B. aus busybox-static:arm64)
+#   RESULTS_DIR=<pfad> Ausgabeverzeichnis
+#   QEMU_ACCEL, QEMU_SMP, QEMU_MEM werden an start_qemu_rt.sh durchgereicht
+#
+# Läuft vollständig offline. Auf x86-Hosts wird der aarch64-Gast per TCG emuliert: die absoluten
+# Werte liegen dann deutlich über echter Hardware, der Vergleich zwischen Konfigurationen und
+# Lastarten bleibt aber aussagekräftig. Auf aarch64-Hosts mit /dev/kvm wird KVM verwendet.
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
+WORK_DIR="/home/developer/workspace/kernel_build"
+IMAGES_DIR="$WORK_DIR/rt_images"
+INSTALLED_IMAGE="$WORK_DIR/install/boot/Image"
+
+DURATION="${DURATION:-30}"
+INTERVAL="${INTERVAL:-200}"
+LOADS="${LOADS:-idle,cpu,mem,io,irq,all}"
+RESULTS_DIR="${RESULTS_DIR:-$SCRIPT_DIR/rt_latency_results/$(date +%Y%m%d_%H%M%S)}"
+BUILD_DIR="$RESULTS_DIR/build"
+
+echo "=== PREEMPT_RT Latenz-Suite unter Last ==="
+echo "Datum: $(date)"
+
+# Schritt 1: Werkzeuge prüfen
+echo ""
+echo "=== Schritt 1: Werkzeuge prüfen ==="
+for tool in qemu-system-aarch64 aarch64-linux-gnu-gcc cpio gzip timeout awk; do
+    if command -v $tool >/dev/null 2>&1; then
+        echo "✓ $tool"
+    else
+        echo "✗ $tool nicht gefunden"
+        exit 1
+    fi
+done
+
+# Zu messende Images
+IMAGES=("$@")
+if [ ${#IMAGES[@]} -eq 0 ]; then
+    for image in "$IMAGES_DIR"/*/Image; do
+        [ -f "$image" ] && IMAGES+=("$image")
+    done
+fi
+if [ ${#IMAGES[@]} -eq 0 ] && [ -f "$INSTALLED_IMAGE" ]; then
+    IMAGES+=("$INSTALLED_IMAGE")
+fi
+if [ ${#IMAGES[@]} -eq 0 ]; then
+    echo "✗ Keine Kernel-Images gefunden"
+    echo "  Erst ./build_rt_kernel.sh oder BUILD_IMAGES=1 ./test_kernel_configs.sh ausführen"
+    exit 1
+fi
+
+# Schritt 2: Mess- und Lastprogramme für den Gast bauen
+echo ""
+echo "=== Schritt 2: Gast-Programme bauen ==="
+make -C "$SCRIPT_DIR/rt_latency" cross
+
+# Schritt 3: Initramfs erstellen
+echo ""
+echo "=== Schritt 3: Initramfs erstellen ==="
+"$SCRIPT_DIR/mk_initramfs.sh" "$BUILD_DIR/initramfs.cpio.gz" "$SCRIPT_DIR/rt_latency/guest_init.sh" \
+    "$SCRIPT_DIR/rt_latency/aarch64/rt_latency" "$SCRIPT_DIR/rt_latency/aarch64/rt_stress"
+
+# Scratch-Disk für die I/O-Last (sparse, wird bei jedem Lauf neu angelegt)
+SCRATCH="$BUILD_DIR/scratch.img"
+
+# Schritt 4: Messläufe
+PHASES=$(echo "$LOADS" | tr ',' ' ' | wc -w)
+# TCG bootet langsam: großzügiger Puffer für Boot und Lastaufbau
+RUN_TIMEOUT=$((PHASES * (DURATION + 10) + 300))
+SUMMARY="$RESULTS_DIR/summary.csv"
+echo "image,phase,samples,min_us,avg_us,p99_us,p999_us,max_us,overflow" > "$SUMMARY"
+
+# Wertet die rtlat-Zeilen eines Konsolenlogs aus: Histogramm je Phase + CSV-Zeile
+parse_console() {
+    local name="$1"
+    local log="$2"
+    local out="$3"
+
+    tr -d '\r' < "$log" | awk -v name="$name" -v out="$out" '
+        $1 != "rtlat" { next }
+        $2 == "begin" {
+            phase = $3; nb = 0; total = 0; weighted = 0; ovf = 0; maxv = 0; minv = -1
+            hist_file = out "/" phase ".hist"
+            printf "" > hist_file
+            next
+        }
+        $2 == "thread" {
+            total += $11; weighted += $7 * $11; ovf += $13
+            if ($9 > maxv) maxv = $9
+            if (minv < 0 || $5 < minv) minv = $5
+            next
+        }
+        $2 == "hist" {
+            nb++; bucket[nb] = $3; count[nb] = $4
+            print $3, $4 > hist_file
+            next
+        }
+        $2 == "end" {
+            close(hist_file)
+            p99 = maxv; p999 = maxv; cum = 0; got99 = 0
+            for (i = 1; i <= nb; i++) {
+                cum += count[i]
+                if (!got99 && cum >= total * 0.99) { p99 = bucket[i]; got99 = 1 }
+                if (cum >= total * 0.999) { p999 = bucket[i]; break }
+            }
+            avg = total > 0 ? weighted / total : 0
+            printf "%s,%s,%d,%d,%.1f,%d,%d,%d,%d\n", name, phase, total, minv, avg, p99, p999, maxv, ovf
+        }'
+}
+
+for image in "${IMAGES[@]}"; do
+    name=$(basename "$(dirname "$image")")
+    [ "$image" = "$INSTALLED_IMAGE" ] && name="installed"
+    out="$RESULTS_DIR/$name"
+    mkdir -p "$out"
+
+    echo ""
+    echo "=== Schritt 4: Messung $name ==="
+    echo "Image: $image"
+    echo "Phasen: $LOADS, je $DURATION s, Intervall $INTERVAL µs (Timeout $RUN_TIMEOUT s)"
+
+    rm -f "$SCRATCH"
+    truncate -s 1G "$SCRATCH"
+
+    KERNEL_IMAGE="$image" \
+    QEMU_INITRD="$BUILD_DIR/initramfs.cpio.gz" \
+    QEMU_SCRATCH="$SCRATCH" \
+    QEMU_APPEND="loglevel=3 rtbench.duration=$DURATION rtbench.interval=$INTERVAL rtbench.loads=$LOADS" \
+        timeout "$RUN_TIMEOUT" "$SCRIPT_DIR/start_qemu_rt.sh" < /dev/null > "$out/console.log" 2>&1 || true
+
+    if ! grep -q "rtlat info done" "$out/console.log"; then
+        echo "✗ Lauf unvollständig (Timeout oder Kernel-Panic), siehe $out/console.log"
+    fi
+    if [ -f "$(dirname "$image")/config" ]; then
+        grep -E "^CONFIG_PREEMPT(_RT|_VOLUNTARY)?=y|^CONFIG_HZ=" "$(dirname "$image")/config" > "$out/preempt.txt" || true
+    fi
+    grep "rtlat info" "$out/console.log" | tr -d '\r' | sed 's/^rtlat info /  /' | grep -v phase || true
+    parse_console "$name" "$out/console.log" "$out" | tee -a "$SUMMARY"
+done
+rm -f "$SCRATCH"
+
+# Schritt 5: Vergleichsbericht
+REPORT="$RESULTS_DIR/report.txt"
+{
+    echo "=== PREEMPT_RT Latenzvergleich unter Last ==="
+    echo "Datum: $(date)"
+    echo "Beschleunigung: ${QEMU_ACCEL:-automatisch (tcg auf x86)}, Dauer $DURATION s/Phase, Intervall $INTERVAL µs"
+    echo "Alle Werte in µs; p99.9 und max sind für RT entscheidend."
+    for phase in $(echo "$LOADS" | tr ',' ' '); do
+        echo ""
+        echo "--- Last: $phase ---"
+        printf "%-28s %10s %8s %8s %8s %8s %8s\n" "Image" "Samples" "Min" "Avg" "p99" "p99.9" "Max"
+        awk -F, -v phase="$phase" 'NR > 1 && $2 == phase' "$SUMMARY" | sort -t, -k8,8n | \
+            awk -F, '{ printf "%-28s %10d %8d %8.1f %8d %8d %8d%s\n", $1, $3, $4, $5, $6, $7, $8, NR == 1 ? "  ← bestes Max" : "" }'
+    done
+} > "$REPORT"
+
+echo ""
+cat "$REPORT"
+
+# Optional: Histogramme als Grafik
+if command -v gnuplot >/dev/null 2>&1; then
+    for phase in $(echo "$LOADS" | tr ',' ' '); do
+        plot_cmd=""
+        for hist in "$RESULTS_DIR"/*/"$phase".hist; do
+            [ -s "$hist" ] || continue
+            label=$(basename "$(dirname "$hist")")
+            plot_cmd="$plot_cmd${plot_cmd:+, }'$hist' using 1:2 with steps title '$label'"
+        done
+        [ -n "$plot_cmd" ] || continue
+        gnuplot -e "set terminal png size 1000,600; set output '$RESULTS_DIR/hist_$phase.png'; \
+            set logscale y; set xlabel 'Latenz (µs)'; set ylabel 'Anzahl'; set title 'Last: $phase'; \
+            plot $plot_cmd"
+    done
+    echo "Histogramme: $RESULTS_DIR/hist_*.png"
+fi
+
+echo ""
+echo "Ergebnisse: $RESULTS_DIR"
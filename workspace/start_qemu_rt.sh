@@ -4,10 +4,35 @@
 
 set -e
 
+SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
+
+# Schnellstart (--fast-boot oder FAST_BOOT=1): minimales Initramfs mit busybox und den
+# Benchmark-Binaries, quiet-Boot ohne Netzwerk, Boot-Zeitaufschlüsselung per boot_time_report.sh
+FAST_BOOT="${FAST_BOOT:-0}"
+if [ "$1" = "--fast-boot" ]; then
+    FAST_BOOT=1
+fi
+
 KERNEL_BUILD_DIR="/home/developer/workspace/kernel_build"
 INSTALL_DIR="$KERNEL_BUILD_DIR/install"
-KERNEL_IMAGE="$INSTALL_DIR/boot/Image"
-ROOTFS_IMAGE="/home/developer/workspace/images/raspios-lite.img"
+KERNEL_IMAGE="${KERNEL_IMAGE:-$INSTALL_DIR/boot/Image}"
+ROOTFS_IMAGE="${ROOTFS_IMAGE:-/home/developer/workspace/images/raspios-lite.img}"
+
+# Überschreibbar für automatisierte Läufe (z.B. rt_latency_suite.sh):
+#   QEMU_INITRD   - eigenes Initramfs statt Rootfs/Minimal-Initramfs
+#   QEMU_APPEND   - zusätzliche Kernel-Parameter
+#   QEMU_SCRATCH  - Raw-Image als zusätzliche virtio-Disk (z.B. für I/O-Last)
+#   QEMU_SMP, QEMU_MEM
+#   QEMU_ACCEL    - tcg (Standard auf x86-Hosts) oder kvm (nur auf aarch64-Hosts mit /dev/kvm)
+QEMU_SMP="${QEMU_SMP:-4}"
+QEMU_MEM="${QEMU_MEM:-2048}"
+if [ -z "$QEMU_ACCEL" ]; then
+    if [ "$(uname -m)" = "aarch64" ] && [ -w /dev/kvm ]; then
+        QEMU_ACCEL=kvm
+    else
+        QEMU_ACCEL=tcg
+    fi
+fi
 
 # Überprüfe ob Kernel vorhanden ist
 if [ ! -f "$KERNEL_IMAGE" ]; then
@@ -20,27 +45,71 @@ echo "=== Starte QEMU mit RT-Kernel ==="
 echo "Kernel: $KERNEL_IMAGE"
 echo "Rootfs: $ROOTFS_IMAGE"
 
-cd /home/dev/data
+if [ -d /home/dev/data ]; then
+    cd /home/dev/data
+fi
 
 # QEMU Audio-Umgebung konfigurieren
 export QEMU_AUDIO_DRV=none
 
+# CPU-Modell: unter KVM die Host-CPU, unter TCG ein Cortex-A72 (ähnlich Pi 5)
+if [ "$QEMU_ACCEL" = "kvm" ]; then
+    QEMU_CPU=host
+else
+    QEMU_CPU=cortex-a72
+fi
+
+CONSOLE_APPEND="console=ttyAMA0,115200 earlycon=pl011,0x9000000 loglevel=7 preempt=rt"
+
+if [ "$FAST_BOOT" = "1" ]; then
+    echo "=== Schnellstart: minimales Initramfs ==="
+    FAST_DIR="${FAST_BOOT_DIR:-$KERNEL_BUILD_DIR/fast_boot}"
+    make -C "$SCRIPT_DIR/rt_latency" cross > /dev/null
+    "$SCRIPT_DIR/mk_initramfs.sh" "$FAST_DIR/initramfs.cpio.gz" "$SCRIPT_DIR/rt_latency/fast_boot_init.sh" \
+        "$SCRIPT_DIR/rt_latency/aarch64/rt_latency"
+    QEMU_INITRD="$FAST_DIR/initramfs.cpio.gz"
+    # Serielle Ausgabe ist unter TCG teuer: quiet und ohne earlycon booten. Die initcall_debug-
+    # Meldungen landen trotzdem im Log-Puffer, den das Init-Skript am Ende ausgibt.
+    CONSOLE_APPEND="console=ttyAMA0,115200 preempt=rt"
+    QEMU_APPEND="quiet initcall_debug log_buf_len=4M printk.devkmsg=on acpi=off audit=0 nowatchdog $QEMU_APPEND"
+fi
+if [ -n "$QEMU_INITRD" ]; then
+    KERNEL_APPEND="panic=1 $CONSOLE_APPEND $QEMU_APPEND"
+else
+    KERNEL_APPEND="root=/dev/vda2 panic=1 rootfstype=ext4 rw $CONSOLE_APPEND $QEMU_APPEND"
+fi
+
 # Parameter für QEMU
 QEMU_ARGS=(
     -M virt                                     # ARM64 Virt-Machine (beste Pi 5 Alternative)
-    -cpu cortex-a72                            # ARM Cortex-A72 (ähnlich Pi 5)
-    -smp 4                                     # 4 CPU-Kerne
-    -m 2048                                    # 2GB RAM
+    -accel "$QEMU_ACCEL"                       # tcg oder kvm
+    -cpu "$QEMU_CPU"
+    -smp "$QEMU_SMP"                           # CPU-Kerne (Standard 4)
+    -m "$QEMU_MEM"                             # RAM in MB (Standard 2GB)
     -kernel "$KERNEL_IMAGE"                    # Unser RT-Kernel
-    -append "root=/dev/vda2 panic=1 rootfstype=ext4 rw console=ttyAMA0,115200 earlycon=pl011,0x9000000 loglevel=7 preempt=rt"
-    -netdev user,id=net0,hostfwd=tcp::2222-:22 # SSH-Weiterleitung
-    -device e1000 netdev=net0                  # Netzwerk-Device
+    -append "$KERNEL_APPEND"
     -nographic                                 # Keine grafische Ausgabe
     -serial mon:stdio                          # Serieller Monitor
 )
 
-# Wenn Rootfs-Image vorhanden, verwende es
-if [ -f "$ROOTFS_IMAGE" ]; then
+if [ "$FAST_BOOT" = "1" ]; then
+    # Kein Netzwerk: spart das Proben des Netzwerk-Devices
+    QEMU_ARGS+=(-nic none)
+else
+    QEMU_ARGS+=(
+        -netdev user,id=net0,hostfwd=tcp::2222-:22 # SSH-Weiterleitung
+        -device e1000,netdev=net0                  # Netzwerk-Device
+    )
+fi
+
+if [ -n "$QEMU_SCRATCH" ]; then
+    QEMU_ARGS+=(-drive "file=$QEMU_SCRATCH,format=raw,if=virtio,cache=none")
+fi
+
+if [ -n "$QEMU_INITRD" ]; then
+    # Automatisierter Lauf: Initramfs vom Aufrufer, kein Rootfs
+    QEMU_ARGS+=(-initrd "$QEMU_INITRD" -no-reboot)
+elif [ -f "$ROOTFS_IMAGE" ]; then
     QEMU_ARGS+=(-drive "file=$ROOTFS_IMAGE,format=raw,if=virtio")
 else
     echo "Warnung: Rootfs-Image nicht gefunden: $ROOTFS_IMAGE"
@@ -90,6 +159,21 @@ fi
 echo "=== QEMU-Kommando ==="
 echo "qemu-system-aarch64 ${QEMU_ARGS[*]}"
 echo ""
+
+if [ "$FAST_BOOT" = "1" ]; then
+    # Jede Konsolenzeile mit Host-Zeitstempel versehen ($EPOCHREALTIME, ohne fork)
+    LOG="$FAST_DIR/boot_$(date +%Y%m%d_%H%M%S).log"
+    echo "Starte QEMU (Schnellstart), Log: $LOG"
+    {
+        echo "$EPOCHREALTIME fastboot host qemu_start"
+        qemu-system-aarch64 "${QEMU_ARGS[@]}" < /dev/null 2>&1 | while IFS= read -r line; do
+            printf '%s %s\n' "$EPOCHREALTIME" "$line"
+        done
+    } > "$LOG"
+    "$SCRIPT_DIR/boot_time_report.sh" "$LOG" "$FAST_DIR/boot_times.csv"
+    exit 0
+fi
+
 echo "=== Hilfe ==="
 echo "- Zum Beenden: Ctrl+A, dann X"
 echo "- Zum Monitor: Ctrl+A, dann C"
@@ -8,6 +8,20 @@ KERNEL_VERSION="6.15.6"
 WORK_DIR="/home/developer/workspace/kernel_build"
 KERNEL_DIR="$WORK_DIR/linux-$KERNEL_VERSION"
 
+# Optional: für jede funktionierende Konfiguration ein Image bauen, das
+# rt_latency_suite.sh anschließend unter Last vermisst.
+#   BUILD_IMAGES=1              - Images bauen
+#   IMAGE_VARIANTS="rt preempt" - Preemption-Modelle je Konfiguration (Standard: rt)
+#   PARALLEL_BUILDS=2           - gleichzeitige Builds, die CPUs werden aufgeteilt
+# Jede Konfiguration wird in einem eigenen O=-Verzeichnis erzeugt und über den Build-Cache
+# (kernel_build_cache.sh) gebaut; bereits gebaute Konfigurationen kosten nur das Kopieren.
+BUILD_IMAGES="${BUILD_IMAGES:-0}"
+IMAGE_VARIANTS="${IMAGE_VARIANTS:-rt}"
+PARALLEL_BUILDS="${PARALLEL_BUILDS:-2}"
+IMAGES_DIR="$WORK_DIR/rt_images"
+STAGE_DIR="$WORK_DIR/config_test"
+SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
+
 echo "=== Kernel-Konfigurationstester für RT-Performance ==="
 
 if [ ! -d "$KERNEL_DIR" ]; then
@@ -20,24 +34,33 @@ cd "$KERNEL_DIR"
 export ARCH=arm64
 export CROSS_COMPILE=aarch64-linux-gnu-
 
+# O=-Builds verlangen einen sauberen Quellbaum; eine alte In-Tree-Konfiguration sichern
+if [ -f .config ]; then
+    [ -f "$WORK_DIR/rt.config" ] || cp .config "$WORK_DIR/rt.config"
+    make mrproper > /dev/null
+fi
+mkdir -p "$STAGE_DIR"
+
 echo "Teste verschiedene Basis-Konfigurationen..."
 
 # Teste verschiedene defconfigs
 test_defconfig() {
     local config_name="$1"
     local description="$2"
+    local stage="$STAGE_DIR/$config_name"
     
     echo ""
     echo "=== Teste $config_name ==="
     echo "Beschreibung: $description"
     
-    if make $config_name > /dev/null 2>&1; then
+    rm -rf "$stage"
+    if make O="$stage" $config_name > /dev/null 2>&1; then
         echo "  ✓ $config_name erfolgreich geladen"
         
         # Teste RT-Optionen
-        if scripts/config --enable CONFIG_PREEMPT_RT 2>/dev/null; then
-            make olddefconfig > /dev/null 2>&1
-            if grep -q "CONFIG_PREEMPT_RT=y" .config; then
+        if scripts/config --file "$stage/.config" --enable CONFIG_PREEMPT_RT 2>/dev/null; then
+            make O="$stage" olddefconfig > /dev/null 2>&1
+            if grep -q "CONFIG_PREEMPT_RT=y" "$stage/.config"; then
                 echo "  ✓ CONFIG_PREEMPT_RT verfügbar und aktiviert"
                 return 0
             else
@@ -54,6 +77,51 @@ test_defconfig() {
     fi
 }
 
+# Baut ein Image der Konfiguration im gewünschten Preemption-Modell. Jeder Aufruf hat ein
+# eigenes Konfigurationsverzeichnis und kann daher parallel zu anderen laufen.
+build_image() {
+    local config_name="$1"
+    local variant="$2"
+    local label="$config_name-$variant"
+    local target_dir="$IMAGES_DIR/$label"
+    local stage="$STAGE_DIR/$label"
+    local kconfig=(scripts/config --file "$stage/.config")
+
+    echo "  → Baue Image $label..."
+    rm -rf "$stage"
+    make O="$stage" $config_name > /dev/null 2>&1
+    case "$variant" in
+        rt)
+            "${kconfig[@]}" --enable CONFIG_PREEMPT_RT
+            ;;
+        preempt)
+            "${kconfig[@]}" --disable CONFIG_PREEMPT_RT
+            "${kconfig[@]}" --enable CONFIG_PREEMPT
+            ;;
+        voluntary)
+            "${kconfig[@]}" --disable CONFIG_PREEMPT_RT
+            "${kconfig[@]}" --disable CONFIG_PREEMPT
+            "${kconfig[@]}" --enable CONFIG_PREEMPT_VOLUNTARY
+            ;;
+    esac
+    # Für die Latenz-Suite: Initramfs, virtio-Disk und PL011-Konsole fest einbauen
+    "${kconfig[@]}" --enable CONFIG_BLK_DEV_INITRD
+    "${kconfig[@]}" --enable CONFIG_VIRTIO_BLK
+    "${kconfig[@]}" --enable CONFIG_SERIAL_AMBA_PL011
+    "${kconfig[@]}" --enable CONFIG_SERIAL_AMBA_PL011_CONSOLE
+    "${kconfig[@]}" --enable CONFIG_HIGH_RES_TIMERS
+    make O="$stage" olddefconfig > /dev/null 2>&1
+
+    if "$SCRIPT_DIR/kernel_build_cache.sh" build "$stage/.config" "$target_dir" "$label" \
+        > "$WORK_DIR/build_$label.log" 2>&1; then
+        ln -sf boot/Image "$target_dir/Image"
+        ln -sf boot/config "$target_dir/config"
+        echo "  ✓ Image: $target_dir/Image ($(grep -o 'Gebaut in .*\|In [0-9]* s wiederhergestellt' "$WORK_DIR/build_$label.log"))"
+    else
+        echo "  ✗ Build fehlgeschlagen, siehe $WORK_DIR/build_$label.log"
+    fi
+}
+
 # Teste verschiedene Konfigurationen
 configs_to_test=(
     "defconfig:Standard ARM64 Konfiguration"
@@ -62,6 +130,7 @@ configs_to_test=(
 )
 
 best_config=""
+build_queue=()
 for config_entry in "${configs_to_test[@]}"; do
     config_name="${config_entry%:*}"
     description="${config_entry#*:}"
@@ -70,9 +139,35 @@ for config_entry in "${configs_to_test[@]}"; do
         if [ -z "$best_config" ]; then
             best_config="$config_name"
         fi
+        if [ "$BUILD_IMAGES" = "1" ]; then
+            for variant in $IMAGE_VARIANTS; do
+                build_queue+=("$config_name:$variant")
+            done
+        fi
     fi
 done
 
+if [ "$BUILD_IMAGES" = "1" ] && [ ${#build_queue[@]} -gt 0 ]; then
+    echo ""
+    echo "=== Baue ${#build_queue[@]} Images, $PARALLEL_BUILDS parallel ==="
+    # CPUs auf die gleichzeitigen Builds aufteilen
+    export JOBS=$(( $(nproc) / PARALLEL_BUILDS ))
+    [ "$JOBS" -ge 1 ] || JOBS=1
+    for entry in "${build_queue[@]}"; do
+        while [ "$(jobs -rp | wc -l)" -ge "$PARALLEL_BUILDS" ]; do
+            wait -n || true
+        done
+        build_image "${entry%:*}" "${entry#*:}" &
+    done
+    wait
+
+    echo ""
+    "$SCRIPT_DIR/kernel_build_cache.sh" stats
+    echo ""
+    echo "Images für den Latenzvergleich: $IMAGES_DIR"
+    echo "  ./rt_latency_suite.sh $IMAGES_DIR/*/Image"
+fi
+
 echo ""
 echo "=== Ergebnis ==="
 if [ -n "$best_config" ]; then
@@ -83,11 +178,12 @@ if [ -n "$best_config" ]; then
     # Backup des ursprünglichen Skripts
     cp /home/developer/workspace/build_rt_kernel.sh /home/developer/workspace/build_rt_kernel.sh.backup
     
-    # Aktualisiere das Build-Skript
-    sed -i "s/make defconfig/make $best_config/" /home/developer/workspace/build_rt_kernel.sh
+    # Aktualisiere das Build-Skript (greift, sobald rt.config neu erzeugt wird)
+    sed -i "s/^BASE_DEFCONFIG=.*/BASE_DEFCONFIG=\"$best_config\"/" /home/developer/workspace/build_rt_kernel.sh
     
     echo "✓ Build-Skript aktualisiert für optimale RT-Konfiguration"
     echo "✓ Backup erstellt: build_rt_kernel.sh.backup"
+    [ -f "$WORK_DIR/rt.config" ] && echo "  Hinweis: $WORK_DIR/rt.config löschen, um neu zu konfigurieren"
 else
     echo "❌ Keine Konfiguration mit RT-Unterstützung gefunden"
     echo ""
@@ -100,11 +196,13 @@ fi
 echo ""
 echo "=== Manuelle Konfiguration ==="
 echo "Für erweiterte Konfiguration:"
-echo "  cd $KERNEL_DIR"
+echo "  cd $SCRIPT_DIR"
 echo "  make menuconfig"
 echo "  # Navigiere zu: General setup → Preemption Model"
 
 echo ""
 echo "=== Aktuelle Konfiguration ==="
 echo "Aktuelle Preemption-Einstellungen:"
-grep "CONFIG_PREEMPT" .config | grep "=y" | head -5
+if [ -n "$best_config" ]; then
+    grep "CONFIG_PREEMPT" "$STAGE_DIR/$best_config/.config" | grep "=y" | head -5
+fi
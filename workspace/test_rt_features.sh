@@ -147,6 +147,7 @@ echo "Für detaillierte RT-Performance-Tests verwenden Sie:"
 echo "- cyclictest -t1 -p 80 -n -i 10000 -l 10000"
 echo "- hwlatdetect --duration=30"
 echo "- rteval --duration=300"
+echo "- ./rt_latency_suite.sh (Latenz unter Last im QEMU-Gast, Vergleich mehrerer Kernel-Konfigurationen)"
 echo ""
 echo "Für Live-Monitoring:"
 echo "- watch -n 1 'cat /proc/interrupts'"